@@ -0,0 +1,350 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILArchivePack.h
+	\brief Loading images that were converted ahead of time
+*/
+
+#ifndef _TILARCHIVEPACK_H_
+#define _TILARCHIVEPACK_H_
+
+#include "TILSettings.h"
+#include "TILImage.h"
+#include "TILFileStreamMapped.h"
+
+#include <stdio.h>
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	class ArchivePack;
+
+	//! An image stored in a pack
+	/*!
+		Created by ArchivePack::Load. The pixels aren't copied, #GetPixels points
+		straight into the pack. The image has to be released before the pack
+		is closed, unless the image owns the pack, like images returned by CacheDisk.
+	*/
+	class ImagePack : public Image
+	{
+
+		friend class ArchivePack;
+		friend class CacheDisk;
+		friend class CacheShared;
+
+	public:
+
+		ImagePack();
+		~ImagePack();
+
+		//! Does nothing, the pixels are already in the pack
+		bool Parse(uint32 a_Options);
+
+		uint32 GetFrameCount();
+		float GetDelay();
+
+		byte* GetPixels(uint32 a_Frame = 0);
+
+		uint32 GetWidth(uint32 a_Frame = 0);
+		uint32 GetHeight(uint32 a_Frame = 0);
+
+		uint32 GetPitchX(uint32 a_Frame = 0);
+		uint32 GetPitchY(uint32 a_Frame = 0);
+
+		//! Get the amount of slices of a frame
+		/*!
+			\return The depth of a volume texture, otherwise 1
+		*/
+		uint32 GetDepth(uint32 a_Frame = 0);
+		//! Get the distance in bytes between two slices of a frame
+		uint32 GetSlicePitch(uint32 a_Frame = 0);
+		//! Get the size of the pixel data of a frame in bytes
+		uint32 GetDataSize(uint32 a_Frame = 0);
+
+		//! Get the FourCC code of a DDS image stored with #TIL_DEPTH_NATIVE
+		/*!
+			\return The FourCC code, or 0 if the data is uncompressed or 
+			wasn't stored with #TIL_DEPTH_NATIVE
+
+			See ImageDDS::GetFourCC.
+		*/
+		uint32 GetFourCC();
+		//! Get the size of a block of a DDS image stored with #TIL_DEPTH_NATIVE
+		/*!
+			See ImageDDS::GetBlockSize.
+		*/
+		uint32 GetBlockSize();
+
+	private:
+
+		byte* m_Data;
+		byte* m_Frames;
+		uint32 m_FrameTotal;
+		uint32 m_FourCC;
+		uint32 m_BlockSize;
+		float m_Delay;
+
+		ArchivePack* m_Owner;
+
+	}; // class ImagePack
+
+	//! A pack of images that were converted ahead of time
+	/*!
+		A pack holds images that were loaded once by PackBuilder and stored 
+		with the color depth and pitch they were loaded with. Compressed DDS 
+		images can be stored with #TIL_DEPTH_NATIVE to keep their blocks.
+
+		The pack is mapped into memory when it's opened and nothing is decoded
+		when an image is loaded: the pixels of an ImagePack point into the
+		mapping, so only the pages of the images that are used are read 
+		from disk. The index is sorted by the hash of the name, so finding an 
+		image doesn't depend on the number of images in the pack.
+
+		Loading images doesn't change the pack, so it can be done from 
+		multiple threads at once.
+
+		\code
+		til::ArchivePack* pack = new til::ArchivePack();
+		pack->Open("media\\textures.tilpack", TIL_FILE_ADDWORKINGDIR);
+
+		til::Image* load = pack->Load("wood/planks.png");
+		UploadTexture(load->GetPixels(), load->GetPitchX(), load->GetPitchY());
+		til::TIL_Release(load);
+
+		delete pack;
+		\endcode
+	*/
+	class ArchivePack
+	{
+
+	public:
+
+		ArchivePack();
+		~ArchivePack();
+
+		//! Open a pack
+		/*!
+			\param a_Path The path to the pack
+			\param a_Options A file option, see #TIL_FILE_MASK
+
+			\return True on success, false on failure
+
+			The pack is opened with FileStreamMapped.
+		*/
+		bool Open(const char* a_Path, uint32 a_Options);
+
+		//! Open a pack that is already in memory
+		/*!
+			\param a_Data The contents of the pack
+			\param a_Size The size of the pack in bytes
+
+			\return True on success, false on failure
+
+			The memory isn't copied, so it has to stay valid until the pack is closed.
+			The start of the memory has to be aligned to at least 16 bytes.
+		*/
+		bool Open(byte* a_Data, uint32 a_Size);
+
+		//! Close the pack
+		/*!
+			\note Images loaded from the pack point into it, so they have to be 
+			released first.
+		*/
+		void Close();
+
+		//! Load an image from the pack
+		/*!
+			\param a_Name The name the image was stored under
+
+			\return The image, or NULL if the pack doesn't contain it
+
+			Backslashes in the name are treated as forward slashes. Release the
+			image with #TIL_Release.
+		*/
+		ImagePack* Load(const char* a_Name);
+
+		//! Load an image by its index
+		ImagePack* Load(uint32 a_Index);
+
+		//! The number of images in the pack
+		uint32 GetImageCount();
+		//! The name of an image in the pack
+		const char* GetImageName(uint32 a_Index);
+
+	private:
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		uint32 Find(const char* a_Name);
+
+		//@}
+
+		FileStreamMapped* m_Stream;
+		byte* m_Data;
+		uint32 m_Size;
+
+		byte* m_Images;
+		uint32 m_ImageTotal;
+		byte* m_Frames;
+		uint32 m_FrameTotal;
+		char* m_Names;
+		uint32 m_NamesSize;
+
+	}; // class ArchivePack
+
+	//! Creates packs that can be opened with ArchivePack
+	/*!
+		Every image added to the builder is written to the pack right away, 
+		converted to the color depth and pitch it was loaded with, so it can be 
+		released afterwards. The index is written when the builder is closed.
+
+		\code
+		til::PackBuilder* builder = new til::PackBuilder();
+		builder->Open("media\\textures.tilpack", TIL_FILE_ADDWORKINGDIR);
+
+		builder->AddFile("wood/planks.png", TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
+		builder->AddFile("sky.dds", TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_NATIVE);
+
+		builder->Close();
+		delete builder;
+		\endcode
+	*/
+	class PackBuilder
+	{
+
+	public:
+
+		PackBuilder();
+		~PackBuilder();
+
+		//! Create a pack
+		/*!
+			\param a_Path The path to the pack
+			\param a_Options A file option, see #TIL_FILE_MASK
+
+			\return True on success, false on failure
+
+			An existing file is overwritten.
+		*/
+		bool Open(const char* a_Path, uint32 a_Options);
+
+		//! Add an image to the pack
+		/*!
+			\param a_Name The name to store the image under
+			\param a_Image A loaded image
+
+			\return True on success, false on failure
+
+			All frames of the image are stored. DDS images are recognized by the 
+			extension of the name, so their mipmaps, faces and native blocks are 
+			stored as well. 
+		*/
+		bool AddImage(const char* a_Name, Image* a_Image);
+
+		//! Load an image and add it to the pack
+		/*!
+			\param a_Path The path to the image, also used as its name in the pack
+			\param a_Options The options to pass to #TIL_Load
+
+			\return True on success, false on failure
+		*/
+		bool AddFile(const char* a_Path, uint32 a_Options);
+
+		//! Write the index and close the pack
+		/*!
+			\return True on success, false on failure
+
+			Fails if two images were stored under the same name.
+		*/
+		bool Close();
+
+	private:
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+		struct EntryPack
+		{
+			uint32 hash;
+			uint32 name;
+			uint32 length;
+			uint32 frame;
+			uint32 frame_count;
+			uint32 depth;
+			uint32 bpp;
+			uint32 fourcc;
+			uint32 block;
+			uint32 delay;
+			const char* text;
+		};
+
+		struct FramePack
+		{
+			uint32 width, height;
+			uint32 pitchx, pitchy;
+			uint32 depth;
+			uint32 slice;
+			uint32 size;
+			uint32 offset;
+		};
+
+#endif
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		bool Write(const void* a_Src, uint32 a_Size);
+		bool Align();
+		static int CompareEntries(const void* a_Left, const void* a_Right);
+
+		//@}
+
+		FILE* m_Handle;
+		uint32 m_Position;
+		bool m_Failed;
+
+		EntryPack* m_Entries;
+		uint32 m_EntryTotal, m_EntryMax;
+		FramePack* m_Frames;
+		uint32 m_FrameTotal, m_FrameMax;
+		char* m_Names;
+		uint32 m_NamesSize, m_NamesMax;
+
+	}; // class PackBuilder
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILArchiveZip.h
+	\brief Loading images from ZIP archives
+*/
+
+#ifndef _TILARCHIVEZIP_H_
+#define _TILARCHIVEZIP_H_
+
+#include "TILSettings.h"
+#include "TILFileStream.h"
+#include "TILThreads.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! A ZIP archive that images can be loaded from
+	/*!
+		The central directory is read once when the archive is opened and stored
+		in a hash table, so finding a file takes the same time no matter how many
+		files the archive holds.
+
+		Files stored without compression are read straight from the archive.
+		Deflated files are inflated in one go when they are opened, with the 
+		decoder of the PNG loader. Other compression methods, encrypted files and 
+		ZIP64 archives are not supported.
+
+		Any number of streams can read from the same archive, also from different
+		threads. Reads from the archive itself are serialized with a lock. The 
+		streams have to be closed before the archive is.
+
+		\code
+		til::ArchiveZip* archive = new til::ArchiveZip();
+		archive->Open("media\\textures.zip", TIL_FILE_ADDWORKINGDIR);
+
+		til::Image* load = til::TIL_Load(archive->OpenFile("wood/planks.png"), TIL_DEPTH_A8B8G8R8);
+
+		delete archive;
+		\endcode
+	*/
+	class ArchiveZip
+	{
+
+		friend class FileStreamZip;
+
+	public:
+
+		ArchiveZip();
+		~ArchiveZip();
+
+		//! Open an archive
+		/*!
+			\param a_Path The path to the archive
+			\param a_Options A file option, see #TIL_FILE_MASK
+
+			\return True on success, false on failure
+
+			The archive is opened with the function set by #TIL_SetFileStreamFunc.
+		*/
+		bool Open(const char* a_Path, uint32 a_Options);
+
+		//! Open an archive from a stream
+		/*!
+			\param a_Stream An open stream
+
+			\return True on success, false on failure
+
+			The stream has to know its size, see FileStream::GetSize. It's closed 
+			when the archive is closed, and deleted unless it's reusable.
+		*/
+		bool Open(FileStream* a_Stream);
+
+		//! Close the archive
+		void Close();
+
+		//! Open a file in the archive
+		/*!
+			\param a_Name The path of the file in the archive
+
+			\return A stream to pass to #TIL_Load, or NULL if the file can't be opened
+
+			Backslashes in the name are treated as forward slashes. The stream 
+			isn't reusable, so #TIL_Load deletes it after loading.
+		*/
+		FileStream* OpenFile(const char* a_Name);
+
+		//! The number of files in the archive, not counting directories
+		uint32 GetFileCount();
+		//! The path of a file in the archive
+		const char* GetFileName(uint32 a_Index);
+
+	private:
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+		struct EntryZip
+		{
+			uint32 name;
+			uint32 hash;
+			uint32 method;
+			uint32 flags;
+			uint32 size_compressed;
+			uint32 size;
+			uint32 offset;
+		};
+
+#endif
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		EntryZip* Find(const char* a_Name);
+		bool ReadAt(uint32 a_Offset, byte* a_Dst, uint32 a_Count);
+
+		//@}
+
+		FileStream* m_Stream;
+		uint32 m_Size;
+		uint32 m_Position;
+		Internal::Mutex m_Lock;
+
+		EntryZip* m_Entries;
+		uint32 m_EntryTotal;
+		char* m_Names;
+		uint32* m_Table;
+		uint32 m_TableMask;
+
+	}; // class ArchiveZip
+
+	//! FileStream implementation that reads a file from a ZIP archive
+	/*!
+		Created by ArchiveZip::OpenFile.
+	*/
+	class FileStreamZip : public FileStream
+	{
+
+	public:
+
+		FileStreamZip(ArchiveZip* a_Archive);
+		~FileStreamZip();
+
+		//! Open a file in the archive
+		/*!
+			\param a_File The path of the file in the archive
+			\param a_Options Ignored
+		*/
+		bool Open(const char* a_File, uint32 a_Options);
+
+		bool Read(void* a_Dst, uint32 a_ElementSize, uint32 a_Count = 1);
+		bool ReadByte(byte* a_Dst, uint32 a_Count = 1);
+		bool ReadWord(word* a_Dst, uint32 a_Count = 1);
+		bool ReadDWord(dword* a_Dst, uint32 a_Count = 1);
+
+		bool Seek(uint32 a_Bytes, uint32 a_Options);
+
+		bool EndOfFile();
+
+		uint32 GetSize();
+
+		bool Close();
+
+		bool IsReusable() { return false; }
+
+	private:
+
+		ArchiveZip* m_Archive;
+		byte* m_Data;
+		uint32 m_Offset;
+		uint32 m_Size;
+		uint32 m_Position;
+
+	}; // class FileStreamZip
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
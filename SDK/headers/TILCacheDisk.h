@@ -0,0 +1,182 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILCacheDisk.h
+	\brief Keeping decoded images on disk
+*/
+
+#ifndef _TILCACHEDISK_H_
+#define _TILCACHEDISK_H_
+
+#include "TILSettings.h"
+#include "TILImage.h"
+#include "TILThreads.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! A cache of decoded images on disk
+	/*!
+		Images loaded through the cache are decoded once and stored in a 
+		directory as packs (see ArchivePack), so they can be loaded again 
+		without being decoded, also after a restart. An image found in the 
+		cache is mapped into memory and its pixels point into the mapping.
+
+		An image is found by a key made from its source and the color depth 
+		and load options it's loaded with. When a custom pitch function is 
+		set with #TIL_SetPitchFunc and the stored pitch doesn't match it 
+		anymore, the image is decoded and stored again.
+
+		When the files in the directory take up more than the maximum size, 
+		the images that were used the longest time ago are removed. The list
+		of files is stored in the directory as well, when an image is added 
+		and when the cache is closed.
+
+		Loading from multiple threads at once is supported, but a directory 
+		should only be used by one cache at a time.
+
+		\code
+		til::CacheDisk* cache = new til::CacheDisk();
+		cache->Open("cache", TIL_FILE_ADDWORKINGDIR, 256 * 1024 * 1024);
+
+		til::Image* load = cache->Load("media\\texture.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		til::TIL_Release(load);
+
+		delete cache;
+		\endcode
+	*/
+	class CacheDisk
+	{
+
+	public:
+
+		//! How the source of an image is identified
+		enum KeyType
+		{
+			KEY_CONTENT = 0, /**< The contents of the file, which are read on every load */
+			KEY_PATH    = 1, /**< The path, size and modification time of the file */
+		};
+
+		CacheDisk();
+		~CacheDisk();
+
+		//! Open a cache
+		/*!
+			\param a_Directory The directory to store the images in, which has to exist
+			\param a_Options A file option, see #TIL_FILE_MASK
+			\param a_MaxSize The maximum size in bytes of the stored images
+			\param a_Key How the source of an image is identified
+
+			\return True on success, false on failure
+
+			With #KEY_PATH, finding an image only takes looking up the file, 
+			but changes that keep the size and modification time the same go 
+			unnoticed. When the modification time can't be read, the contents 
+			are used instead.
+		*/
+		bool Open(const char* a_Directory, uint32 a_Options, uint64 a_MaxSize, KeyType a_Key = KEY_CONTENT);
+
+		//! Store the list of files and close the cache
+		/*!
+			\note Images loaded from the cache stay valid.
+		*/
+		void Close();
+
+		//! Load an image through the cache
+		/*!
+			\param a_FileName The path to the image
+			\param a_Options The same options as for #TIL_Load
+
+			\return The image, or NULL if it could not be loaded
+
+			Images found in the cache are returned as ImagePack, others are
+			loaded with #TIL_Load and stored before they are returned. Release
+			the image with #TIL_Release.
+		*/
+		Image* Load(const char* a_FileName, uint32 a_Options);
+
+		//! Get the size in bytes of the stored images
+		uint64 GetSize();
+		//! Get the number of stored images
+		uint32 GetImageCount();
+
+	private:
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+		struct EntryCache
+		{
+			uint64 key;
+			uint32 size;
+			uint32 tick;
+		};
+
+#endif
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		bool GetKey(const char* a_FileName, uint32 a_Options, uint64& a_Key, byte*& a_Data, uint32& a_Size);
+		Image* Find(uint64 a_Key);
+		void Store(uint64 a_Key, const char* a_FileName, Image* a_Image);
+
+		uint32 Lookup(uint64 a_Key);
+		void Insert(uint64 a_Key, uint32 a_Size);
+		void Evict();
+		void BuildTable();
+
+		bool LoadIndex();
+		bool SaveIndex();
+
+		void GetPath(char* a_Dst, uint64 a_Key, const char* a_Extension);
+
+		//@}
+
+		char* m_Directory;
+		uint64 m_MaxSize;
+		uint64 m_Size;
+		KeyType m_Key;
+
+		EntryCache* m_Entries;
+		uint32 m_EntryTotal, m_EntryMax;
+		uint32* m_Table;
+		uint32 m_TableMask;
+		uint32 m_Tick;
+		uint32 m_Temp;
+		Internal::Mutex m_Lock;
+
+	}; // class CacheDisk
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
@@ -0,0 +1,228 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILCacheMemory.h
+	\brief Sharing loaded images within a process
+*/
+
+#ifndef _TILCACHEMEMORY_H_
+#define _TILCACHEMEMORY_H_
+
+#include "TILSettings.h"
+#include "TILImage.h"
+#include "TILThreads.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! A cache of loaded images that are shared within a process
+	/*!
+		Images loaded through the cache are only loaded once for every path 
+		and set of options. Every call to #Load returns a reference to the same 
+		image, which stays in the cache after the last reference was released.
+		When more threads load the same image at the same time, one of them 
+		loads it and the others wait for it.
+
+		When the images in the cache take up more than the maximum size, the
+		images that are not used and were used the longest time ago are removed.
+		Images that are still used are never removed.
+
+		The key is the path as it was passed and the options, so changes to 
+		the file or the pitch function (see #TIL_SetPitchFunc) are not noticed.
+		Call #Clear to load them again.
+
+		\code
+		til::CacheMemory* cache = new til::CacheMemory(64 * 1024 * 1024);
+
+		til::Image* first = cache->Load("media\\texture.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		til::Image* second = cache->Load("media\\texture.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+
+		// first->GetPixels() == second->GetPixels()
+
+		til::TIL_Release(first);
+		til::TIL_Release(second);
+
+		delete cache;
+		\endcode
+
+		\note All images loaded from the cache have to be released before the cache is deleted.
+	*/
+	class CacheMemory
+	{
+
+		friend class ImageShared;
+
+	public:
+
+		//! Create a cache
+		/*!
+			\param a_MaxSize The maximum size in bytes of the pixels of the images 
+			that are kept when they're not used
+		*/
+		CacheMemory(uint64 a_MaxSize);
+		~CacheMemory();
+
+		//! Set the maximum size in bytes of the images in the cache
+		void SetMaxSize(uint64 a_MaxSize);
+
+		//! Load an image through the cache
+		/*!
+			\param a_FileName The path to the image
+			\param a_Options The same options as for #TIL_Load
+
+			\return A reference to the image, or NULL if it could not be loaded
+
+			Release the reference with #TIL_Release.
+		*/
+		Image* Load(const char* a_FileName, uint32 a_Options);
+
+		//! Load an image from a stream through the cache
+		/*!
+			\param a_Stream A handle to a FileStream
+			\param a_Options The same options as for #TIL_Load
+
+			\return A reference to the image, or NULL if it could not be loaded
+
+			The image is identified by the path of the stream. When it's 
+			already in the cache, the stream is closed without reading from it.
+		*/
+		Image* Load(FileStream* a_Stream, uint32 a_Options);
+
+		//! Remove all images that are not used
+		void Clear();
+
+		//! Get the size in bytes of the pixels of the images in the cache
+		uint64 GetSize();
+		//! Get the number of images in the cache
+		uint32 GetImageCount();
+
+	private:
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+		struct EntryShared
+		{
+			char* name;
+			uint32 options;
+			uint32 hash;
+
+			Image* image;
+			uint32 size;
+			uint32 references;
+			bool loading;
+			uint32 waiting;
+			Internal::Semaphore ready;
+
+			EntryShared* next;
+			EntryShared* newer;
+			EntryShared* older;
+		};
+
+#endif
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		Image* Load(const char* a_Name, FileStream* a_Stream, uint32 a_Options);
+		void Release(EntryShared* a_Entry);
+
+		EntryShared* Find(const char* a_Name, uint32 a_Options, uint32 a_Hash);
+		void Remove(EntryShared* a_Entry);
+		void Use(EntryShared* a_Entry);
+		void Evict();
+
+		//@}
+
+		uint64 m_MaxSize;
+		uint64 m_Size;
+		uint32 m_EntryTotal;
+
+		EntryShared** m_Table;
+		uint32 m_TableMask;
+		EntryShared* m_Newest;
+		EntryShared* m_Oldest;
+
+		Internal::Mutex m_Lock;
+
+	}; // class CacheMemory
+
+	//! An image shared through CacheMemory
+	/*!
+		Created by CacheMemory::Load. Every call returns a new ImageShared, 
+		but they share the loaded image and its pixels. Releasing it with 
+		#TIL_Release only releases this reference.
+	*/
+	class ImageShared : public Image
+	{
+
+		friend class CacheMemory;
+
+	public:
+
+		ImageShared();
+		~ImageShared();
+
+		//! Does nothing, the image is already loaded
+		bool Parse(uint32 a_Options);
+
+		uint32 GetFrameCount();
+		float GetDelay();
+
+		byte* GetPixels(uint32 a_Frame = 0);
+
+		uint32 GetWidth(uint32 a_Frame = 0);
+		uint32 GetHeight(uint32 a_Frame = 0);
+
+		uint32 GetPitchX(uint32 a_Frame = 0);
+		uint32 GetPitchY(uint32 a_Frame = 0);
+
+		uint32 GetDataSize(uint32 a_Frame = 0);
+
+		//! Get the shared image
+		/*!
+			Useful for functions specific to a format, like ImageDDS::GetFourCC.
+			The image is owned by the cache and must not be released.
+		*/
+		Image* GetImage();
+
+	private:
+
+		CacheMemory* m_Cache;
+		CacheMemory::EntryShared* m_Entry;
+		Image* m_Image;
+
+	}; // class ImageShared
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
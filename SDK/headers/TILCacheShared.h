@@ -0,0 +1,161 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILCacheShared.h
+	\brief Sharing decoded images between processes
+*/
+
+#ifndef _TILCACHESHARED_H_
+#define _TILCACHESHARED_H_
+
+#include "TILSettings.h"
+#include "TILImage.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! A cache of decoded images in memory shared between processes
+	/*!
+		The first process that opens the cache creates a block of shared memory 
+		with the given name, other processes that open a cache with the same name
+		use the same block. An image loaded through the cache is decoded by one
+		process and copied to the shared memory, after which every process gets
+		an ImagePack whose pixels point into it. So the pixels of an image are 
+		in memory only once, no matter how many processes use it.
+
+		The images are mapped read-only, writing to their pixels is not allowed.
+
+		Finding and adding images doesn't take a lock, so a process that 
+		stops while adding an image doesn't block the others. When a process 
+		loads an image that another process is still decoding, it waits for it. 
+		The cache doesn't remove images: once it's full, images are loaded 
+		without being shared. Use #Remove to throw the cache away.
+
+		The key is the path as it was passed and the options. All processes 
+		should use the same pitch function (see #TIL_SetPitchFunc).
+
+		Uses POSIX shared memory on Linux and named file mappings on Windows.
+		Not supported on other platforms. Older versions of glibc need to be 
+		linked with librt.
+
+		\code
+		til::CacheShared* cache = new til::CacheShared();
+		cache->Open("sprites", 512 * 1024 * 1024, 4096);
+
+		til::Image* load = cache->Load("media\\sprites\\hero.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		til::TIL_Release(load);
+
+		delete cache;
+		\endcode
+
+		\note All images loaded from the cache have to be released before the cache is closed.
+	*/
+	class CacheShared
+	{
+
+	public:
+
+		CacheShared();
+		~CacheShared();
+
+		//! Open or create a cache
+		/*!
+			\param a_Name The name of the shared memory
+			\param a_Size The size in bytes of the shared memory
+			\param a_MaxImages The maximum number of images in the cache
+
+			\return True on success, false on failure
+
+			The size and maximum number of images are only used by the process 
+			that creates the cache. 
+		*/
+		bool Open(const char* a_Name, uint32 a_Size, uint32 a_MaxImages);
+
+		//! Close the cache
+		/*!
+			The shared memory stays available to other processes.
+		*/
+		void Close();
+
+		//! Remove a cache
+		/*!
+			\param a_Name The name of the shared memory
+
+			\return True on success, false on failure
+
+			Processes that have the cache open keep using it, but processes that 
+			open it afterwards create a new one. On Windows, the shared memory is
+			removed when the last process closes it, so this does nothing.
+		*/
+		static bool Remove(const char* a_Name);
+
+		//! Load an image through the cache
+		/*!
+			\param a_FileName The path to the image
+			\param a_Options The same options as for #TIL_Load
+
+			\return The image, or NULL if it could not be loaded
+
+			Images in the cache are returned as ImagePack. Images that don't 
+			fit are loaded with #TIL_Load. Release the image with #TIL_Release.
+		*/
+		Image* Load(const char* a_FileName, uint32 a_Options);
+
+		//! Get the number of images in the cache
+		uint32 GetImageCount();
+		//! Get the number of bytes in use
+		uint32 GetUsedSize();
+
+	private:
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		byte* Claim(uint64 a_Key, bool& a_Owner);
+		bool Store(byte* a_Slot, const char* a_FileName, Image* a_Image);
+		Image* View(byte* a_Slot);
+		bool Allocate(uint32 a_Size, uint32& a_Offset);
+
+		//@}
+
+		byte* m_Map;
+		byte* m_View;
+		uint32 m_Size;
+		uint32 m_SlotTotal;
+		void* m_Handle;
+
+	}; // class CacheShared
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
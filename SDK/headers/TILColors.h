@@ -753,6 +753,114 @@ namespace til
 
 	//@}
 
+	/////////////////////////////////////////////////////
+	/*!
+		@name Color formats
+
+		Describe a color depth at compile time, so conversion code can be
+		written once as a template and specialized for every #til::Image::BitDepth.
+	*/
+	//@{
+	/////////////////////////////////////////////////////
+
+	//! 32-bit ARGB color format
+	struct Format_32b_A8R8G8B8
+	{
+		typedef color_32b type; //!< Storage type of a single pixel
+
+		//! Construct a color
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_32b_A8R8G8B8(a_Red, a_Green, a_Blue, a_Alpha); 
+		}
+	};
+
+	//! 32-bit ABGR color format
+	struct Format_32b_A8B8G8R8
+	{
+		typedef color_32b type; //!< Storage type of a single pixel
+
+		//! Construct a color
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_32b_A8B8G8R8(a_Red, a_Green, a_Blue, a_Alpha); 
+		}
+	};
+
+	//! 32-bit RGBA color format
+	struct Format_32b_R8G8B8A8
+	{
+		typedef color_32b type; //!< Storage type of a single pixel
+
+		//! Construct a color
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_32b_R8G8B8A8(a_Red, a_Green, a_Blue, a_Alpha); 
+		}
+	};
+
+	//! 32-bit BGRA color format
+	struct Format_32b_B8G8R8A8
+	{
+		typedef color_32b type; //!< Storage type of a single pixel
+
+		//! Construct a color
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_32b_B8G8R8A8(a_Red, a_Green, a_Blue, a_Alpha); 
+		}
+	};
+
+	//! 32-bit RGB color format
+	struct Format_32b_R8G8B8
+	{
+		typedef color_32b type; //!< Storage type of a single pixel
+
+		//! Construct a color, alpha is ignored
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_32b_R8G8B8(a_Red, a_Green, a_Blue); 
+		}
+	};
+
+	//! 32-bit BGR color format
+	struct Format_32b_B8G8R8
+	{
+		typedef color_32b type; //!< Storage type of a single pixel
+
+		//! Construct a color, alpha is ignored
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_32b_B8G8R8(a_Red, a_Green, a_Blue); 
+		}
+	};
+
+	//! 16-bit RGB color format
+	struct Format_16b_R5G6B5
+	{
+		typedef color_16b type; //!< Storage type of a single pixel
+
+		//! Construct a color, alpha is ignored
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_16b_R5G6B5(a_Red, a_Green, a_Blue); 
+		}
+	};
+
+	//! 16-bit BGR color format
+	struct Format_16b_B5G6R5
+	{
+		typedef color_16b type; //!< Storage type of a single pixel
+
+		//! Construct a color, alpha is ignored
+		static inline type Construct(uint8 a_Red, uint8 a_Green, uint8 a_Blue, uint8 a_Alpha) 
+		{ 
+			return Construct_16b_B5G6R5(a_Red, a_Green, a_Blue); 
+		}
+	};
+
+	//@}
+
 }; // namespace til
 	
 #endif
\ No newline at end of file
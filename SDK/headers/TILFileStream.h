@@ -62,7 +62,7 @@ namespace til
 	public:
 	
 		FileStream();
-		~FileStream();
+		virtual ~FileStream();
 	
 		//! Open a handle to a file
 		/*!
@@ -147,6 +147,15 @@ namespace til
 		*/
 		virtual bool EndOfFile() = 0;
 
+		//! Get the size of the file
+		/*!
+			\return The size of the file in bytes, or 0 if it's unknown
+
+			\note Only needed by formats that read from the end of a file, like ZIP 
+			archives. The default implementation returns 0.
+		*/
+		virtual uint32 GetSize();
+
 		//! Close the stream
 		/*!
 			Close the handle to the file.
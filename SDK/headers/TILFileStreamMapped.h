@@ -0,0 +1,92 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILFileStreamMapped.h
+	\brief A FileStream that maps a file into memory
+*/
+
+#ifndef _TILFILESTREAMMAPPED_H_
+#define _TILFILESTREAMMAPPED_H_
+
+#include "TILSettings.h"
+#include "TILFileStreamMemory.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! FileStream implementation that maps a file into memory
+	/*!
+		The file is mapped as a whole when it's opened, so its contents can be 
+		used directly with FileStreamMemory::GetData instead of being read. Pages
+		are only loaded from disk when they are touched.
+
+		The mapping is copy-on-write: writing to the data changes the memory of 
+		the process, never the file. On platforms without memory mapped files, 
+		the file is read into memory instead.
+
+		\code
+		til::FileStreamMapped* stream = new til::FileStreamMapped();
+		stream->Open("media\\textures.tilpack", TIL_FILE_ADDWORKINGDIR);
+
+		byte* data = stream->GetData();
+		\endcode
+	*/
+	class FileStreamMapped : public FileStreamMemory
+	{
+	
+	public:
+	
+		FileStreamMapped();
+		~FileStreamMapped();
+
+		//! Open and map a file
+		/*!
+			\param a_File The path to the file
+			\param a_Options A file option, see #TIL_FILE_MASK
+
+			\return True on success, false on failure
+		*/
+		bool Open(const char* a_File, uint32 a_Options);
+
+		//! Unmap the file
+		bool Close();
+
+		bool IsReusable() { return false; }
+
+	private:
+
+		byte* m_Map;
+		uint32 m_MapSize;
+	
+	}; // class FileStreamMapped
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+
+/*!
+	\file TILFileStreamMemory.h
+	\brief A FileStream that reads from memory
+*/
+
+#ifndef _TILFILESTREAMMEMORY_H_
+#define _TILFILESTREAMMEMORY_H_
+
+#include "TILSettings.h"
+#include "TILFileStream.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! FileStream implementation that reads from a block of memory
+	/*!
+		Useful for images that are already in memory, like images embedded 
+		in other files or downloaded from a network. The memory is not copied, 
+		so it has to stay valid for as long as the stream is used.
+
+		The path passed to #Open is only used to determine the format.
+
+		\code
+		til::FileStreamMemory* stream = new til::FileStreamMemory();
+		stream->SetData(data, size);
+		stream->Open("texture.png", TIL_FILE_ABSOLUTEPATH);
+
+		til::Image* load = til::TIL_Load(stream, TIL_DEPTH_A8B8G8R8);
+		\endcode
+	*/
+	class FileStreamMemory : public FileStream
+	{
+	
+	public:
+	
+		FileStreamMemory();
+		~FileStreamMemory();
+
+		//! Set the memory to read from
+		/*!
+			\param a_Data The data
+			\param a_Size The size of the data in bytes
+		*/
+		void SetData(byte* a_Data, uint32 a_Size);
+
+		//! Get the memory that is read from
+		byte* GetData();
+	
+		bool Open(const char* a_File, uint32 a_Options);
+
+		bool Read(void* a_Dst, uint32 a_ElementSize, uint32 a_Count = 1);
+		bool ReadByte(byte* a_Dst, uint32 a_Count = 1);
+		bool ReadWord(word* a_Dst, uint32 a_Count = 1);
+		bool ReadDWord(dword* a_Dst, uint32 a_Count = 1);
+
+		bool Seek(uint32 a_Bytes, uint32 a_Options);
+
+		bool EndOfFile();
+
+		uint32 GetSize();
+
+		bool Close();
+
+		bool IsReusable() { return false; }
+
+	private:
+
+		byte* m_Data;
+		uint32 m_Size;
+		uint32 m_Position;
+	
+	}; // class FileStreamMemory
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
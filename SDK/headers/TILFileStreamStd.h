@@ -70,6 +70,8 @@ namespace til
 
 		bool EndOfFile();
 
+		uint32 GetSize();
+
 		bool Close();
 
 		bool IsReusable() { return false; }
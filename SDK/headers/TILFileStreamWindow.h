@@ -0,0 +1,107 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILFileStreamWindow.h
+	\brief A FileStream that reads part of another FileStream
+*/
+
+#ifndef _TILFILESTREAMWINDOW_H_
+#define _TILFILESTREAMWINDOW_H_
+
+#include "TILSettings.h"
+#include "TILFileStream.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! FileStream implementation that reads a range of bytes from another FileStream
+	/*!
+		Useful for images embedded in other files, like the PNG images stored in
+		ICO files, or files stored in archives. Reads go straight to the parent
+		stream, so the embedded data is never copied to a temporary buffer. Reads
+		and seeks are clamped to the window, so an image can't read past its end.
+
+		The parent is not closed with the window and has to stay open for as long
+		as the window is used. The window seeks the parent before it reads from
+		it, so nothing else should read from the parent in the meantime.
+
+		The path passed to #Open is only used to determine the format.
+
+		\code
+		til::FileStreamWindow* stream = new til::FileStreamWindow(archive, offset, size);
+		stream->Open("texture.png", TIL_FILE_ABSOLUTEPATH);
+
+		til::Image* load = til::TIL_Load(stream, TIL_DEPTH_A8B8G8R8);
+		\endcode
+	*/
+	class FileStreamWindow : public FileStream
+	{
+	
+	public:
+	
+		//! Create a window on a stream
+		/*!
+			\param a_Parent The stream to read from
+			\param a_Offset The start of the window in bytes from the start of the parent
+			\param a_Length The size of the window in bytes
+		*/
+		FileStreamWindow(FileStream* a_Parent, uint32 a_Offset, uint32 a_Length);
+		~FileStreamWindow();
+	
+		bool Open(const char* a_File, uint32 a_Options);
+
+		bool Read(void* a_Dst, uint32 a_ElementSize, uint32 a_Count = 1);
+		bool ReadByte(byte* a_Dst, uint32 a_Count = 1);
+		bool ReadWord(word* a_Dst, uint32 a_Count = 1);
+		bool ReadDWord(dword* a_Dst, uint32 a_Count = 1);
+
+		bool Seek(uint32 a_Bytes, uint32 a_Options);
+
+		bool EndOfFile();
+
+		uint32 GetSize();
+
+		bool Close();
+
+		bool IsReusable() { return false; }
+
+	private:
+
+		FileStream* m_Parent;
+		uint32 m_Offset;
+		uint32 m_Length;
+		uint32 m_Position;
+		bool m_Moved;
+	
+	}; // class FileStreamWindow
+
+}; // namespace til
+	
+#endif
\ No newline at end of file
@@ -65,6 +65,7 @@ namespace til
 			BPP_32B_B8G8R8   = 6, /**< 32-bit BGR color */
 			BPP_16B_R5G6B5   = 7, /**< 16-bit RGB color */
 			BPP_16B_B5G6R5   = 8, /**< 16-bit BGR color */
+			BPP_NATIVE       = 9, /**< Data as stored in the file */
 		};
 
 		Image();
@@ -89,6 +90,39 @@ namespace til
 		*/
 		void Load(FileStream* a_Stream);
 
+		//! Decode the first frame row by row
+		/*!
+			\param a_Options The options used for parsing
+			\param a_Func Called with every band of rows
+			\param a_User Passed to a_Func
+
+			\return True when every row was passed to a_Func
+
+			The main entrypoint for #til::TIL_Decode(). Loaders that can decode 
+			the rows in order only keep a few of them in memory, the others decode 
+			the whole frame and pass it on afterwards.
+		*/
+		bool Decode(uint32 a_Options, RowFunc a_Func, void* a_User);
+
+		//! Decode part of the first frame row by row
+		/*!
+			\param a_Options The options used for parsing
+			\param a_X The left edge of the region
+			\param a_Y The top edge of the region
+			\param a_Width The width of the region, or 0 for the rest of the row
+			\param a_Height The height of the region, or 0 for the rest of the image
+			\param a_Func Called with every band of rows
+			\param a_User Passed to a_Func
+
+			\return True when every row of the region was passed to a_Func
+
+			The main entrypoint for #til::TIL_LoadRegion(). The rows are cropped 
+			to the region and counted from its top. Loaders that can seek only read 
+			the rows and columns they need and every loader stops after the bottom 
+			of the region. Fails when the region doesn't fit in the image.
+		*/
+		bool DecodeRegion(uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height, RowFunc a_Func, void* a_User);
+
 		//! Closes the handle to the image file
 		/*!
 			Used internally by TinyImageLoader.
@@ -191,13 +225,58 @@ namespace til
 		*/
 		virtual uint32 GetPitchY(uint32 a_Frame = 0) = 0;
 
+		//! Get the size of the pixel data of a frame
+		/*!
+			\param a_Frame The frame of an animation or subimage to return
+
+			\return Size in bytes
+
+			By default this is the horizontal pitch times the vertical pitch times 
+			the amount of bytes per pixel. Formats with volume textures or 
+			compressed native data, like DDS, return the size of all their data.
+		*/
+		virtual uint32 GetDataSize(uint32 a_Frame = 0);
+
+		//! Whether the format stores the image at several sizes
+		/*!
+			\return True when the loader picks the size itself when loading with #TIL_LOAD_SIZE
+
+			Images stored at a single size are scaled down while they are decoded instead.
+		*/
+		virtual bool HasSizes() { return false; }
+
 	protected:
 
+		//! Pass rows to the row function
+		/*!
+			\return False when decoding should stop
+		*/
+		bool PushRows(byte* a_Pixels, uint32 a_Row, uint32 a_Count, uint32 a_Width, uint32 a_Height, uint32 a_Pitch);
+
+		//! Fit the region to the size of the image
+		/*!
+			\return False when the region doesn't fit
+
+			Called by PushRows. Loaders call it as soon as they know the size 
+			of the image, so a region outside of it fails before anything is decoded.
+		*/
+		bool CheckRegion(uint32 a_Width, uint32 a_Height);
+
 		FileStream* m_Stream; //!< The file interface
 		char* m_FileName; //!< The filename
 		BitDepth m_BPPIdent; //!< The bit depth to convert to
 		uint8 m_BPP; //!< The amount of bytes per pixel
 
+		RowFunc m_RowFunc; //!< Receives the rows when decoding row by row, otherwise NULL
+		void* m_RowUser; //!< Passed to the row function
+		uint32 m_RowTotal; //!< The amount of rows passed to the row function
+		bool m_RowStop; //!< Whether the row function asked to stop
+
+		uint32 m_RegionX, m_RegionY; //!< The top left of the region to decode
+		uint32 m_RegionWidth, m_RegionHeight; //!< The size of the region to decode
+		bool m_RegionChecked; //!< Whether the region was fit to the image
+		bool m_RegionFailed; //!< Whether the region didn't fit in the image
+
 	}; // class Image
 
 }; // namespace til
@@ -0,0 +1,154 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILImageAtlas.h
+	\brief Many images packed into a single image
+*/
+
+#ifndef _TILIMAGEATLAS_H_
+#define _TILIMAGEATLAS_H_
+
+#include "TILImage.h"
+#include "TILFileStream.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! The place of an image in an atlas
+	struct AtlasRect
+	{
+		uint32 x, y;              /**< The top left corner in pixels. */
+		uint32 width, height;     /**< The size in pixels. */
+		float u0, v0;             /**< The top left corner in texture coordinates. */
+		float u1, v1;             /**< The bottom right corner in texture coordinates. */
+	};
+
+	//! Many images packed into a single image
+	/*!
+		Created by #TIL_LoadAtlas. Holds a single frame with every image
+		in its own rectangle, the space between them is transparent black.
+
+		The texture coordinates are relative to the pitch, which is the size
+		of the texture when the atlas is uploaded as a whole.
+	*/
+	class ImageAtlas : public Image
+	{
+
+	public:
+
+		ImageAtlas();
+		~ImageAtlas();
+
+		//! Does nothing, the atlas is made by #Build
+		bool Parse(uint32 a_Options);
+
+		//! Pack images and decode them into the atlas
+		/*!
+			\param a_Streams Opened streams of the images
+			\param a_Count The amount of streams
+			\param a_Options The options used for parsing
+			\param a_Width The width of the atlas, or 0 to pick a power of two
+			\param a_Padding The amount of empty pixels to the right and below every image
+
+			\return True on success, false when one of the images could not be loaded
+
+			The size of every image is read first, by decoding up to its first row. 
+			The images are then packed from the tallest to the shortest, each in the 
+			lowest spot that is left, and decoded straight into the atlas in parallel.
+			The streams are left open.
+		*/
+		bool Build(FileStream** a_Streams, uint32 a_Count, uint32 a_Options, uint32 a_Width, uint32 a_Padding);
+
+		//! Get the amount of images in the atlas
+		uint32 GetRectCount();
+
+		//! Get the place of an image in the atlas
+		/*!
+			\param a_Index The image, in the order the streams were passed
+
+			\return The rectangle of the image, or NULL if there's no such image
+		*/
+		const AtlasRect* GetRect(uint32 a_Index);
+
+		byte* GetPixels(uint32 a_Frame = 0);
+
+		uint32 GetWidth(uint32 a_Frame = 0);
+		uint32 GetHeight(uint32 a_Frame = 0);
+
+		uint32 GetPitchX(uint32 a_Frame = 0);
+		uint32 GetPitchY(uint32 a_Frame = 0);
+
+	private:
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		struct Entry
+		{
+			ImageAtlas* atlas;
+			FileStream* stream;
+			AtlasRect* rect;
+			bool loaded;
+		};
+
+		struct Skyline
+		{
+			uint32 x, y;
+			uint32 width;
+		};
+
+		//! Place every rectangle, tallest first, in the lowest spot of the skyline.
+		bool Pack(uint32 a_Width, uint32 a_Padding);
+
+		static void ProbeJob(void* a_Data, uint32 a_Index);
+		static void DecodeJob(void* a_Data, uint32 a_Index);
+		static bool ProbeRows(RowData* a_Data);
+		static bool CopyRows(RowData* a_Data);
+		static int CompareRects(const void* a_Left, const void* a_Right);
+
+		//@}
+
+		byte* m_Pixels;
+		uint32 m_Width, m_Height;
+		uint32 m_PitchX, m_PitchY;
+		uint32 m_Options;
+
+		AtlasRect* m_Rects;
+		uint32 m_RectTotal;
+		Entry* m_Entries;
+
+	}; // class ImageAtlas
+
+}; // namespace til
+
+#endif
\ No newline at end of file
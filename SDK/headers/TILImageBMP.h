@@ -75,7 +75,8 @@ namespace til
 			COMP_RLE4 = 2,
 			COMP_BITFIELDS = 3,
 			COMP_JPEG = 4,
-			COMP_PNG = 5
+			COMP_PNG = 5,
+			COMP_ALPHABITFIELDS = 6
 		};
 
 #endif
@@ -116,11 +117,39 @@ namespace til
 		ColorFunc m_ColorFunc;
 
 		dword GetDWord();
+		word GetWord();
+
+		//! Read the palette and convert it to the target depth.
+		void CompilePalette(uint32 a_Count, uint32 a_EntrySize);
+		//! Determine the shift and scale of every color mask.
+		void CompileBitFields(dword* a_Masks);
+		//! Write a color from the palette a number of times.
+		void CopyPalette(byte* a_Dst, uint32 a_Index, uint32 a_Count);
+
+		void DecodeRow(byte* a_Dst, byte* a_Src, uint32 a_Count);
+		//! Find out if converting a pixel only moves its bytes around.
+		void CompileSwizzle();
+		void SwizzleRow(byte* a_Dst, byte* a_Src, uint32 a_Count);
+		void DecompressRunLength(byte* a_Src, uint32 a_Size);
+		//! Read, convert and pass on one row of the region at a time.
+		bool DecodeRows(uint32 a_Offset, uint32 a_ReadPitch, bool a_TopDown);
+		bool ParsePNG(uint32 a_Offset, uint32 a_Size, uint32 a_Options);
 
 		//@}
 
 		uint32 m_Depth;
 
+		byte* m_Palette;
+		dword m_Mask[4];
+		uint32 m_Shift[4];
+		uint32 m_Scale[4];
+		int32 m_Step;
+
+		bool m_Swizzle, m_Copy;
+		uint32 m_SwizzleIndex[4];
+		byte m_SwizzleMask[4];
+		byte m_SwizzleFill[4];
+
 		byte m_Data[4];
 		byte* m_ReadData;
 		byte* m_Pixels;
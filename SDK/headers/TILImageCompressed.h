@@ -0,0 +1,205 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILImageCompressed.h
+	\brief Frames compressed to DXT blocks
+*/
+
+#ifndef _TILIMAGECOMPRESSED_H_
+#define _TILIMAGECOMPRESSED_H_
+
+#include "TILImage.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! Frames compressed to DXT blocks
+	/*!
+		Created by #TIL_Compress. Every frame of the image it was made from is
+		compressed, so the frames of #TIL_CreateMipMaps become the mipmaps of
+		a texture. The data is kept the same way as a DDS image loaded with
+		#TIL_DEPTH_NATIVE and the pixels are copied, so the image they were made
+		from can be released afterwards.
+	*/
+	class ImageCompressed : public Image
+	{
+
+	public:
+
+		ImageCompressed();
+		~ImageCompressed();
+
+		//! Does nothing, the frames are made by #Compress
+		bool Parse(uint32 a_Options);
+
+		//! Compress every frame of an image
+		/*!
+			\param a_Image A parsed image
+			\param a_Format The block format, like #TIL_COMPRESS_BC1
+
+			\return True on success, false on failure
+		*/
+		bool Compress(Image* a_Image, uint32 a_Format);
+
+		uint32 GetFrameCount();
+
+		//! Get the blocks of a frame
+		/*!
+			\param a_Frame The frame to return
+
+			The blocks are stored row by row, every row of blocks
+			covering four rows of pixels.
+		*/
+		byte* GetPixels(uint32 a_Frame = 0);
+
+		uint32 GetWidth(uint32 a_Frame = 0);
+		uint32 GetHeight(uint32 a_Frame = 0);
+
+		uint32 GetPitchX(uint32 a_Frame = 0);
+		uint32 GetPitchY(uint32 a_Frame = 0);
+
+		//! Get the size of the blocks of a frame
+		/*!
+			\param a_Frame The frame to return
+
+			\return Size in bytes
+		*/
+		uint32 GetDataSize(uint32 a_Frame = 0);
+
+		//! Get the FourCC code of the blocks
+		/*!
+			\return 'DXT1' or 'DXT5', the same as til::ImageDDS::GetFourCC
+		*/
+		uint32 GetFourCC();
+
+		//! Get the size of a block
+		/*!
+			\return 8 for #TIL_COMPRESS_BC1 and 16 for #TIL_COMPRESS_BC3
+		*/
+		uint32 GetBlockSize();
+
+		//! Get the size of the image when stored as a DDS file
+		/*!
+			\return Size in bytes, or 0 if the frames can't be stored as mipmaps
+		*/
+		uint32 GetDDSSize();
+
+		//! Store the image as a DDS file
+		/*!
+			\param a_Dst A buffer of at least #GetDDSSize bytes
+
+			\return True on success, false on failure
+
+			The first frame becomes the texture and the frames after it its mipmaps,
+			so every frame has to be half the size of the one before it. The result
+			can be written to disk or loaded with #TIL_Load through a
+			til::FileStreamMemory.
+
+			\code
+			til::Image* load = til::TIL_Load("media\\texture.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+			til::Image* mipmaps = til::TIL_CreateMipMaps(load);
+			til::ImageCompressed* compressed = til::TIL_Compress(mipmaps, TIL_COMPRESS_BC3);
+
+			byte* file = new byte[compressed->GetDDSSize()];
+			compressed->WriteDDS(file);
+			\endcode
+		*/
+		bool WriteDDS(byte* a_Dst);
+
+		//! Compress pixels
+		/*!
+			\param a_Dst The blocks to write to
+			\param a_Src The pixels to compress
+			\param a_Width The width of a_Src
+			\param a_Height The height of a_Src
+			\param a_Pitch The distance in bytes between two rows of a_Src
+			\param a_Depth The color depth of a_Src, like #TIL_DEPTH_A8R8G8B8
+			\param a_Format The block format, like #TIL_COMPRESS_BC1
+
+			\return True on success, false on failure
+
+			a_Dst needs room for a block for every four by four pixels, rounded up.
+			Pixels outside the edge of the image are filled with those on the edge.
+
+			The colors of a block are fit along the line through them with the
+			most spread, after which the end points are refined with a least
+			squares fit on the chosen indices. Pixels with an alpha below 128 become
+			transparent in BC1 blocks, BC3 blocks store the alpha in a block of
+			its own. Bands of block rows are compressed in parallel.
+		*/
+		static bool CompressPixels(
+			byte* a_Dst,
+			byte* a_Src, uint32 a_Width, uint32 a_Height, uint32 a_Pitch,
+			uint32 a_Depth, uint32 a_Format
+		);
+
+	private:
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		struct Level
+		{
+			byte* data;
+			uint32 width, height;
+			uint32 size;
+		};
+
+		struct CompressJob
+		{
+			byte* dst;
+			byte* src;
+			uint32 width, height, pitch;
+			uint32 bpp;
+			uint32 shift[4];
+			bool alpha;
+			uint32 format;
+		};
+
+		static uint32 GetStoredSize(uint32 a_Width, uint32 a_Height, uint32 a_Format);
+
+		//! Read the pixels of a block as 8-bit RGBA, repeating the edge of the image.
+		static void GatherBlock(byte* a_Dst, CompressJob* a_Job, uint32 a_X, uint32 a_Y);
+		static void CompressBand(void* a_Data, uint32 a_Index);
+
+		//@}
+
+		Level* m_Levels;
+		uint32 m_LevelTotal;
+		uint32 m_Format;
+
+	}; // class ImageCompressed
+
+}; // namespace til
+
+#endif
\ No newline at end of file
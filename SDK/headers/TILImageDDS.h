@@ -31,6 +31,7 @@
 */
 
 #include "TILImage.h"
+#include "TILThreads.h"
 
 #if (TIL_FORMAT & TIL_FORMAT_DDS)
 
@@ -48,10 +49,29 @@ namespace til
 
 	public:
 
+		//! Called when a level of detail has been decoded
+		/*!
+			\param a_Image The image being decoded
+			\param a_Level The mipmap level that was decoded, for every face
+			\param a_UserData The data passed to #StreamMipMaps
+
+			\return True to continue with the next level, false to stop
+		*/
+		typedef bool (*MipMapFunc)(ImageDDS* a_Image, uint32 a_Level, void* a_UserData);
+
 		ImageDDS();
 		~ImageDDS();
 
 		uint32 GetFrameCount();
+		bool HasSizes();
+
+		//! Get the pixel data of a mipmap
+		/*!
+			\param a_Frame The mipmap to return, starting with the mipmaps of the first face
+
+			When loaded with #TIL_LOAD_DEFERRED, the mipmap is decoded the first 
+			time it is requested.
+		*/
 		byte* GetPixels(uint32 a_Frame = 0);
 
 		uint32 GetWidth(uint32 a_Frame = 0);
@@ -60,7 +80,141 @@ namespace til
 		uint32 GetPitchX(uint32 a_Frame = 0);
 		uint32 GetPitchY(uint32 a_Frame = 0);
 
-		bool Parse(uint32 a_ColorDepth);
+		//! Get the amount of slices of a mipmap
+		/*!
+			\param a_Frame The mipmap to return
+
+			\return The depth of a volume texture at this level of detail, otherwise 1
+		*/
+		uint32 GetDepth(uint32 a_Frame = 0);
+
+		//! Get the distance between two slices of a mipmap
+		/*!
+			\param a_Frame The mipmap to return
+
+			\return The distance in bytes
+
+			The slices of a volume texture are stored after each other in the buffer
+			returned by #GetPixels. When loaded with #TIL_DEPTH_NATIVE, this is the size
+			of a slice as stored in the file.
+
+			\code
+			byte* slice = load->GetPixels(0) + (z * load->GetSlicePitch(0));
+			\endcode
+		*/
+		uint32 GetSlicePitch(uint32 a_Frame = 0);
+
+		//! Whether the image is a volume texture
+		bool IsVolume();
+
+		//! Get the FourCC code of the stored data
+		/*!
+			\return The FourCC code or 0 if the data is uncompressed
+
+			Useful when uploading data loaded with #TIL_DEPTH_NATIVE to the graphics card.
+
+			Images with a DX10 header return the FourCC of the equivalent format.
+			BC6H and BC7 don't have one and return 'BC6H', 'BC6S' (signed BC6H) 
+			and 'BC7L' instead.
+		*/
+		uint32 GetFourCC();
+
+		//! Get the DXGI format of the stored data
+		/*!
+			\return The DXGI_FORMAT from the DX10 header or 0 if the image doesn't have one
+		*/
+		uint32 GetDXGIFormat();
+
+		//! Get the size of a block of stored data
+		/*!
+			\return The size in bytes of a 4x4 block for compressed data or of a single pixel for uncompressed data
+		*/
+		uint32 GetBlockSize();
+
+		//! Whether the stored data is compressed in 4x4 blocks
+		bool IsBlockCompressed();
+
+		//! Get the amount of mipmaps per face
+		uint32 GetMipMapCount();
+
+		//! Get the amount of faces
+		/*!
+			\return 6 for a complete cubemap, otherwise 1, times the size of the array
+
+			The faces of every element of a texture array are stored after each other.
+		*/
+		uint32 GetFaceCount();
+
+		//! Get the amount of textures in a texture array
+		/*!
+			\return The array size from the DX10 header, otherwise 1
+		*/
+		uint32 GetArraySize();
+
+		//! Get the size of the pixel data of a frame
+		/*!
+			\param a_Frame The mipmap to return, starting with the mipmaps of the first face
+
+			\return Size in bytes
+
+			When loaded with #TIL_DEPTH_NATIVE, this is the size of the block data
+			as stored in the file.
+		*/
+		uint32 GetDataSize(uint32 a_Frame = 0);
+
+		//! Get the size of a face
+		/*!
+			\return The size in bytes of a face, including all its mipmaps
+		*/
+		uint32 GetFaceSize();
+
+		//! Convert a 16-bit float to a float
+		/*!
+			\param a_Half The 16-bit float
+
+			\return The value as a float, or 0 if it is not a number
+
+			Useful for images stored as A16B16G16R16F and loaded with #TIL_DEPTH_NATIVE, 
+			when the full range of the values is needed.
+		*/
+		static float HalfToFloat(word a_Half);
+
+		//! Decode a BC6H block to 16-bit floats
+		/*!
+			\param a_Dst 16 pixels of three 16-bit floats each
+			\param a_Src The 16 bytes of the block
+			\param a_Signed Whether the block is stored as signed (BC6H_SF16) or unsigned (BC6H_UF16)
+
+			BC6H images are clamped to 8 bits per channel when loaded. Use this function 
+			on images loaded with #TIL_DEPTH_NATIVE when the full range of the values is needed.
+		*/
+		static void DecodeBC6H(word* a_Dst, byte* a_Src, bool a_Signed);
+
+		//! Decode the mipmaps from smallest to largest
+		/*!
+			\param a_Func Called after every level has been decoded
+			\param a_UserData Passed to a_Func
+
+			\return False if a_Func stopped before the largest level, otherwise true
+
+			Meant for images loaded with #TIL_LOAD_DEFERRED, so the smallest levels 
+			can be shown while the larger ones are still being decoded. Levels that 
+			were already decoded are passed to a_Func right away.
+
+			\code
+			bool OnMipMap(til::ImageDDS* a_Image, uint32 a_Level, void* a_UserData)
+			{
+				UploadTexture((Texture*)a_UserData, a_Level, a_Image->GetPixels(a_Level));
+				return true;
+			}
+
+			til::ImageDDS* load = (til::ImageDDS*)TIL_Load("media\\texture.dds", TIL_DEPTH_A8B8G8R8 | TIL_LOAD_DEFERRED | TIL_FILE_ADDWORKINGDIR);
+			load->StreamMipMaps(OnMipMap, texture);
+			\endcode
+		*/
+		bool StreamMipMaps(MipMapFunc a_Func, void* a_UserData = NULL);
+
+		bool Parse(uint32 a_Options);
 
 	private:
 		
@@ -83,42 +237,66 @@ namespace til
 
 		ImageDDS::ColorFunc m_ColorFunc;
 
-		void AddMipMap(uint32 a_Width, uint32 a_Height);
-		void GetBlocks(uint32 a_Width, uint32 a_Height);
-		void ConstructColors(color_16b a_Color0, color_16b a_Color1);
+		typedef void (*BlockFunc)(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height);
 
-		void DecompressDXT1();
-		void DecompressDXT5();
-		bool DecompressUncompressed();
+		ImageDDS::BlockFunc m_BlockFunc;
+
+		void DecodeFrames(uint32* a_Frames, uint32 a_Count);
+		uint32 GetStoredSize(uint32 a_Width, uint32 a_Height);
+		uint32 GetStoredFaceSize();
+		bool ParseFormatDX10(uint32 a_Format);
+		bool ParseNative();
+		//! Read the stored data of every face, without the mipmaps that were skipped.
+		bool ReadFaces(byte* a_Dst);
+		//! Read and pass on the region of the first image a row of blocks at a time.
+		bool DecodeRows(bool a_Native);
+
+		void DecompressUncompressed(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height);
+
+		static void DecodeJob(void* a_Data, uint32 a_Index);
 
 		struct MipMap
 		{
 			uint32 width, height;
 			uint32 pitchx, pitchy;
+			uint32 depth;
+			uint32 slice;
+			uint32 size;
+			byte* src;
 			byte* data;
 		};
 
+		struct DecodeTask
+		{
+			MipMap* mipmap;
+			byte* src;
+			uint32 z, y, height;
+		};
+
 		//@}
 
 		uint32 m_Offset;
 		uint32 m_Width, m_Height, m_Depth;
 		uint32 m_PitchX, m_PitchY;
 		MipMap* m_MipMap;
-		uint32 m_MipMapSize;
 		uint32 m_MipMapTotal;
 		uint32 m_MipMapCurrent;
 		uint32 m_CubeMap;
 		uint32 m_Format;
+		uint32 m_DXGIFormat;
+		uint32 m_ArraySize;
 		uint32 m_InternalDepth, m_InternalBPP;
-		uint32 m_Size, m_Blocks;
 		uint32 m_BlockSize;
-
-		byte* m_Colors;
-		byte* m_Alpha;
+		uint32 m_SkipSize;
 
 		byte* m_Data;
+		DecodeTask* m_Tasks;
 		byte* m_Pixels;
 
+		bool m_Deferred;
+		uint32 m_Decoded;
+		Internal::Mutex m_Lock;
+
 	}; // class ImageDDS
 
 }; // namespace til
@@ -83,6 +83,8 @@ namespace til
 		void ReleaseMemory(BufferLinked* a_Buffer);
 
 		void ColorFunc(byte* a_Dst, int32 a_Code);
+		//! Move to the next row, or pass it on when decoding row by row.
+		bool NextRow(byte*& a_Target);
 		
 		//@}
 
@@ -119,6 +121,7 @@ namespace til
 		uint32 m_LocalWidth, m_LocalHeight, m_LocalPitch;
 		uint32 m_LocalPitchX, m_LocalPitchY;
 		uint32 m_TotalBytes;
+		uint32 m_Row;
 		
 	}; // class ImageGIF
 
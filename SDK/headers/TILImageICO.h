@@ -31,6 +31,7 @@
 #define _TILIMAGEICO_H_
 
 #include "TILImage.h"
+#include "TILThreads.h"
 
 #if (TIL_FORMAT & TIL_FORMAT_ICO)
 
@@ -57,6 +58,7 @@ namespace til
 
 		uint32 GetFrameCount();
 		byte* GetPixels(uint32 a_Frame = 0);
+		bool HasSizes();
 
 		uint32 GetWidth(uint32 a_Frame = 0);
 		uint32 GetHeight(uint32 a_Frame = 0);
@@ -64,20 +66,52 @@ namespace til
 		uint32 GetPitchX(uint32 a_Frame = 0);
 		uint32 GetPitchY(uint32 a_Frame = 0);
 
+		//! Get the amount of bits per pixel an image is stored with
+		/*!
+			\param a_Frame The image in the icon
+
+			\return Bits per pixel
+
+			Available before the image is decoded.
+		*/
+		uint32 GetBitCount(uint32 a_Frame = 0);
+
+		//! Whether an image is stored as a PNG
+		/*!
+			\param a_Frame The image in the icon
+
+			\return True if the image is a PNG, false if it's a bitmap
+		*/
+		bool IsPNG(uint32 a_Frame = 0);
+
+		//! Find the image that fits a size best
+		/*!
+			\param a_Width The preferred width
+			\param a_Height The preferred height
+
+			\return The frame of the image
+
+			The smallest image that is at least as large as the size is preferred.
+			If there is none, the largest image is returned. When images have the 
+			same size, the one with the most colors wins.
+
+			Only the dimensions are compared, so no images are decoded.
+			When the icon was loaded with #TIL_LOAD_DEFERRED, only the returned 
+			frame is decoded when calling #GetPixels.
+		*/
+		uint32 GetBestFrame(uint32 a_Width, uint32 a_Height);
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 		struct BufferICO
 		{
 			byte* buffer;
-			uint32 width, height, pitch;
-			uint32 pitchy;
-			uint32 readpx, readpy;
+			byte* data;
+			uint32 width, height;
+			uint32 pitch, pitchy;
 			uint32 datasize, offset;
-			uint32 bytespp, bitspp;
-			byte* colors;
-			uint16 palette;
-			byte* andmask;
-			BufferICO* next;
+			uint32 bitspp;
+			bool png;
 		};
 
 #endif
@@ -103,26 +137,20 @@ namespace til
 
 		ColorFunc m_ColorFunc;
 
-		void AddBuffer(uint32 a_Width, uint32 a_Height);
-		void ReleaseMemory(BufferICO* a_Buffer);
-		void ExpandPalette(BufferICO* a_Buffer);
-		void WriteColumnAnd(uint8* a_Dst, uint8* a_Src, uint32 a_Width, uint8* a_Palette, uint8* a_AndMask);
-		void WriteColumnPalette(uint8* a_Dst, uint8* a_Src, uint32 a_Width, uint8* a_Palette);
-		void WriteColumnUncompressed(uint8* a_Dst, uint8* a_Src, uint32 a_Width, uint32 a_BPP);
+		//! Decode an image from its stored data, if it wasn't decoded yet.
+		bool DecodeEntry(BufferICO* a_Entry);
+		bool DecodeBitmap(BufferICO* a_Entry, byte* a_Dst);
+		bool DecodePNG(BufferICO* a_Entry, byte* a_Dst);
+
+		//! Whether the first entry fits a size better than the second.
+		bool FitsBetter(BufferICO* a_First, BufferICO* a_Second, uint32 a_Width, uint32 a_Height);
 		
 		//@}
 
 		uint32 m_Images;
+		BufferICO* m_Entries;
 
-		byte* m_Pixels;
-		uint32 m_Width, m_Height, m_Pitch;
-
-#ifdef OLDMETHOD
-		FILE* m_Handle;
-#endif
-
-		BufferICO* m_First;
-		BufferICO* m_Current;
+		Internal::Mutex m_Lock;
 
 	}; // class ImageICO
 
@@ -61,6 +61,9 @@ namespace til
 
 	public:
 
+		typedef bool (*FillFunc)(void* a_User, uint8** a_Data, uint32* a_Length);
+		typedef bool (*FlushFunc)(void* a_User, byte* a_Data, uint32 a_Length);
+
 		zbuf();
 		~zbuf();
 
@@ -70,11 +73,16 @@ namespace til
 		int32 GetByte();
 		bool ParseUncompressedBlock();
 		int HuffmanDecode(Huffman* a_Huffman);
-		Huffman* ZLibDecode(uint8* a_Data, uint32 a_Length);
+		bool ZLibDecode(uint8* a_Data, uint32 a_Length);
+		bool Inflate(uint8* a_Data, uint32 a_Length, byte* a_Dst, uint32 a_DstLength);
+		//! Decompress input from a_Fill, passing the output to a_Flush in pieces.
+		bool Stream(FillFunc a_Fill, FlushFunc a_Flush, void* a_User);
+		bool ParseHeader();
+		bool ParseBlocks();
 		uint32 GetCode(uint32 a_Amount);
 		bool Expand(int32 a_Amount);
+		bool Refill();
 
-		char* bigger_data;
 
 		char* buffer;
 		uint8* zbuffer;
@@ -87,6 +95,11 @@ namespace til
 		char* zout_end;
 		int32 z_expandable;
 
+		FillFunc fill;
+		FlushFunc flush;
+		void* user;
+		char* zout_flushed;
+
 		Huffman* z_length;
 		Huffman* z_distance;
 
@@ -118,6 +131,20 @@ namespace til
 		uint32 GetPitchX(uint32 a_Frame = 0);
 		uint32 GetPitchY(uint32 a_Frame = 0);
 
+		//! Decode the image into pixels owned by the caller
+		/*!
+			\param a_Pixels Pixels at the requested color depth.
+			\param a_Width The width the image must have.
+			\param a_Height The height the image must have.
+			\param a_PitchX The horizontal pitch of the pixels.
+			\param a_PitchY The vertical pitch of the pixels.
+
+			Used by formats that embed PNG images, so the image doesn't have to
+			be copied after decoding. Parsing fails if the image has a different
+			size. The pixels are not deleted with the image.
+		*/
+		void SetTarget(byte* a_Pixels, uint32 a_Width, uint32 a_Height, uint32 a_PitchX, uint32 a_PitchY);
+
 	private:
 
 		/*!
@@ -140,6 +167,7 @@ namespace til
 		ColorFunc m_ColorFunc;
 
 		struct AnimationData;
+		struct RowState;
 
 		bool Decompile(
 			byte* a_Dst, byte* a_Src, 
@@ -147,6 +175,15 @@ namespace til
 			int a_Depth, 
 			int a_OffsetX = 0, int a_OffsetY = 0
 		);
+		bool UnfilterRow(byte* a_Src, uint8* a_Cur, uint8* a_Prior, uint32 a_Width, int a_Depth, bool a_First);
+		void ConvertRow(byte* a_Dst, uint8* a_Src, uint32 a_Count);
+		//! Turn a pixel with a palette index, gray or a transparent color into RGBA.
+		void ExpandPixel(uint8* a_Dst, uint8* a_Src);
+
+		//! Decompress the image data and pass the rows of the region on one at a time.
+		bool DecodeRows();
+		static bool FillRows(void* a_User, uint8** a_Data, uint32* a_Length);
+		static bool FlushRows(void* a_User, byte* a_Data, uint32 a_Length);
 		
 		byte GetByte();
 		word GetWord();
@@ -159,16 +196,19 @@ namespace til
 		bool Compile();
 
 		bool Compose();
+		void CreateFrames();
 		
 		//@}
 
 		byte** m_Pixels;
+		byte* m_Target;
+		uint32 m_TargetWidth, m_TargetHeight;
 		uint32 m_Width, m_Height, m_Pitch;
 		uint32 m_PitchX, m_PitchY;
 
 		uint8 *idata, *expanded, *out;
 		uint32 ioff, m_RawLength;
-		int32 img_n, img_out_n;
+		int32 img_n;
 		zbuf m_ZBuffer;
 		Huffman* m_Huffman;
 		chunk* m_Chunk;
@@ -176,6 +216,8 @@ namespace til
 		int req_comp;
 		uint8 has_trans;
 		uint8 pal_img_n;
+		uint8 palette[1024];
+		uint8 tc[3];
 
 		uint32 m_Frames;
 		uint32 m_DefaultImage;
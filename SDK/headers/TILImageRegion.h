@@ -0,0 +1,119 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+
+/*!
+	\file TILImageRegion.h
+	\brief A region decoded from another image, optionally scaled down
+*/
+
+#ifndef _TILIMAGEREGION_H_
+#define _TILIMAGEREGION_H_
+
+#include "TILImage.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! A region decoded from another image, optionally scaled down
+	/*!
+		Created by #TIL_LoadRegion, and by #TIL_Load when loading with #TIL_LOAD_SIZE. 
+		Holds a single frame the size of the region, the image it was decoded from 
+		is released after decoding.
+
+		With a size hint, the rows are averaged in blocks of a power of two pixels 
+		while they are decoded, so only the scaled down frame is kept in memory.
+	*/
+	class ImageRegion : public Image
+	{
+
+	public:
+
+		ImageRegion();
+		~ImageRegion();
+
+		//! Does nothing, the region is decoded by #Crop
+		bool Parse(uint32 a_Options);
+
+		//! Decode a region of an image
+		/*!
+			\param a_Image A loaded image that wasn't parsed yet
+			\param a_Options The options used for parsing
+			\param a_X The left edge of the region
+			\param a_Y The top edge of the region
+			\param a_Width The width of the region, or 0 for the rest of the row
+			\param a_Height The height of the region, or 0 for the rest of the image
+
+			\return True on success, false on failure
+
+			When the options contain a #TIL_LOAD_SIZE hint and the image isn't stored 
+			at several sizes, the region is scaled down by the largest power of two 
+			that keeps its longest side at least as large as the hint.
+		*/
+		bool Crop(Image* a_Image, uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height);
+
+		byte* GetPixels(uint32 a_Frame = 0);
+
+		uint32 GetWidth(uint32 a_Frame = 0);
+		uint32 GetHeight(uint32 a_Frame = 0);
+
+		uint32 GetPitchX(uint32 a_Frame = 0);
+		uint32 GetPitchY(uint32 a_Frame = 0);
+
+	private:
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		static bool CopyRows(RowData* a_Data);
+		//! Pick the scale and create the frame once the size of the region is known.
+		bool CreateFrame(uint32 a_Width, uint32 a_Height);
+		byte* GetRow(uint32 a_Row);
+		//! Add a row to the sums of its blocks and write them out after the last row of the block.
+		void AddRow(uint32 a_Row, byte* a_Src);
+
+		//@}
+
+		byte* m_Pixels;
+		uint32 m_Width, m_Height;
+		uint32 m_PitchX, m_PitchY;
+
+		bool m_BottomUp;
+		uint32 m_Size, m_Shift;
+		uint32 m_SourceWidth, m_SourceHeight;
+		uint32* m_Sums;
+
+	}; // class ImageRegion
+
+}; // namespace til
+
+#endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILImageResized.h
+	\brief Frames resized from another image
+*/
+
+#ifndef _TILIMAGERESIZED_H_
+#define _TILIMAGERESIZED_H_
+
+#include "TILImage.h"
+
+namespace til
+{
+
+	// this seemingly pointless forward declaration
+	// is necessary to fool doxygen into documenting
+	// the class
+	class DoxygenSaysWhat;
+
+	//! Frames resized from another image
+	/*!
+		Created by #TIL_Resize, with a single frame, and by #TIL_CreateMipMaps, 
+		with a frame for every level of detail. The pixels are copied, so the 
+		image they were made from can be released afterwards.
+	*/
+	class ImageResized : public Image
+	{
+
+	public:
+
+		ImageResized();
+		~ImageResized();
+
+		//! Does nothing, the frames are made by #Resize and #CreateMipMaps
+		bool Parse(uint32 a_Options);
+
+		//! Resize a frame of an image
+		/*!
+			\param a_Image A parsed image
+			\param a_Frame The frame to resize
+			\param a_Width The new width
+			\param a_Height The new height
+			\param a_Filter The filter, like #TIL_FILTER_LANCZOS
+
+			\return True on success, false on failure
+		*/
+		bool Resize(Image* a_Image, uint32 a_Frame, uint32 a_Width, uint32 a_Height, uint32 a_Filter);
+
+		//! Create the mipmaps of a frame of an image
+		/*!
+			\param a_Image A parsed image
+			\param a_Frame The frame to start from
+			\param a_Filter The filter, like #TIL_FILTER_BOX
+
+			\return True on success, false on failure
+
+			The first frame is a copy of a_Frame, every next frame is made from 
+			the one before it at half its size, down to a single pixel.
+		*/
+		bool CreateMipMaps(Image* a_Image, uint32 a_Frame, uint32 a_Filter);
+
+		uint32 GetFrameCount();
+		byte* GetPixels(uint32 a_Frame = 0);
+
+		uint32 GetWidth(uint32 a_Frame = 0);
+		uint32 GetHeight(uint32 a_Frame = 0);
+
+		uint32 GetPitchX(uint32 a_Frame = 0);
+		uint32 GetPitchY(uint32 a_Frame = 0);
+
+		//! Resize pixels
+		/*!
+			\param a_Dst The pixels to write to
+			\param a_DstWidth The width to resize to
+			\param a_DstHeight The height to resize to
+			\param a_DstPitch The distance in bytes between two rows of a_Dst
+			\param a_Src The pixels to resize
+			\param a_SrcWidth The width of a_Src
+			\param a_SrcHeight The height of a_Src
+			\param a_SrcPitch The distance in bytes between two rows of a_Src
+			\param a_Depth The color depth of both, like #TIL_DEPTH_A8R8G8B8
+			\param a_Filter The filter, like #TIL_FILTER_LANCZOS
+
+			\return True on success, false on failure
+
+			The weights of the filter are worked out once for every column and 
+			every row, after which the image is filtered horizontally and then 
+			vertically in fixed point. Bands of rows are resized in parallel.
+
+			Every channel is filtered on its own, so colors of transparent pixels
+			bleed into their neighbours.
+		*/
+		static bool Resample(
+			byte* a_Dst, uint32 a_DstWidth, uint32 a_DstHeight, uint32 a_DstPitch, 
+			byte* a_Src, uint32 a_SrcWidth, uint32 a_SrcHeight, uint32 a_SrcPitch, 
+			uint32 a_Depth, uint32 a_Filter
+		);
+
+	private:
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		struct Level
+		{
+			byte* pixels;
+			uint32 width, height;
+			uint32 pitchx, pitchy;
+		};
+
+		//! The source pixels and weights for every target pixel along one axis
+		struct Axis
+		{
+			uint32* first;
+			uint32* count;
+			int32* weights;
+			uint32 window;
+		};
+
+		struct ResampleJob
+		{
+			byte* dst;
+			uint32 dst_width, dst_height, dst_pitch;
+			byte* src;
+			uint32 src_width, src_height, src_pitch;
+			uint32 bpp;
+			Axis* horizontal;
+			Axis* vertical;
+		};
+
+		bool SetDepth(Image* a_Image);
+
+		bool CreateLevel(uint32 a_Index, uint32 a_Width, uint32 a_Height);
+
+		//! Work out the weights of the filter for every target pixel.
+		static void CreateAxis(Axis* a_Axis, uint32 a_Source, uint32 a_Target, uint32 a_Filter);
+		static void DeleteAxis(Axis* a_Axis);
+		//! Filter a row horizontally, keeping some of the fraction for the vertical pass.
+		static void FilterRow(int32* a_Dst, byte* a_Src, Axis* a_Axis, uint32 a_Width);
+		static void ResampleBand(void* a_Data, uint32 a_Index);
+
+		//@}
+
+		Level* m_Levels;
+		uint32 m_LevelTotal;
+
+	}; // class ImageResized
+
+}; // namespace til
+
+#endif
\ No newline at end of file
@@ -91,8 +91,22 @@ namespace til
 		uint8* ColorFunc_B8G8R8(uint8* a_Dst, uint8* a_Src, uint32 a_BPP, int a_Repeat, int a_Unique);
 		uint8* ColorFunc_R5G6B5(uint8* a_Dst, uint8* a_Src, uint32 a_BPP, int a_Repeat, int a_Unique);
 		uint8* ColorFunc_B5G6R5(uint8* a_Dst, uint8* a_Src, uint32 a_BPP, int a_Repeat, int a_Unique);
+		uint8* ColorFunc_Palette(uint8* a_Dst, uint8* a_Src, uint32 a_BPP, int a_Repeat, int a_Unique);
+		uint8* ColorFunc_GrayAlpha(uint8* a_Dst, uint8* a_Src, uint32 a_BPP, int a_Repeat, int a_Unique);
 
+		//! Writes the stored pixels
 		ImageTGA::ColorFunc m_ColorFunc;
+		//! Converts true color pixels to the target depth
+		ImageTGA::ColorFunc m_ConvertFunc;
+
+		//! Read the color map and convert it to the target depth.
+		bool CompileColorMap(uint32 a_Offset, uint32 a_Length, uint32 a_Bits);
+
+		//! Convert every shade of gray to the target depth.
+		void CompileGrayscale();
+
+		//! Move to the next row, or pass it on when decoding row by row.
+		bool NextRow();
 
 		//! Compile uncompressed image data to pixel information.
 		bool CompileUncompressed();
@@ -107,12 +121,18 @@ namespace til
 		ColorType m_Type;
 		Compression m_Comp;
 		byte* m_Target;
+		int32 m_Step;
+		byte* m_Palette;
 		byte m_Src[4];
 		byte m_Depth;
 
 		uint32 m_Width, m_Height, m_Pitch;
 		uint32 m_PitchX, m_PitchY;
 
+		bool m_Rows;
+		uint32 m_Row;
+		uint32 m_Offset;
+
 	}; // class ImageTGA
 
 }; // namespace til
@@ -41,6 +41,7 @@ namespace til
 	extern void TIL_AddWorkingDirectory(char* a_Dst, size_t a_MaxLength, const char* a_Path);
 
 	class FileStream;
+	class Image;
 
 	namespace Internal
 	{
@@ -99,12 +100,43 @@ namespace til
 		*/
 		static FileStreamFunc g_FileFunc = OpenStreamDefault;
 
+		//! Opens a FileStream with the function set by #TIL_SetFileStreamFunc
+		/*!
+			\note Internal method.
+
+			Use this instead of #g_FileFunc outside of TinyImageLoader.cpp, 
+			because every file has its own copy of the function pointer.
+		*/
+		extern FileStream* OpenStream(const char* a_Path, uint32 a_Options);
+
+		//! Create the loader for a stream
+		/*!
+			\param a_Stream The stream to load from
+
+			\return A loader that wasn't given the stream yet, or NULL if the format is unknown
+
+			\note Internal method.
+
+			The format is picked by the extension of the path of the stream.
+		*/
+		extern Image* CreateImage(FileStream* a_Stream);
+
 		extern bool GetPitch(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY);
 		extern byte* CreatePixels(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY);
 
 		extern void CreatePixelsDefault(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY);
 		static PitchFunc g_PixelFunc = CreatePixelsDefault;
 
+		//! Get the bytes per pixel of a color depth
+		/*!
+			\param a_Depth A til::Image::BitDepth
+
+			\return The amount of bytes per pixel, or 0 for #TIL_DEPTH_NATIVE
+
+			\note Internal method.
+		*/
+		extern uint32 GetBPP(uint32 a_Depth);
+
 		/*inline void SetPitch(uint32 a_Options, uint32 a_Width, uint32 a_Height, uint32& a_PitchX, uint32& a_PitchY)
 		{
 			uint32 options = a_Options & TIL_PITCH_MASK;
@@ -172,6 +204,67 @@ namespace til
 			for (uint32 i = 0; i < a_Size; i++) { *a_Dst++ = a_Value; }
 		}
 
+		//! Read a little-endian word
+		inline uint32 GetWord(const byte* a_Src)
+		{
+			return (a_Src[1] << 8) | a_Src[0];
+		}
+
+		//! Read a little-endian dword
+		inline uint32 GetDWord(const byte* a_Src)
+		{
+			return ((dword)a_Src[3] << 24) | (a_Src[2] << 16) | (a_Src[1] << 8) | a_Src[0];
+		}
+
+		//! Write a little-endian dword
+		inline void PutDWord(byte* a_Dst, uint32 a_Value)
+		{
+			a_Dst[0] = (byte)(a_Value);
+			a_Dst[1] = (byte)(a_Value >> 8);
+			a_Dst[2] = (byte)(a_Value >> 16);
+			a_Dst[3] = (byte)(a_Value >> 24);
+		}
+
+		//! The start of a 32-bit FNV-1a hash
+		const uint32 g_HashStart = 2166136261U;
+
+		//! Add a byte to a 32-bit FNV-1a hash
+		inline uint32 Hash(uint32 a_Hash, byte a_Value)
+		{
+			return (a_Hash ^ a_Value) * 16777619U;
+		}
+
+		//! Add a dword to a 32-bit FNV-1a hash, lowest byte first
+		inline uint32 HashDWord(uint32 a_Hash, uint32 a_Value)
+		{
+			for (uint32 i = 0; i < 32; i += 8) { a_Hash = Hash(a_Hash, (byte)(a_Value >> i)); }
+			return a_Hash;
+		}
+
+		//! The start of a 64-bit FNV-1a hash
+		const uint64 g_HashStart64 = 14695981039346656037ULL;
+
+		//! Add a byte to a 64-bit FNV-1a hash
+		inline uint64 Hash64(uint64 a_Hash, byte a_Value)
+		{
+			return (a_Hash ^ a_Value) * 1099511628211ULL;
+		}
+
+		//! Add a buffer to a 64-bit FNV-1a hash
+		inline uint64 Hash64(uint64 a_Hash, const void* a_Src, uint32 a_Size)
+		{
+			const byte* src = (const byte*)a_Src;
+			for (uint32 i = 0; i < a_Size; i++) { a_Hash = Hash64(a_Hash, src[i]); }
+			return a_Hash;
+		}
+
+		//! Add a dword to a 64-bit FNV-1a hash, lowest byte first
+		inline uint64 HashDWord64(uint64 a_Hash, uint32 a_Value)
+		{
+			for (uint32 i = 0; i < 32; i += 8) { a_Hash = Hash64(a_Hash, (byte)(a_Value >> i)); }
+			return a_Hash;
+		}
+
 		//@}
 
 	}; // namespace Internal
@@ -146,6 +146,102 @@
 #define TIL_DEPTH_B8G8R8                  0x00060000 //!< 32-bit BGR color depth
 #define TIL_DEPTH_R5G6B5                  0x00070000 //!< 16-bit RGB color depth
 #define TIL_DEPTH_B5G6R5                  0x00080000 //!< 16-bit BGR color depth
+//! Keep the pixel data in the format it was stored in
+/*!
+	No conversion is done. Only supported by formats that store data
+	the way graphics hardware expects it, like compressed DDS textures.
+
+	\code
+	til::ImageDDS* load = (til::ImageDDS*)TIL_Load("media\\texture.dds", TIL_DEPTH_NATIVE | TIL_FILE_ADDWORKINGDIR);
+	\endcode
+*/
+#define TIL_DEPTH_NATIVE                  0x00090000
+
+//! Internal define used to extract load options from the options
+#define TIL_LOAD_MASK                     0xFF000000
+//! Decode frames when they are first requested instead of when loading
+/*!
+	The stored data is read when loading, but frames are only decoded when
+	#til::Image::GetPixels is called for them. Useful for textures with many 
+	levels of detail, of which only a few are needed right away.
+
+	Only supported by formats whose frames can be decoded independently, like DDS and ICO.
+	Other formats ignore this option.
+
+	\code
+	til::Image* load = TIL_Load("media\\texture.dds", TIL_DEPTH_A8B8G8R8 | TIL_LOAD_DEFERRED | TIL_FILE_ADDWORKINGDIR);
+	byte* smallest = load->GetPixels(load->GetFrameCount() - 1);
+	\endcode
+*/
+#define TIL_LOAD_DEFERRED                 0x01000000
+//! Store the rows from the bottom of the image to the top
+/*!
+	OpenGL expects the first row of a texture to be the bottom one. With
+	this option, the rows are written in that order while decoding, so
+	the image doesn't have to be flipped afterwards.
+
+	Supported by TGA, BMP and images scaled down with #TIL_LOAD_SIZE. 
+	Other formats ignore this option.
+*/
+#define TIL_LOAD_BOTTOMUP                 0x02000000
+//! Internal define used to extract the size hint from the options
+#define TIL_LOAD_SIZE_MASK                0xFC000000
+//! Prefer the image closest to a size in pixels
+/*!
+	Meant for thumbnails. Formats that store the same image at several sizes 
+	only decode the image that fits the size best:
+
+	- ICO decodes the closest image when loading and returns it as the first frame.
+	  The other images are decoded when they are requested.
+	- DDS skips the mipmaps larger than needed, without reading them. The smallest 
+	  mipmap whose longest side is at least the size becomes the first frame.
+
+	Other images are scaled down by the largest power of two that keeps their 
+	longest side at least as large as the size. Only the first frame is decoded 
+	and its rows are averaged while they are decoded, so the full size image is 
+	never kept in memory. Images that can't be decoded in order, like run-length 
+	encoded BMP images, are decoded completely first.
+
+	The size is rounded up to a multiple of 8 pixels, up to 504 pixels.
+
+	\code
+	til::Image* load = TIL_Load("media\\icon.ico", TIL_DEPTH_A8B8G8R8 | TIL_LOAD_SIZE(48) | TIL_FILE_ADDWORKINGDIR);
+	til::Image* thumbnail = TIL_Load("media\\photo.png", TIL_DEPTH_A8B8G8R8 | TIL_LOAD_SIZE(128) | TIL_FILE_ADDWORKINGDIR);
+	\endcode
+*/
+#define TIL_LOAD_SIZE(a_Size)             ((((unsigned int)(((a_Size) > 504) ? 504 : (a_Size)) + 7) >> 3) << 26)
+//! Internal define used to get the size hint in pixels from the options
+#define TIL_LOAD_GETSIZE(a_Options)       ((((a_Options) & TIL_LOAD_SIZE_MASK) >> 26) << 3)
+
+//! Average of the pixels that are covered
+/*!
+	Fast, and the best choice for making an image smaller by a whole factor, 
+	like the mipmaps made by #til::TIL_CreateMipMaps.
+*/
+#define TIL_FILTER_BOX                    0x00000001
+//! Linear interpolation between the nearest pixels
+#define TIL_FILTER_BILINEAR               0x00000002
+//! Mitchell-Netravali cubic filter, sharper than bilinear with little ringing
+#define TIL_FILTER_MITCHELL               0x00000003
+//! Lanczos filter with three lobes
+/*!
+	The sharpest of the filters, but edges with a lot of contrast can show ringing.
+*/
+#define TIL_FILTER_LANCZOS                0x00000004
+
+//! DXT1 blocks, with 4 bits per pixel
+/*!
+	Every block of four by four pixels stores two colors and two colors
+	between them. Pixels with an alpha below 128 are stored as transparent
+	black, all others as opaque.
+*/
+#define TIL_COMPRESS_BC1                  0x00000001
+//! DXT5 blocks, with 8 bits per pixel
+/*!
+	The colors are stored like #TIL_COMPRESS_BC1, followed by a block with 
+	eight alpha values for every four by four pixels.
+*/
+#define TIL_COMPRESS_BC3                  0x00000002
 
 //! Determine which formats should be included in compilation.
 /*!
@@ -164,6 +260,21 @@
 	#define TIL_FORMAT                    (TIL_FORMAT_PNG | TIL_FORMAT_GIF | TIL_FORMAT_TGA | TIL_FORMAT_BMP | TIL_FORMAT_ICO | TIL_FORMAT_DDS)
 #endif
 
+//! Whether decoding can be spread over multiple threads
+/*!
+	Define this macro as 0 in the preprocessor definitions to compile without threading.
+
+	Threading is supported on Windows, Windows Mobile, Linux and Android.
+	On other platforms, all work is done on the calling thread.
+*/
+#ifndef TIL_THREADS
+	#if (TIL_PLATFORM == TIL_PLATFORM_PSP)
+		#define TIL_THREADS                   0
+	#else
+		#define TIL_THREADS                   1
+	#endif
+#endif
+
 /*!
 	\def TIL_PRINT_DEBUG
 	\brief Print a debug message
@@ -307,6 +418,28 @@ namespace til
 	*/
 	typedef void (*PitchFunc)(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY);
 
+	//! Row structure
+	struct RowData
+	{
+		byte* pixels;       /**< The rows, at the requested color depth. */
+		uint32 row;         /**< The first row, counted from the top of the image. */
+		uint32 count;       /**< The amount of rows. */
+		uint32 width;       /**< The width of the image. */
+		uint32 height;      /**< The height of the image. */
+		uint32 pitch;       /**< The distance in bytes between two rows. */
+		void* user;         /**< The data passed to #TIL_Decode. */
+	};
+
+	//! Row function
+	/*!
+		\param a_Data The rows that were decoded
+
+		\return True to continue decoding, false to stop
+
+		Used by #TIL_Decode. The pixels are only valid during the call.
+	*/
+	typedef bool (*RowFunc)(RowData* a_Data);
+
 	class FileStream;
 	//! FileStream creation function
 	/*!
@@ -0,0 +1,133 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILThreads.h
+	\brief Internal thread pool
+*/
+
+#ifndef _TILTHREADS_H_
+#define _TILTHREADS_H_
+
+#include "TILSettings.h"
+
+namespace til
+{
+
+	namespace Internal
+	{
+
+		/*!
+			@name Internal
+			These functions are internal and shouldn't be called by developers.
+		*/
+		//@{
+
+		//! A job executed by the thread pool
+		/*!
+			\param a_Data The data passed to #ParallelFor
+			\param a_Index The index of the job, between 0 and the amount of jobs
+		*/
+		typedef void (*JobFunc)(void* a_Data, uint32 a_Index);
+
+		//! Run jobs on the thread pool
+		/*!
+			\param a_Func The job to run
+			\param a_Data Data passed to every job
+			\param a_Count The amount of jobs
+
+			\note Internal method.
+
+			Calls a_Func a_Count times, spread over the worker threads and the calling 
+			thread, and returns when all jobs are done. The jobs must not depend on 
+			each other.
+
+			When the pool is already busy, for instance when called from within a job,
+			the jobs are run on the calling thread.
+		*/
+		extern void ParallelFor(JobFunc a_Func, void* a_Data, uint32 a_Count);
+
+		//! Set the amount of threads, including the calling thread
+		/*!
+			\note Internal method.
+
+			A value of 0 uses the amount of processors.
+		*/
+		extern void SetThreadCount(uint32 a_Count);
+
+		//! Get the amount of threads, including the calling thread
+		extern uint32 GetThreadCount();
+
+		//! Stops the worker threads
+		extern void ShutDownThreads();
+
+		class MutexData;
+
+		//! A lock that can only be held by one thread at a time
+		class Mutex
+		{
+
+		public:
+
+			Mutex();
+			~Mutex();
+
+			void Lock();
+			void Unlock();
+
+		private:
+
+			MutexData* m_Data;
+
+		}; // class Mutex
+
+		class SemaphoreData;
+
+		//! A counter that threads can wait on
+		class Semaphore
+		{
+
+		public:
+
+			Semaphore();
+			~Semaphore();
+
+			//! Increase the count, waking up waiting threads
+			void Post(uint32 a_Count = 1);
+			//! Wait until the count is larger than zero and decrease it
+			void Wait();
+
+		private:
+
+			SemaphoreData* m_Data;
+
+		}; // class Semaphore
+
+		//@}
+
+	}; // namespace Internal
+
+}; // namespace til
+
+#endif
\ No newline at end of file
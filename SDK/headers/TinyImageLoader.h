@@ -34,6 +34,8 @@
 #include "TILSettings.h"
 #include "TILFileStream.h"
 #include "TILImage.h"
+#include "TILImageAtlas.h"
+#include "TILImageCompressed.h"
 
 /*! 
 	\namespace til
@@ -63,6 +65,7 @@ namespace til
 	//! Shuts down TinyImageLoader
 	/*!
 		Makes sure all memory allocated by TinyImageLoader (outside of til::Image objects) is deallocated.
+		Also stops the threads used for decoding.
 	*/
 	void TIL_ShutDown();
 
@@ -84,6 +87,7 @@ namespace til
 		- #TIL_DEPTH_B8G8R8
 		- #TIL_DEPTH_R5G6B5
 		- #TIL_DEPTH_B5G6R5
+		- #TIL_DEPTH_NATIVE (DDS only)
 
 		/code
 		MyStream* stream = new MyStream();
@@ -118,6 +122,7 @@ namespace til
 		- #TIL_DEPTH_B8G8R8
 		- #TIL_DEPTH_R5G6B5
 		- #TIL_DEPTH_B5G6R5
+		- #TIL_DEPTH_NATIVE (DDS only)
 
 		/code
 		til::Image* load = til::TIL_Load("MyFile.png", TIL_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
@@ -125,6 +130,254 @@ namespace til
 	*/
 	Image* TIL_Load(const char* a_FileName, uint32 a_Options = (TIL_FILE_ABSOLUTEPATH | TIL_DEPTH_A8R8G8B8));
 
+	//! Decode an image row by row
+	/*!
+		\param a_Stream A FileStream handle that does file reading.
+		\param a_Options A combination of loading options.
+		\param a_Func Called with every band of decoded rows.
+		\param a_User Passed to a_Func.
+
+		\return True when every row was passed to a_Func, false on failure or when a_Func stopped.
+
+		Instead of keeping the pixels, the rows of the first frame are passed to a_Func 
+		from the top down. Only a few rows are kept in memory at a time, so images 
+		much larger than the available memory can be processed. 
+		
+		BMP, TGA, PNG, GIF and DDS images are decoded a row at a time, or a row of 
+		blocks for compressed DDS images. Images that can't be decoded in order, like 
+		run-length encoded images stored from the bottom up, are decoded completely 
+		first and passed in one call.
+
+		The options are the same as for #TIL_Load. With #TIL_DEPTH_NATIVE, DDS images 
+		pass the stored data and the pitch is the size of a row of blocks.
+
+		\code
+		bool OnRows(til::RowData* a_Data)
+		{
+			Hash* hash = (Hash*)a_Data->user;
+			for (uint32 i = 0; i < a_Data->count; i++)
+			{
+				hash->Add(a_Data->pixels + (i * a_Data->pitch), a_Data->width * 4);
+			}
+			return true;
+		}
+
+		til::TIL_Decode("media\\huge.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR, OnRows, &hash);
+		\endcode
+	*/
+	bool TIL_Decode(FileStream* a_Stream, uint32 a_Options, RowFunc a_Func, void* a_User = NULL);
+
+	//! Decode an image row by row
+	/*!
+		\param a_FileName A string containing a path to an image.
+		\param a_Options A combination of loading options.
+		\param a_Func Called with every band of decoded rows.
+		\param a_User Passed to a_Func.
+
+		\return True when every row was passed to a_Func, false on failure or when a_Func stopped.
+
+		Opens the file the same way as #TIL_Load.
+	*/
+	bool TIL_Decode(const char* a_FileName, uint32 a_Options, RowFunc a_Func, void* a_User = NULL);
+
+	//! Load part of an image
+	/*!
+		\param a_Stream A FileStream handle that does file reading.
+		\param a_Options A combination of loading options.
+		\param a_X The left edge of the region.
+		\param a_Y The top edge of the region.
+		\param a_Width The width of the region, or 0 for the rest of the row.
+		\param a_Height The height of the region, or 0 for the rest of the image.
+
+		\return A til::Image the size of the region, or NULL on failure.
+
+		Decodes only the first frame and only as far as the bottom of the region.
+		Uncompressed BMP, TGA and DDS images read just the rows and columns in the 
+		region and compressed DDS images the blocks covering it. PNG images only 
+		convert the columns in the region. Fails when the region doesn't fit in the 
+		image or when loading with #TIL_DEPTH_NATIVE.
+
+		With #TIL_LOAD_SIZE, the region is scaled down the same way as the whole image
+		would be. For DDS images the region is taken from the mipmap that was picked.
+
+		\code
+		til::Image* tile = til::TIL_LoadRegion("media\\map.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR, 512, 256, 64, 64);
+		\endcode
+	*/
+	Image* TIL_LoadRegion(FileStream* a_Stream, uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height);
+
+	//! Load part of an image
+	/*!
+		\param a_FileName A string containing a path to an image.
+		\param a_Options A combination of loading options.
+		\param a_X The left edge of the region.
+		\param a_Y The top edge of the region.
+		\param a_Width The width of the region, or 0 for the rest of the row.
+		\param a_Height The height of the region, or 0 for the rest of the image.
+
+		\return A til::Image the size of the region, or NULL on failure.
+
+		Opens the file the same way as #TIL_Load.
+	*/
+	Image* TIL_LoadRegion(const char* a_FileName, uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height);
+
+	//! Load many images into a single atlas
+	/*!
+		\param a_Streams FileStream handles of the images.
+		\param a_Count The amount of streams.
+		\param a_Options A combination of loading options.
+		\param a_Width The width of the atlas, or 0 to pick the smallest power of two that makes it about square.
+		\param a_Padding The amount of empty pixels to the right and below every image.
+
+		\return A til::ImageAtlas, or NULL when one of the images could not be loaded. 
+		An error is posted for every image that failed, with its index and path.
+
+		Reads the size of every image, packs them and decodes every image straight 
+		into its place in the atlas, spread over the threads set by #TIL_SetThreadCount. 
+		Only the first frame of every image is used. The atlas is made with the pitch 
+		function set by #TIL_SetPitchFunc, and the texture coordinates of every image 
+		are relative to its pitch.
+
+		The streams have to be able to seek back to their start, because they are read twice.
+		They are closed and deleted like with #TIL_Load.
+
+		\code
+		const char* icons[] = { "media\\play.png", "media\\stop.png", "media\\pause.tga" };
+		til::ImageAtlas* atlas = til::TIL_LoadAtlas(icons, 3, TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		const til::AtlasRect* stop = atlas->GetRect(1);
+		DrawQuad(texture, stop->u0, stop->v0, stop->u1, stop->v1);
+		\endcode
+	*/
+	ImageAtlas* TIL_LoadAtlas(FileStream** a_Streams, uint32 a_Count, uint32 a_Options, uint32 a_Width = 0, uint32 a_Padding = 1);
+
+	//! Load many images into a single atlas
+	/*!
+		\param a_FileNames Paths to the images.
+		\param a_Count The amount of paths.
+		\param a_Options A combination of loading options.
+		\param a_Width The width of the atlas, or 0 to pick the smallest power of two that makes it about square.
+		\param a_Padding The amount of empty pixels to the right and below every image.
+
+		\return A til::ImageAtlas, or NULL when one of the images could not be loaded. 
+		An error is posted for every image that failed, with its index and path.
+
+		Opens the files the same way as #TIL_Load.
+	*/
+	ImageAtlas* TIL_LoadAtlas(const char** a_FileNames, uint32 a_Count, uint32 a_Options, uint32 a_Width = 0, uint32 a_Padding = 1);
+
+	//! Resize a frame of an image
+	/*!
+		\param a_Image A loaded image.
+		\param a_Width The new width.
+		\param a_Height The new height.
+		\param a_Filter The filter to use, like #TIL_FILTER_LANCZOS.
+		\param a_Frame The frame to resize.
+
+		\return A til::Image with the resized frame, or NULL on failure.
+
+		The image keeps its color depth. Images loaded with #TIL_DEPTH_NATIVE 
+		can't be resized. a_Image isn't changed and can be released afterwards.
+
+		\code
+		til::Image* load = til::TIL_Load("media\\photo.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		til::Image* half = til::TIL_Resize(load, load->GetWidth() / 2, load->GetHeight() / 2, TIL_FILTER_MITCHELL);
+		til::TIL_Release(load);
+		\endcode
+	*/
+	Image* TIL_Resize(Image* a_Image, uint32 a_Width, uint32 a_Height, uint32 a_Filter = TIL_FILTER_LANCZOS, uint32 a_Frame = 0);
+
+	//! Create the mipmaps of a frame of an image
+	/*!
+		\param a_Image A loaded image.
+		\param a_Filter The filter to use, like #TIL_FILTER_BOX.
+		\param a_Frame The frame to start from.
+
+		\return A til::Image with a frame for every mipmap, or NULL on failure.
+
+		Meant for formats that don't store mipmaps, like PNG, TGA and BMP. The first 
+		frame is a copy of a_Frame and every next frame is half the size of the one 
+		before it, down to a single pixel, like the mipmaps of a DDS image.
+
+		\code
+		til::Image* load = til::TIL_Load("media\\texture.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		til::Image* mipmaps = til::TIL_CreateMipMaps(load);
+		for (uint32 i = 0; i < mipmaps->GetFrameCount(); i++)
+		{
+			UploadTexture(texture, i, mipmaps->GetPixels(i));
+		}
+		\endcode
+	*/
+	Image* TIL_CreateMipMaps(Image* a_Image, uint32 a_Filter = TIL_FILTER_BOX, uint32 a_Frame = 0);
+
+	//! Resize pixels
+	/*!
+		\param a_Dst The pixels to write to.
+		\param a_DstWidth The width to resize to.
+		\param a_DstHeight The height to resize to.
+		\param a_DstPitch The distance in bytes between two rows of a_Dst.
+		\param a_Src The pixels to resize.
+		\param a_SrcWidth The width of a_Src.
+		\param a_SrcHeight The height of a_Src.
+		\param a_SrcPitch The distance in bytes between two rows of a_Src.
+		\param a_Depth The color depth of both, like #TIL_DEPTH_A8R8G8B8.
+		\param a_Filter The filter to use, like #TIL_FILTER_LANCZOS.
+
+		\return True on success, false on failure.
+
+		For resizing into a buffer of your own. See til::ImageResized::Resample.
+	*/
+	bool TIL_ResizePixels(
+		byte* a_Dst, uint32 a_DstWidth, uint32 a_DstHeight, uint32 a_DstPitch, 
+		byte* a_Src, uint32 a_SrcWidth, uint32 a_SrcHeight, uint32 a_SrcPitch, 
+		uint32 a_Depth, uint32 a_Filter
+	);
+
+	//! Compress an image to DXT blocks
+	/*!
+		\param a_Image A loaded image.
+		\param a_Format The block format, #TIL_COMPRESS_BC1 or #TIL_COMPRESS_BC3.
+
+		\return A til::ImageCompressed with the blocks of every frame, or NULL on failure.
+
+		For turning images like PNG and TGA into textures the graphics card can
+		use without decompressing them, taking four or eight times less memory
+		than 32-bit pixels. The blocks are the same as those of a DDS image loaded
+		with #TIL_DEPTH_NATIVE and can be stored as a DDS file with
+		til::ImageCompressed::WriteDDS. Images loaded with #TIL_DEPTH_NATIVE
+		can't be compressed. a_Image isn't changed and can be released afterwards.
+
+		\code
+		til::Image* load = til::TIL_Load("media\\texture.png", TIL_DEPTH_A8B8G8R8 | TIL_FILE_ADDWORKINGDIR);
+		til::Image* mipmaps = til::TIL_CreateMipMaps(load);
+		til::ImageCompressed* compressed = til::TIL_Compress(mipmaps, TIL_COMPRESS_BC1);
+		for (uint32 i = 0; i < compressed->GetFrameCount(); i++)
+		{
+			UploadCompressedTexture(texture, i, compressed->GetPixels(i), compressed->GetDataSize(i));
+		}
+		\endcode
+	*/
+	ImageCompressed* TIL_Compress(Image* a_Image, uint32 a_Format = TIL_COMPRESS_BC1);
+
+	//! Compress pixels to DXT blocks
+	/*!
+		\param a_Dst The blocks to write to.
+		\param a_Src The pixels to compress.
+		\param a_Width The width of a_Src.
+		\param a_Height The height of a_Src.
+		\param a_Pitch The distance in bytes between two rows of a_Src.
+		\param a_Depth The color depth of a_Src, like #TIL_DEPTH_A8R8G8B8.
+		\param a_Format The block format, #TIL_COMPRESS_BC1 or #TIL_COMPRESS_BC3.
+
+		\return True on success, false on failure.
+
+		For compressing into a buffer of your own. See til::ImageCompressed::CompressPixels.
+	*/
+	bool TIL_CompressPixels(
+		byte* a_Dst, 
+		byte* a_Src, uint32 a_Width, uint32 a_Height, uint32 a_Pitch, 
+		uint32 a_Depth, uint32 a_Format
+	);
+
 	//! Releases the handle to a til::Image
 	/*!
 		\param a_Image The handle to the til::Image
@@ -271,6 +524,26 @@ namespace til
 	*/
 	void TIL_SetPitchFunc(PitchFunc a_Func);
 
+	//! Set the amount of threads used for decoding
+	/*!
+		\param a_Count The amount of threads, including the calling thread
+
+		A value of 0 uses one thread per processor, which is the default. 
+		A value of 1 disables threading, so all decoding is done on the thread 
+		that calls #TIL_Load.
+
+		Only the DDS loader spreads its work over multiple threads at the moment.
+		When TinyImageLoader is compiled with #TIL_THREADS set to 0, this 
+		function does nothing.
+	*/
+	void TIL_SetThreadCount(uint32 a_Count);
+
+	//! Get the amount of threads used for decoding
+	/*!
+		\return The amount of threads, including the calling thread
+	*/
+	uint32 TIL_GetThreadCount();
+
 }; // namespace til
 
 #endif
\ No newline at end of file
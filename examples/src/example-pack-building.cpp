@@ -0,0 +1,106 @@
+#include "TinyImageLoader.h"
+#include "TILArchivePack.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Builds a pack from a list of images, so they can be loaded
+// with til::ArchivePack without decoding them again.
+//
+// example-pack-building <pack> <depth> <image> [<image> ...]
+
+struct DepthName
+{
+	const char* name;
+	unsigned int option;
+};
+
+static DepthName g_Depths[] = {
+	{ "A8R8G8B8", TIL_DEPTH_A8R8G8B8 },
+	{ "A8B8G8R8", TIL_DEPTH_A8B8G8R8 },
+	{ "R8G8B8A8", TIL_DEPTH_R8G8B8A8 },
+	{ "B8G8R8A8", TIL_DEPTH_B8G8R8A8 },
+	{ "R8G8B8",   TIL_DEPTH_R8G8B8 },
+	{ "B8G8R8",   TIL_DEPTH_B8G8R8 },
+	{ "R5G6B5",   TIL_DEPTH_R5G6B5 },
+	{ "B5G6R5",   TIL_DEPTH_B5G6R5 },
+	{ "NATIVE",   TIL_DEPTH_NATIVE },
+	{ NULL, 0 }
+};
+
+void LoggingFunc(til::MessageData* a_Data)
+{
+	fprintf(stderr, "%s\n", a_Data->message);
+}
+
+bool IsDDS(const char* a_Path)
+{
+	size_t length = strlen(a_Path);
+	return (length >= 4 && !strncmp(a_Path + length - 4, ".dds", 4));
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 4)
+	{
+		printf("Usage: %s <pack> <depth> <image> [<image> ...]\n\n", argv[0]);
+		printf("Depths: A8R8G8B8, A8B8G8R8, R8G8B8A8, B8G8R8A8, R8G8B8, B8G8R8, R5G6B5, B5G6R5 or NATIVE.\n");
+		printf("With NATIVE, DDS images keep their compressed blocks and other images are stored as A8B8G8R8.\n");
+		printf("The images are stored under their path as given.\n");
+		return 1;
+	}
+
+	unsigned int depth = 0;
+	for (DepthName* curr = g_Depths; curr->name; curr++)
+	{
+		if (!strcmp(argv[2], curr->name)) { depth = curr->option; }
+	}
+	if (depth == 0)
+	{
+		printf("Unknown depth '%s'.\n", argv[2]);
+		return 1;
+	}
+
+	til::TIL_Init();
+	til::TIL_SetErrorFunc(LoggingFunc);
+
+	til::PackBuilder* builder = new til::PackBuilder();
+	if (!builder->Open(argv[1], TIL_FILE_ABSOLUTEPATH))
+	{
+		delete builder;
+		til::TIL_ShutDown();
+		return 1;
+	}
+
+	int failed = 0;
+	for (int i = 3; i < argc; i++)
+	{
+		unsigned int options = depth;
+		if (depth == TIL_DEPTH_NATIVE && !IsDDS(argv[i])) { options = TIL_DEPTH_A8B8G8R8; }
+
+		if (builder->AddFile(argv[i], TIL_FILE_ABSOLUTEPATH | options))
+		{
+			printf("Added '%s'.\n", argv[i]);
+		}
+		else
+		{
+			printf("Could not add '%s'.\n", argv[i]);
+			failed++;
+		}
+	}
+
+	bool result = builder->Close();
+	delete builder;
+
+	til::TIL_ShutDown();
+
+	if (!result)
+	{
+		printf("Could not write '%s'.\n", argv[1]);
+		return 1;
+	}
+
+	printf("Wrote %i images to '%s'.\n", argc - 3 - failed, argv[1]);
+
+	return (failed > 0) ? 1 : 0;
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "TinyImageLoader.h"
 
+#include <string.h>
+
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 
@@ -34,6 +36,56 @@ namespace TILFW
 
 	}
 
+	int g_Errors = 0;
+
+	void CountError(til::MessageData* a_Data)
+	{
+		g_Errors++;
+	}
+
+	// a region has to match the same rectangle of the whole image
+
+	bool CompareRegion(const char* a_FileName, til::uint32 a_X, til::uint32 a_Y, til::uint32 a_Width, til::uint32 a_Height)
+	{
+		til::Image* load_full = til::TIL_Load(a_FileName, TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
+		til::Image* load_region = til::TIL_LoadRegion(a_FileName, TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8, a_X, a_Y, a_Width, a_Height);
+
+		bool result = (
+			load_full && load_region && 
+			load_region->GetWidth() == a_Width && load_region->GetHeight() == a_Height
+		);
+
+		for (til::uint32 y = 0; result && y < a_Height; y++)
+		{
+			til::byte* src = load_full->GetPixels() + (((a_Y + y) * load_full->GetPitchX()) + a_X) * 4;
+			til::byte* dst = load_region->GetPixels() + (y * load_region->GetPitchX() * 4);
+			result = (memcmp(src, dst, a_Width * 4) == 0);
+		}
+
+		til::TIL_Release(load_full);
+		til::TIL_Release(load_region);
+
+		return result;
+	}
+
+	// a region outside of the image has to fail with a single error
+
+	bool RejectRegion(const char* a_FileName, til::uint32 a_X, til::uint32 a_Y)
+	{
+		g_Errors = 0;
+		til::TIL_SetErrorFunc(CountError);
+
+		til::Image* load_region = til::TIL_LoadRegion(a_FileName, TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8, a_X, a_Y, 0, 0);
+
+		til::TIL_SetErrorFunc(MyError);
+
+		bool result = (!load_region && g_Errors == 1);
+
+		til::TIL_Release(load_region);
+
+		return result;
+	}
+
 #endif
 
 	void Framework::Setup()
@@ -61,12 +113,30 @@ namespace TILFW
 		til::Image* load_png = til::TIL_Load("media\\PNG\\avatar.png", TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
 		til::TIL_Release(load_png);
 
+		if (!RejectRegion("media\\PNG\\avatar.png", 100000, 0))
+		{
+			MessageBoxA(NULL, "Region outside of a PNG wasn't rejected with a single error.", "TinyImageLoader - Tests", MB_OK | MB_ICONERROR);
+		}
+
 		til::Image* load_ico = til::TIL_Load("media\\ICO\\d8eba2bcc1af567ce8f596f3005980dadd13f704.ico", TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
 		til::TIL_Release(load_ico);
 
 		til::Image* load_tga = til::TIL_Load("media\\TGA\\earth.tga", TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
 		til::TIL_Release(load_tga);
 
+		// run-length encoded rows stored from the bottom up can't be passed on 
+		// one at a time, the region is cut from the whole image instead
+
+		if (!CompareRegion("media\\TGA\\earth.tga", 100, 50, 64, 32))
+		{
+			MessageBoxA(NULL, "Region of a run-length encoded TGA doesn't match the full image.", "TinyImageLoader - Tests", MB_OK | MB_ICONERROR);
+		}
+
+		if (!RejectRegion("media\\TGA\\earth.tga", 0, 100000))
+		{
+			MessageBoxA(NULL, "Region outside of a run-length encoded TGA wasn't rejected with a single error.", "TinyImageLoader - Tests", MB_OK | MB_ICONERROR);
+		}
+
 		til::Image* load_dds1 = til::TIL_Load("media\\DDS\\assaultrifle01.dds", TIL_FILE_ADDWORKINGDIR | TIL_DEPTH_A8B8G8R8);
 		til::TIL_Release(load_dds1);
 
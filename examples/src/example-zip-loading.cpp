@@ -2,14 +2,7 @@
 
 #include "TinyImageLoader.h"
 
-extern "C" {
-	#include "unzip.h"
-};
-
-#ifdef WIN32
-	#define USEWIN32IOAPI
-	#include "iowin32.h"
-#endif
+#include "TILArchiveZip.h"
 
 static GLuint* g_Texture;
 static unsigned int g_TextureTotal;
@@ -34,205 +27,6 @@ void LoggingFunc(til::MessageData* a_Data)
 	fclose(g_Log);
 }
 
-class FileStreamZip : public til::FileStream
-{
-
-public:
-
-	FileStreamZip()
-	{
-		m_FilePath = new char[TIL_MAX_PATH];
-
-		m_ByteMax = 8192;
-		m_ByteCurrent = 0;
-		m_ByteTotal = 0;
-		m_Read = new til::byte[m_ByteMax];
-	}
-	~FileStreamZip()
-	{
-		delete m_FilePath;
-		delete m_Read;
-	}
-
-	bool OpenZip(const char* a_Path, til::uint32 a_Options)
-	{
-		m_ZipPath = new char[TIL_MAX_PATH];
-
-		if (a_Options & TIL_FILE_ADDWORKINGDIR)
-		{
-			til::TIL_AddWorkingDirectory(m_ZipPath, TIL_MAX_PATH, a_Path);
-		}
-		else
-		{
-			strcpy(m_ZipPath, a_Path);
-		}
-
-		zlib_filefunc_def ffunc;
-		fill_win32_filefunc(&ffunc);
-		m_ZipFile = unzOpen2(m_ZipPath, &ffunc);
-
-		m_Error = unzGetGlobalInfo(m_ZipFile, &m_ZipGlobalInfo);
-		if (CheckError()) { return false; }
-
-		char filename[256];
-		for (int i = 0; i < m_ZipGlobalInfo.number_entry; i++)
-		{
-			m_Error = unzGetCurrentFileInfo(
-				m_ZipFile, &m_ZipInfo, 
-				filename, 256,
-				NULL, 0,
-				NULL, 0
-			);
-			if (CheckError()) { break; }
-
-			m_Error = unzGoToNextFile(m_ZipFile);
-			if (CheckError()) { break; }
-		}
-
-		m_Error = unzGoToFirstFile(m_ZipFile);
-		if (CheckError()) { return false; }
-
-		return true;
-	}
-
-	bool Open(const char* a_File, til::uint32 a_Options)
-	{
-		m_Error = unzLocateFile(m_ZipFile, a_File, 2);
-		if (m_Error == UNZ_END_OF_LIST_OF_FILE) { return false; }
-
-		m_Error = unzGetCurrentFileInfo(
-			m_ZipFile, &m_ZipInfo, 
-			m_FilePath, 256,
-			NULL, 0, NULL, 0
-		);
-		if (CheckError()) { return false; }
-
-		m_Error = unzOpenCurrentFile(m_ZipFile);
-		if (CheckError()) { return false; }
-
-		// read at least one block first
-		ReadBlock();
-
-		return true;
-	}
-
-	bool Read(void* a_Dst, til::uint32 a_ElementSize, til::uint32 a_Count = 1)
-	{
-		return ReadByte((byte*)a_Dst, a_ElementSize * a_Count);
-	}
-
-	bool ReadByte(til::byte* a_Dst, til::uint32 a_Count = 1)
-	{
-		// the main function for reading data
-		// we read with m_ByteMax bytes at a time from the zip file
-		// if TinyImageLoader requests a byte not yet loaded, 
-		// we load a new block of bytes
-
-		for (til::uint32 i = 0; i < a_Count; i++)
-		{
-			*a_Dst++ = *m_Buffer++;
-
-			if (++m_ByteCurrent == m_ByteTotal) 
-			{ 
-				if (!ReadBlock())
-				{
-					return false; 
-				}
-			}
-		}
-
-		return true;
-	}
-
-	bool ReadWord(til::word* a_Dst, til::uint32 a_Count = 1)
-	{
-		return ReadByte((byte*)a_Dst, 2 * a_Count);
-	}
-
-	bool ReadDWord(til::dword* a_Dst, til::uint32 a_Count = 1)
-	{
-		return ReadByte((byte*)a_Dst, 4 * a_Count);
-	}
-
-	bool Seek(til::uint32 a_Offset, til::uint32 a_Options)
-	{
-		if (a_Options & TIL_FILE_SEEK_CURR)
-		{
-			for (til::uint32 i = 0; i < a_Offset; i++)
-			{
-				if (++m_ByteCurrent == m_ByteTotal) 
-				{ 
-					if (!ReadBlock())
-					{
-						return false; 
-					}
-				}
-			}
-
-			return true;
-		}
-		
-		return false;
-	}
-
-	bool EndOfFile()
-	{
-		return m_EOF;
-	}
-
-	bool Close()
-	{
-		m_Error = unzCloseCurrentFile(m_ZipFile);
-		return !CheckError();
-	}
-
-private:
-
-	bool CheckError()
-	{
-		if (m_Error != UNZ_OK)
-		{
-			return true;
-		}
-
-		return false;
-	}
-
-	bool ReadBlock()
-	{	
-		int found = unzReadCurrentFile(m_ZipFile, m_Read, m_ByteMax);
-		if (found < 0)
-		{
-			CheckError();
-			return false;
-		}
-		else if (found > 0)
-		{
-			m_Buffer = m_Read;
-			m_ByteCurrent = 0;
-			m_ByteTotal = found;
-		}
-
-		return true;
-	}
-
-	int m_ByteCurrent, m_ByteTotal;
-	unsigned int m_ByteMax;
-	til::byte* m_Read;
-	til::byte* m_Buffer;
-
-	bool m_EOF;
-
-	char* m_ZipPath;
-	char m_FileName[256];
-	unzFile m_ZipFile;
-	unz_file_info m_ZipInfo;
-	unz_global_info m_ZipGlobalInfo;
-
-	int m_Error;
-
-};
-
 void CouldNotLoad()
 {
 	char msg[256];
@@ -265,13 +59,17 @@ namespace TILFW
 
 		// reading from a zip
 
-		FileStreamZip* stream = new FileStreamZip();
-		stream->OpenZip("media\\ZIP\\zipped.zip", TIL_FILE_ADDWORKINGDIR);
-		if (!stream->Open("zipped/rolypolypandap1.gif", TIL_FILE_ADDWORKINGDIR)) { CouldNotLoad(); }
+		til::ArchiveZip* archive = new til::ArchiveZip();
+		if (!archive->Open("media\\ZIP\\zipped.zip", TIL_FILE_ADDWORKINGDIR)) { CouldNotLoad(); }
+
+		til::FileStream* stream = archive->OpenFile("zipped/rolypolypandap1.gif");
+		if (!stream) { CouldNotLoad(); }
 
 		g_Load = til::TIL_Load(stream, TIL_DEPTH_A8B8G8R8);
 		if (!g_Load) { CouldNotLoad(); }
 
+		delete archive;
+
 		glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			glOrtho(0, s_WindowWidth, s_WindowHeight, 0, -1, 1);
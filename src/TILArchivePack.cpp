@@ -0,0 +1,771 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILArchivePack.cpp
+*/
+
+#include "TILArchivePack.h"
+#include "TILInternal.h"
+#include "TinyImageLoader.h"
+
+#if (TIL_FORMAT & TIL_FORMAT_DDS)
+	#include "TILImageDDS.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+	All values are stored as little-endian dwords.
+
+	header:       magic, version, image count, frame count, 
+	              offset of the image table, offset of the frame table,
+	              offset of the names, size of the names
+	pixel data:   every frame, aligned to 16 bytes
+	image table:  sorted by hash
+	              hash, name offset, name length, first frame, frame count, 
+	              color depth, FourCC, block size, delay in microseconds
+	frame table:  width, height, pitch x, pitch y, depth, slice pitch, size, offset
+	names:        forward slashes only, every name is followed by a zero
+*/
+
+#define PACK_MAGIC                     0x504C4954 // "TILP"
+#define PACK_VERSION                   1
+
+#define PACK_HEADER_SIZE               32
+#define PACK_IMAGE_SIZE                36
+#define PACK_FRAME_SIZE                32
+
+#define PACK_ALIGN                     16
+
+#define PACK_NOT_FOUND                 0xFFFFFFFF
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	// names are compared with forward slashes
+	static inline char PACK_GetChar(const char* a_Src)
+	{
+		return (*a_Src == '\\') ? '/' : *a_Src;
+	}
+
+	static uint32 PACK_Hash(const char* a_Name, uint32 a_Length)
+	{
+		uint32 hash = Internal::g_HashStart;
+		for (uint32 i = 0; i < a_Length; i++)
+		{
+			hash = Internal::Hash(hash, (byte)PACK_GetChar(a_Name + i));
+		}
+		return hash;
+	}
+
+	template <typename T>
+	static void PACK_Reserve(T*& a_Data, uint32 a_Total, uint32& a_Max, uint32 a_Count)
+	{
+		if (a_Total + a_Count <= a_Max) { return; }
+
+		uint32 max = (a_Max < 16) ? 16 : a_Max;
+		while (max < a_Total + a_Count) { max *= 2; }
+
+		T* data = new T[max];
+		if (a_Data)
+		{
+			memcpy(data, a_Data, a_Total * sizeof(T));
+			delete [] a_Data;
+		}
+
+		a_Data = data;
+		a_Max = max;
+	}
+
+#endif
+
+	// =========================================
+	// ImagePack
+	// =========================================
+
+	ImagePack::ImagePack() : Image()
+	{
+		m_Data = NULL;
+		m_Frames = NULL;
+		m_FrameTotal = 0;
+		m_FourCC = 0;
+		m_BlockSize = 0;
+		m_Delay = 0.f;
+		m_Owner = NULL;
+	}
+
+	ImagePack::~ImagePack()
+	{
+		if (m_Owner) { delete m_Owner; }
+	}
+
+	bool ImagePack::Parse(uint32 /*a_Options*/)
+	{
+		return true;
+	}
+
+	uint32 ImagePack::GetFrameCount()
+	{
+		return m_FrameTotal;
+	}
+
+	float ImagePack::GetDelay()
+	{
+		return m_Delay;
+	}
+
+	byte* ImagePack::GetPixels(uint32 a_Frame /*= 0*/)
+	{
+		if (a_Frame >= m_FrameTotal) { return NULL; }
+
+		return m_Data + Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 28);
+	}
+
+	uint32 ImagePack::GetWidth(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE);
+	}
+
+	uint32 ImagePack::GetHeight(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 4);
+	}
+
+	uint32 ImagePack::GetPitchX(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 8);
+	}
+
+	uint32 ImagePack::GetPitchY(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 12);
+	}
+
+	uint32 ImagePack::GetDepth(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 16);
+	}
+
+	uint32 ImagePack::GetSlicePitch(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 20);
+	}
+
+	uint32 ImagePack::GetDataSize(uint32 a_Frame /*= 0*/)
+	{
+		return Internal::GetDWord(m_Frames + a_Frame * PACK_FRAME_SIZE + 24);
+	}
+
+	uint32 ImagePack::GetFourCC()
+	{
+		return m_FourCC;
+	}
+
+	uint32 ImagePack::GetBlockSize()
+	{
+		return m_BlockSize;
+	}
+
+	// =========================================
+	// ArchivePack
+	// =========================================
+
+	ArchivePack::ArchivePack()
+	{
+		m_Stream = NULL;
+		m_Data = NULL;
+		m_Size = 0;
+
+		m_Images = NULL;
+		m_ImageTotal = 0;
+		m_Frames = NULL;
+		m_FrameTotal = 0;
+		m_Names = NULL;
+		m_NamesSize = 0;
+	}
+
+	ArchivePack::~ArchivePack()
+	{
+		Close();
+	}
+
+	bool ArchivePack::Open(const char* a_Path, uint32 a_Options)
+	{
+		FileStreamMapped* stream = new FileStreamMapped();
+		if (!stream->Open(a_Path, a_Options & TIL_FILE_MASK))
+		{
+			TIL_ERROR_EXPLAIN("Could not find pack '%s'.", a_Path);
+			delete stream;
+			return false;
+		}
+
+		if (!Open(stream->GetData(), stream->GetSize()))
+		{
+			delete stream;
+			return false;
+		}
+
+		m_Stream = stream;
+
+		return true;
+	}
+
+	bool ArchivePack::Open(byte* a_Data, uint32 a_Size)
+	{
+		Close();
+
+		if (!a_Data || a_Size < PACK_HEADER_SIZE || Internal::GetDWord(a_Data) != PACK_MAGIC)
+		{
+			TIL_ERROR_EXPLAIN("Data is not a pack.");
+			return false;
+		}
+
+		uint32 version = Internal::GetDWord(a_Data + 4);
+		if (version != PACK_VERSION)
+		{
+			TIL_ERROR_EXPLAIN("Unsupported pack version: %i", version);
+			return false;
+		}
+
+		uint32 image_total = Internal::GetDWord(a_Data + 8);
+		uint32 frame_total = Internal::GetDWord(a_Data + 12);
+		uint32 image_offset = Internal::GetDWord(a_Data + 16);
+		uint32 frame_offset = Internal::GetDWord(a_Data + 20);
+		uint32 names_offset = Internal::GetDWord(a_Data + 24);
+		uint32 names_size = Internal::GetDWord(a_Data + 28);
+
+		TIL_PRINT_DEBUG("Pack: %i images, %i frames", image_total, frame_total);
+
+		if (
+			image_offset > a_Size || image_total > (a_Size - image_offset) / PACK_IMAGE_SIZE ||
+			frame_offset > a_Size || frame_total > (a_Size - frame_offset) / PACK_FRAME_SIZE ||
+			names_offset > a_Size || names_size > a_Size - names_offset
+		)
+		{
+			TIL_ERROR_EXPLAIN("Invalid pack index.");
+			return false;
+		}
+
+		m_Data = a_Data;
+		m_Size = a_Size;
+
+		m_Images = m_Data + image_offset;
+		m_ImageTotal = image_total;
+		m_Frames = m_Data + frame_offset;
+		m_FrameTotal = frame_total;
+		m_Names = (char*)(m_Data + names_offset);
+		m_NamesSize = names_size;
+
+		return true;
+	}
+
+	void ArchivePack::Close()
+	{
+		if (m_Stream)
+		{
+			delete m_Stream;
+			m_Stream = NULL;
+		}
+
+		m_Data = NULL;
+		m_Size = 0;
+
+		m_Images = NULL;
+		m_ImageTotal = 0;
+		m_Frames = NULL;
+		m_FrameTotal = 0;
+		m_Names = NULL;
+		m_NamesSize = 0;
+	}
+
+	ImagePack* ArchivePack::Load(const char* a_Name)
+	{
+		uint32 index = Find(a_Name);
+		if (index == PACK_NOT_FOUND)
+		{
+			TIL_ERROR_EXPLAIN("Could not find '%s' in pack.", a_Name);
+			return NULL;
+		}
+
+		return Load(index);
+	}
+
+	ImagePack* ArchivePack::Load(uint32 a_Index)
+	{
+		if (a_Index >= m_ImageTotal) { return NULL; }
+
+		byte* src = m_Images + a_Index * PACK_IMAGE_SIZE;
+
+		uint32 frame = Internal::GetDWord(src + 12);
+		uint32 frame_count = Internal::GetDWord(src + 16);
+		uint32 depth = Internal::GetDWord(src + 20);
+
+		if (frame_count == 0 || frame > m_FrameTotal || frame_count > m_FrameTotal - frame)
+		{
+			TIL_ERROR_EXPLAIN("Invalid frames for image %i in pack.", a_Index);
+			return NULL;
+		}
+
+		uint32 bpp = Internal::GetBPP(depth);
+		uint32 fourcc = Internal::GetDWord(src + 24);
+		uint32 block = Internal::GetDWord(src + 28);
+
+		// the pixels are only checked against the size of the pack 
+		// and the size of the frame, not read
+
+		byte* frames = m_Frames + frame * PACK_FRAME_SIZE;
+		for (uint32 i = 0; i < frame_count; i++)
+		{
+			byte* data = frames + i * PACK_FRAME_SIZE;
+
+			uint32 width = Internal::GetDWord(data);
+			uint32 height = Internal::GetDWord(data + 4);
+			uint32 pitch_x = Internal::GetDWord(data + 8);
+			uint32 pitch_y = Internal::GetDWord(data + 12);
+			uint32 slices = Internal::GetDWord(data + 16);
+			uint32 slice = Internal::GetDWord(data + 20);
+			uint32 size = Internal::GetDWord(data + 24);
+			uint32 offset = Internal::GetDWord(data + 28);
+
+			// native data is stored in blocks of 4x4 pixels or as whole pixels
+			uint64 needed = (uint64)pitch_x * pitch_y * bpp;
+			if (bpp == 0 && fourcc != 0)
+			{
+				needed = (uint64)((width + 3) / 4) * ((height + 3) / 4) * block;
+			}
+			else if (bpp == 0)
+			{
+				needed = (uint64)width * height * block;
+			}
+
+			if (
+				offset > m_Size || size > m_Size - offset ||
+				(bpp > 0 && (pitch_x < width || pitch_y < height)) ||
+				slices == 0 || slice < needed || (uint64)slice * slices > size
+			)
+			{
+				TIL_ERROR_EXPLAIN("Invalid frame %i for image %i in pack.", i, a_Index);
+				return NULL;
+			}
+		}
+
+		ImagePack* result = new ImagePack();
+		if (!result->SetBPP(depth << 16))
+		{
+			TIL_ERROR_EXPLAIN("Unknown color depth for image %i in pack: %i", a_Index, depth);
+			delete result;
+			return NULL;
+		}
+
+		result->m_Data = m_Data;
+		result->m_Frames = frames;
+		result->m_FrameTotal = frame_count;
+		result->m_FourCC = fourcc;
+		result->m_BlockSize = block;
+		result->m_Delay = (float)Internal::GetDWord(src + 32) / 1000000.f;
+
+		return result;
+	}
+
+	uint32 ArchivePack::GetImageCount()
+	{
+		return m_ImageTotal;
+	}
+
+	const char* ArchivePack::GetImageName(uint32 a_Index)
+	{
+		if (a_Index >= m_ImageTotal) { return NULL; }
+
+		byte* src = m_Images + a_Index * PACK_IMAGE_SIZE;
+		uint32 name = Internal::GetDWord(src + 4);
+		uint32 length = Internal::GetDWord(src + 8);
+
+		if (name >= m_NamesSize || length >= m_NamesSize - name || m_Names[name + length] != 0) 
+		{ 
+			return NULL; 
+		}
+
+		return m_Names + name;
+	}
+
+	uint32 ArchivePack::Find(const char* a_Name)
+	{
+		uint32 length = strlen(a_Name);
+		uint32 hash = PACK_Hash(a_Name, length);
+
+		// first image with the hash
+
+		uint32 low = 0;
+		uint32 high = m_ImageTotal;
+		while (low < high)
+		{
+			uint32 middle = low + (high - low) / 2;
+			if (Internal::GetDWord(m_Images + middle * PACK_IMAGE_SIZE) < hash)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		for (uint32 i = low; i < m_ImageTotal; i++)
+		{
+			if (Internal::GetDWord(m_Images + i * PACK_IMAGE_SIZE) != hash) { break; }
+
+			const char* name = GetImageName(i);
+			if (!name || Internal::GetDWord(m_Images + i * PACK_IMAGE_SIZE + 8) != length) { continue; }
+
+			uint32 j = 0;
+			while (j < length && name[j] == PACK_GetChar(a_Name + j)) { j++; }
+			if (j == length) { return i; }
+		}
+
+		return PACK_NOT_FOUND;
+	}
+
+	// =========================================
+	// PackBuilder
+	// =========================================
+
+	PackBuilder::PackBuilder()
+	{
+		m_Handle = NULL;
+		m_Position = 0;
+		m_Failed = false;
+
+		m_Entries = NULL;
+		m_EntryTotal = m_EntryMax = 0;
+		m_Frames = NULL;
+		m_FrameTotal = m_FrameMax = 0;
+		m_Names = NULL;
+		m_NamesSize = m_NamesMax = 0;
+	}
+
+	PackBuilder::~PackBuilder()
+	{
+		Close();
+	}
+
+	bool PackBuilder::Open(const char* a_Path, uint32 a_Options)
+	{
+		Close();
+
+		char path[TIL_MAX_PATH] = { 0 };
+
+		if (a_Options & TIL_FILE_ADDWORKINGDIR)
+		{
+			TIL_AddWorkingDirectory(path, TIL_MAX_PATH, a_Path);
+		}
+		else
+		{
+			strncpy(path, a_Path, TIL_MAX_PATH - 1);
+		}
+
+		m_Handle = fopen(path, "wb");
+		if (!m_Handle)
+		{
+			TIL_ERROR_EXPLAIN("Could not create pack '%s'.", path);
+			return false;
+		}
+
+		m_Position = 0;
+		m_Failed = false;
+
+		// filled in when the pack is closed
+		byte header[PACK_HEADER_SIZE] = { 0 };
+
+		return Write(header, PACK_HEADER_SIZE);
+	}
+
+	bool PackBuilder::AddImage(const char* a_Name, Image* a_Image)
+	{
+		if (!m_Handle || m_Failed)
+		{
+			TIL_ERROR_EXPLAIN("Pack is not open.");
+			return false;
+		}
+
+		if (!a_Name || !a_Image) { return false; }
+
+		uint32 length = strlen(a_Name);
+		uint32 frame_count = a_Image->GetFrameCount();
+		if (length == 0 || frame_count == 0)
+		{
+			TIL_ERROR_EXPLAIN("Image '%s' has no name or no frames.", a_Name);
+			return false;
+		}
+
+		EntryPack entry;
+		entry.hash = PACK_Hash(a_Name, length);
+		entry.name = m_NamesSize;
+		entry.length = length;
+		entry.frame = m_FrameTotal;
+		entry.frame_count = frame_count;
+		entry.depth = a_Image->GetBitDepth();
+		entry.fourcc = 0;
+		entry.block = 0;
+		entry.delay = (uint32)(a_Image->GetDelay() * 1000000.f + 0.5f);
+		entry.text = NULL;
+
+		// recognized the same way as by TIL_Load
+		Image* dds = NULL;
+
+#if (TIL_FORMAT & TIL_FORMAT_DDS)
+		if (length >= 4 && !strncmp(a_Name + length - 4, ".dds", 4)) 
+		{ 
+			dds = a_Image;
+			if (entry.depth == Image::BPP_NATIVE)
+			{
+				entry.fourcc = ((ImageDDS*)dds)->GetFourCC();
+				entry.block = ((ImageDDS*)dds)->GetBlockSize();
+			}
+		}
+#endif
+
+		if (entry.depth == Image::BPP_NATIVE && !dds)
+		{
+			TIL_ERROR_EXPLAIN("Only DDS images can be stored with their native color depth.");
+			return false;
+		}
+
+		uint32 bpp = Internal::GetBPP(entry.depth);
+
+		PACK_Reserve(m_Frames, m_FrameTotal, m_FrameMax, frame_count);
+
+		for (uint32 i = 0; i < frame_count; i++)
+		{
+			FramePack* frame = &m_Frames[m_FrameTotal + i];
+
+			byte* pixels = a_Image->GetPixels(i);
+			if (!pixels)
+			{
+				TIL_ERROR_EXPLAIN("Could not get frame %i of '%s'.", i, a_Name);
+				return false;
+			}
+
+			frame->width = a_Image->GetWidth(i);
+			frame->height = a_Image->GetHeight(i);
+			frame->pitchx = a_Image->GetPitchX(i);
+			frame->pitchy = a_Image->GetPitchY(i);
+			frame->depth = 1;
+			frame->slice = frame->pitchx * frame->pitchy * bpp;
+			frame->size = frame->slice;
+
+#if (TIL_FORMAT & TIL_FORMAT_DDS)
+			if (dds)
+			{
+				frame->depth = ((ImageDDS*)dds)->GetDepth(i);
+				frame->slice = ((ImageDDS*)dds)->GetSlicePitch(i);
+				frame->size = ((ImageDDS*)dds)->GetDataSize(i);
+			}
+#endif
+
+			if (!Align()) { return false; }
+			frame->offset = m_Position;
+			if (!Write(pixels, frame->size)) { return false; }
+		}
+
+		m_FrameTotal += frame_count;
+
+		// names are stored with forward slashes and a zero at the end
+
+		PACK_Reserve(m_Names, m_NamesSize, m_NamesMax, length + 1);
+		for (uint32 i = 0; i < length; i++)
+		{
+			m_Names[m_NamesSize++] = PACK_GetChar(a_Name + i);
+		}
+		m_Names[m_NamesSize++] = 0;
+
+		PACK_Reserve(m_Entries, m_EntryTotal, m_EntryMax, 1);
+		m_Entries[m_EntryTotal++] = entry;
+
+		TIL_PRINT_DEBUG("Pack: Added '%s' with %i frames", a_Name, frame_count);
+
+		return true;
+	}
+
+	bool PackBuilder::AddFile(const char* a_Path, uint32 a_Options)
+	{
+		Image* load = TIL_Load(a_Path, a_Options);
+		if (!load) { return false; }
+
+		bool result = AddImage(a_Path, load);
+		TIL_Release(load);
+
+		return result;
+	}
+
+	bool PackBuilder::Close()
+	{
+		if (!m_Handle) { return false; }
+
+		bool result = !m_Failed;
+
+		if (result)
+		{
+			for (uint32 i = 0; i < m_EntryTotal; i++)
+			{
+				m_Entries[i].text = m_Names + m_Entries[i].name;
+			}
+
+			qsort(m_Entries, m_EntryTotal, sizeof(EntryPack), CompareEntries);
+
+			for (uint32 i = 1; i < m_EntryTotal; i++)
+			{
+				if (CompareEntries(&m_Entries[i - 1], &m_Entries[i]) == 0)
+				{
+					TIL_ERROR_EXPLAIN("'%s' was added to the pack twice.", m_Entries[i].text);
+					result = false;
+					break;
+				}
+			}
+		}
+
+		if (result)
+		{
+			byte record[PACK_IMAGE_SIZE];
+
+			Align();
+
+			uint32 image_offset = m_Position;
+			for (uint32 i = 0; i < m_EntryTotal; i++)
+			{
+				EntryPack* entry = &m_Entries[i];
+
+				Internal::PutDWord(record +  0, entry->hash);
+				Internal::PutDWord(record +  4, entry->name);
+				Internal::PutDWord(record +  8, entry->length);
+				Internal::PutDWord(record + 12, entry->frame);
+				Internal::PutDWord(record + 16, entry->frame_count);
+				Internal::PutDWord(record + 20, entry->depth);
+				Internal::PutDWord(record + 24, entry->fourcc);
+				Internal::PutDWord(record + 28, entry->block);
+				Internal::PutDWord(record + 32, entry->delay);
+				Write(record, PACK_IMAGE_SIZE);
+			}
+
+			uint32 frame_offset = m_Position;
+			for (uint32 i = 0; i < m_FrameTotal; i++)
+			{
+				FramePack* frame = &m_Frames[i];
+
+				Internal::PutDWord(record +  0, frame->width);
+				Internal::PutDWord(record +  4, frame->height);
+				Internal::PutDWord(record +  8, frame->pitchx);
+				Internal::PutDWord(record + 12, frame->pitchy);
+				Internal::PutDWord(record + 16, frame->depth);
+				Internal::PutDWord(record + 20, frame->slice);
+				Internal::PutDWord(record + 24, frame->size);
+				Internal::PutDWord(record + 28, frame->offset);
+				Write(record, PACK_FRAME_SIZE);
+			}
+
+			uint32 names_offset = m_Position;
+			Write(m_Names, m_NamesSize);
+
+			byte header[PACK_HEADER_SIZE];
+			Internal::PutDWord(header +  0, PACK_MAGIC);
+			Internal::PutDWord(header +  4, PACK_VERSION);
+			Internal::PutDWord(header +  8, m_EntryTotal);
+			Internal::PutDWord(header + 12, m_FrameTotal);
+			Internal::PutDWord(header + 16, image_offset);
+			Internal::PutDWord(header + 20, frame_offset);
+			Internal::PutDWord(header + 24, names_offset);
+			Internal::PutDWord(header + 28, m_NamesSize);
+
+			// the header is written last, so an unfinished pack can't be opened
+
+			if (!m_Failed && fflush(m_Handle) == 0 && fseek(m_Handle, 0, SEEK_SET) == 0)
+			{
+				result = (fwrite(header, PACK_HEADER_SIZE, 1, m_Handle) == 1);
+			}
+			else
+			{
+				result = false;
+			}
+		}
+
+		if (fclose(m_Handle) != 0) { result = false; }
+		m_Handle = NULL;
+
+		if (m_Entries) { delete [] m_Entries; }
+		m_Entries = NULL;
+		m_EntryTotal = m_EntryMax = 0;
+		if (m_Frames) { delete [] m_Frames; }
+		m_Frames = NULL;
+		m_FrameTotal = m_FrameMax = 0;
+		if (m_Names) { delete [] m_Names; }
+		m_Names = NULL;
+		m_NamesSize = m_NamesMax = 0;
+
+		return result;
+	}
+
+	bool PackBuilder::Write(const void* a_Src, uint32 a_Size)
+	{
+		if (m_Failed) { return false; }
+
+		if (a_Size > 0xFFFFFFFF - PACK_ALIGN - m_Position)
+		{
+			TIL_ERROR_EXPLAIN("Pack can't be larger than 4 GB.");
+			m_Failed = true;
+			return false;
+		}
+
+		if (a_Size > 0 && fwrite(a_Src, a_Size, 1, m_Handle) != 1)
+		{
+			TIL_ERROR_EXPLAIN("Could not write to pack.");
+			m_Failed = true;
+			return false;
+		}
+
+		m_Position += a_Size;
+
+		return true;
+	}
+
+	bool PackBuilder::Align()
+	{
+		static const byte zero[PACK_ALIGN] = { 0 };
+		return Write(zero, (PACK_ALIGN - (m_Position & (PACK_ALIGN - 1))) & (PACK_ALIGN - 1));
+	}
+
+	int PackBuilder::CompareEntries(const void* a_Left, const void* a_Right)
+	{
+		const EntryPack* left = (const EntryPack*)a_Left;
+		const EntryPack* right = (const EntryPack*)a_Right;
+
+		if (left->hash != right->hash) { return (left->hash < right->hash) ? -1 : 1; }
+		if (left->length != right->length) { return (left->length < right->length) ? -1 : 1; }
+
+		return memcmp(left->text, right->text, left->length);
+	}
+
+}; // namespace til
\ No newline at end of file
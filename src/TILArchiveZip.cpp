@@ -0,0 +1,565 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	http://www.pkware.com/documents/casestudies/APPNOTE.TXT
+	
+	\file TILArchiveZip.cpp
+*/
+
+#include "TILArchiveZip.h"
+#include "TILInternal.h"
+
+#if (TIL_FORMAT & TIL_FORMAT_PNG)
+	#include "TILImagePNG.h"
+#endif
+
+#include <string.h>
+
+#if (TIL_RUN_TARGET == TIL_TARGET_DEVEL)
+	#define ZIP_DEBUG(msg, ...)        TIL_PRINT_DEBUG("ZIP: "msg, ##__VA_ARGS__)
+#else
+	#define ZIP_DEBUG(msg, ...)
+#endif
+
+#define ZIP_SIG_LOCAL                  0x04034b50
+#define ZIP_SIG_CENTRAL                0x02014b50
+#define ZIP_SIG_END                    0x06054b50
+
+#define ZIP_METHOD_STORED              0
+#define ZIP_METHOD_DEFLATED            8
+
+#define ZIP_FLAG_ENCRYPTED             0x0001
+
+// largest file that is inflated in memory
+#define ZIP_MAX_SIZE                   0x10000000
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	// paths are compared with forward slashes
+	static inline char ZIP_GetChar(const char* a_Src)
+	{
+		return (*a_Src == '\\') ? '/' : *a_Src;
+	}
+
+	static uint32 ZIP_Hash(const char* a_Name, uint32 a_Length)
+	{
+		uint32 hash = Internal::g_HashStart;
+		for (uint32 i = 0; i < a_Length; i++)
+		{
+			hash = Internal::Hash(hash, (byte)ZIP_GetChar(a_Name + i));
+		}
+		return hash;
+	}
+
+#endif
+
+	// =========================================
+	// ArchiveZip
+	// =========================================
+
+	ArchiveZip::ArchiveZip()
+	{
+		m_Stream = NULL;
+		m_Size = 0;
+		m_Position = 0;
+
+		m_Entries = NULL;
+		m_EntryTotal = 0;
+		m_Names = NULL;
+		m_Table = NULL;
+		m_TableMask = 0;
+	}
+
+	ArchiveZip::~ArchiveZip()
+	{
+		Close();
+	}
+
+	bool ArchiveZip::Open(const char* a_Path, uint32 a_Options)
+	{
+		FileStream* stream = Internal::OpenStream(a_Path, a_Options & TIL_FILE_MASK);
+		if (!stream)
+		{
+			TIL_ERROR_EXPLAIN("Could not find archive '%s'.", a_Path);
+			return false;
+		}
+
+		return Open(stream);
+	}
+
+	bool ArchiveZip::Open(FileStream* a_Stream)
+	{
+		Close();
+
+		m_Stream = a_Stream;
+		m_Size = m_Stream->GetSize();
+		m_Position = 0xFFFFFFFF;
+
+		ZIP_DEBUG("Size: %i", m_Size);
+
+		// the end of central directory record is followed by a comment 
+		// of at most 65535 bytes
+
+		uint32 tail = (m_Size > 22 + 0xFFFF) ? 22 + 0xFFFF : m_Size;
+		if (tail < 22)
+		{
+			TIL_ERROR_EXPLAIN("Archive is too small or its size is unknown.");
+			Close();
+			return false;
+		}
+
+		byte* data = new byte[tail];
+		if (!ReadAt(m_Size - tail, data, tail))
+		{
+			TIL_ERROR_EXPLAIN("Could not read end of archive.");
+			delete [] data;
+			Close();
+			return false;
+		}
+
+		byte* end = NULL;
+		for (uint32 i = tail - 22 + 1; i > 0; i--)
+		{
+			if (Internal::GetDWord(data + i - 1) == ZIP_SIG_END) 
+			{ 
+				end = data + i - 1; 
+				break; 
+			}
+		}
+
+		if (!end)
+		{
+			TIL_ERROR_EXPLAIN("Could not find central directory.");
+			delete [] data;
+			Close();
+			return false;
+		}
+
+		uint32 count = Internal::GetWord(end + 10);
+		uint32 directory_size = Internal::GetDWord(end + 12);
+		uint32 directory_offset = Internal::GetDWord(end + 16);
+
+		delete [] data;
+
+		ZIP_DEBUG("Files: %i", count);
+		ZIP_DEBUG("Central directory: %i bytes at %i", directory_size, directory_offset);
+
+		if (count == 0xFFFF || directory_offset == 0xFFFFFFFF)
+		{
+			TIL_ERROR_EXPLAIN("ZIP64 archives are not supported.");
+			Close();
+			return false;
+		}
+
+		if (directory_offset > m_Size || directory_size > m_Size - directory_offset || directory_size < count * 46)
+		{
+			TIL_ERROR_EXPLAIN("Invalid central directory: %i bytes at %i", directory_size, directory_offset);
+			Close();
+			return false;
+		}
+
+		// the directory is read in one go and only the names are kept
+
+		data = new byte[directory_size];
+		if (!ReadAt(directory_offset, data, directory_size))
+		{
+			TIL_ERROR_EXPLAIN("Could not read central directory.");
+			delete [] data;
+			Close();
+			return false;
+		}
+
+		m_Entries = new EntryZip[count];
+		m_Names = new char[directory_size + count];
+		m_EntryTotal = 0;
+
+		byte* src = data;
+		byte* src_end = data + directory_size;
+		char* name = m_Names;
+		bool valid = true;
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (src_end - src < 46 || Internal::GetDWord(src) != ZIP_SIG_CENTRAL)
+			{
+				TIL_ERROR_EXPLAIN("Invalid header for file %i.", i);
+				valid = false;
+				break;
+			}
+
+			uint32 name_length = Internal::GetWord(src + 28);
+			uint32 extra_length = Internal::GetWord(src + 30);
+			uint32 comment_length = Internal::GetWord(src + 32);
+
+			if ((uint32)(src_end - src) < 46 + name_length + extra_length + comment_length)
+			{
+				TIL_ERROR_EXPLAIN("Header for file %i is incomplete.", i);
+				valid = false;
+				break;
+			}
+
+			// directories are stored as empty files with a slash at the end
+			byte* path = src + 46;
+			if (name_length > 0 && (path[name_length - 1] == '/' || path[name_length - 1] == '\\'))
+			{
+				src += 46 + name_length + extra_length + comment_length;
+				continue;
+			}
+
+			EntryZip* cur = &m_Entries[m_EntryTotal++];
+
+			cur->flags           = Internal::GetWord(src + 8);
+			cur->method          = Internal::GetWord(src + 10);
+			cur->size_compressed = Internal::GetDWord(src + 20);
+			cur->size            = Internal::GetDWord(src + 24);
+			cur->offset          = Internal::GetDWord(src + 42);
+
+			memcpy(name, path, name_length);
+			name[name_length] = 0;
+			cur->name = (uint32)(name - m_Names);
+			cur->hash = ZIP_Hash(name, name_length);
+			name += name_length + 1;
+
+			src += 46 + name_length + extra_length + comment_length;
+		}
+
+		delete [] data;
+
+		if (!valid)
+		{
+			Close();
+			return false;
+		}
+
+		// open addressing, with the table at most half full
+
+		uint32 table_size = 16;
+		while (table_size < m_EntryTotal * 2) { table_size <<= 1; }
+
+		m_TableMask = table_size - 1;
+		m_Table = new uint32[table_size];
+		memset(m_Table, 0, table_size * sizeof(uint32));
+
+		for (uint32 i = 0; i < m_EntryTotal; i++)
+		{
+			uint32 slot = m_Entries[i].hash & m_TableMask;
+			while (m_Table[slot] != 0) { slot = (slot + 1) & m_TableMask; }
+			m_Table[slot] = i + 1;
+		}
+
+		return true;
+	}
+
+	void ArchiveZip::Close()
+	{
+		if (m_Stream)
+		{
+			m_Stream->Close();
+			if (!m_Stream->IsReusable()) { delete m_Stream; }
+			m_Stream = NULL;
+		}
+
+		if (m_Entries) { delete [] m_Entries; }
+		if (m_Names) { delete [] m_Names; }
+		if (m_Table) { delete [] m_Table; }
+
+		m_Entries = NULL;
+		m_Names = NULL;
+		m_Table = NULL;
+		m_EntryTotal = 0;
+		m_Size = 0;
+	}
+
+	FileStream* ArchiveZip::OpenFile(const char* a_Name)
+	{
+		FileStreamZip* result = new FileStreamZip(this);
+		if (result->Open(a_Name, 0)) { return result; }
+
+		delete result;
+		return NULL;
+	}
+
+	uint32 ArchiveZip::GetFileCount()
+	{
+		return m_EntryTotal;
+	}
+
+	const char* ArchiveZip::GetFileName(uint32 a_Index)
+	{
+		if (a_Index >= m_EntryTotal) { return NULL; }
+		return m_Names + m_Entries[a_Index].name;
+	}
+
+	ArchiveZip::EntryZip* ArchiveZip::Find(const char* a_Name)
+	{
+		if (!m_Table) { return NULL; }
+
+		uint32 length = (uint32)strlen(a_Name);
+		uint32 hash = ZIP_Hash(a_Name, length);
+
+		for (uint32 slot = hash & m_TableMask; m_Table[slot] != 0; slot = (slot + 1) & m_TableMask)
+		{
+			EntryZip* cur = &m_Entries[m_Table[slot] - 1];
+			if (cur->hash != hash) { continue; }
+
+			const char* name = m_Names + cur->name;
+
+			uint32 i = 0;
+			while (i < length && name[i] == ZIP_GetChar(a_Name + i)) { i++; }
+			if (i == length && name[i] == 0) { return cur; }
+		}
+
+		return NULL;
+	}
+
+	bool ArchiveZip::ReadAt(uint32 a_Offset, byte* a_Dst, uint32 a_Count)
+	{
+		m_Lock.Lock();
+
+		// streams reading one after another don't need a seek
+		if (a_Offset != m_Position)
+		{
+			m_Stream->Seek(a_Offset, TIL_FILE_SEEK_START);
+		}
+
+		bool result = m_Stream->ReadByte(a_Dst, a_Count);
+		m_Position = (result) ? a_Offset + a_Count : 0xFFFFFFFF;
+
+		m_Lock.Unlock();
+
+		return result;
+	}
+
+	// =========================================
+	// FileStreamZip
+	// =========================================
+
+	FileStreamZip::FileStreamZip(ArchiveZip* a_Archive) : FileStream()
+	{
+		m_FilePath = NULL;
+		m_Archive = a_Archive;
+		m_Data = NULL;
+		m_Offset = 0;
+		m_Size = 0;
+		m_Position = 0;
+	}
+
+	FileStreamZip::~FileStreamZip()
+	{
+		Close();
+		if (m_FilePath) { delete [] m_FilePath; }
+	}
+
+	bool FileStreamZip::Open(const char* a_File, uint32 /*a_Options*/)
+	{
+		Close();
+
+		if (m_FilePath) { delete [] m_FilePath; }
+		m_FilePath = new char[strlen(a_File) + 1];
+		strcpy(m_FilePath, a_File);
+
+		ArchiveZip::EntryZip* entry = m_Archive->Find(a_File);
+		if (!entry)
+		{
+			TIL_ERROR_EXPLAIN("Could not find '%s' in archive.", a_File);
+			return false;
+		}
+
+		if (entry->flags & ZIP_FLAG_ENCRYPTED)
+		{
+			TIL_ERROR_EXPLAIN("Encrypted files are not supported.");
+			return false;
+		}
+
+		// the local header can have a different amount of extra data
+
+		byte header[30];
+		if (!m_Archive->ReadAt(entry->offset, header, 30) || Internal::GetDWord(header) != ZIP_SIG_LOCAL)
+		{
+			TIL_ERROR_EXPLAIN("Invalid local header for '%s'.", a_File);
+			return false;
+		}
+
+		uint32 offset = entry->offset + 30 + Internal::GetWord(header + 26) + Internal::GetWord(header + 28);
+		if (offset > m_Archive->m_Size || entry->size_compressed > m_Archive->m_Size - offset)
+		{
+			TIL_ERROR_EXPLAIN("Data of '%s' is past the end of the archive.", a_File);
+			return false;
+		}
+
+		ZIP_DEBUG("File: %s", a_File);
+		ZIP_DEBUG("Method: %i", entry->method);
+		ZIP_DEBUG("Size: %i (%i compressed)", entry->size, entry->size_compressed);
+
+		if (entry->method == ZIP_METHOD_STORED)
+		{
+			if (entry->size != entry->size_compressed)
+			{
+				TIL_ERROR_EXPLAIN("Stored file '%s' has two sizes.", a_File);
+				return false;
+			}
+
+			// read straight from the archive
+			m_Offset = offset;
+			m_Size = entry->size;
+
+			return true;
+		}
+		else if (entry->method == ZIP_METHOD_DEFLATED)
+		{
+
+#if (TIL_FORMAT & TIL_FORMAT_PNG)
+
+			if (entry->size > ZIP_MAX_SIZE)
+			{
+				TIL_ERROR_EXPLAIN("File '%s' is too large to inflate: %i", a_File, entry->size);
+				return false;
+			}
+
+			byte* compressed = new byte[entry->size_compressed];
+			if (!m_Archive->ReadAt(offset, compressed, entry->size_compressed))
+			{
+				TIL_ERROR_EXPLAIN("Could not read '%s'.", a_File);
+				delete [] compressed;
+				return false;
+			}
+
+			m_Data = new byte[entry->size];
+			m_Size = entry->size;
+
+			zbuf inflate;
+			bool result = inflate.Inflate(compressed, entry->size_compressed, m_Data, m_Size);
+
+			delete [] compressed;
+
+			if (!result)
+			{
+				TIL_ERROR_EXPLAIN("Could not inflate '%s'.", a_File);
+				Close();
+				return false;
+			}
+
+			return true;
+
+#else
+
+			TIL_ERROR_EXPLAIN("Can't inflate files without PNG loader.");
+			return false;
+
+#endif
+
+		}
+
+		TIL_ERROR_EXPLAIN("Unhandled compression method: %i", entry->method);
+		return false;
+	}
+
+	bool FileStreamZip::Read(void* a_Dst, uint32 a_Size, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, a_Size * a_Count);
+	}
+
+	bool FileStreamZip::ReadByte(byte* a_Dst, uint32 a_Count)
+	{
+		uint32 left = m_Size - m_Position;
+		uint32 count = (a_Count > left) ? left : a_Count;
+
+		bool result = true;
+		if (m_Data)
+		{
+			memcpy(a_Dst, m_Data + m_Position, count);
+		}
+		else if (count > 0)
+		{
+			result = m_Archive->ReadAt(m_Offset + m_Position, a_Dst, count);
+		}
+		m_Position += count;
+
+		return (result && count == a_Count);
+	}
+
+	bool FileStreamZip::ReadWord(word* a_Dst, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, sizeof(word) * a_Count);
+	}
+
+	bool FileStreamZip::ReadDWord(dword* a_Dst, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, sizeof(dword) * a_Count);
+	}
+
+	bool FileStreamZip::Seek(uint32 a_Bytes, uint32 a_Options)
+	{
+		uint32 position = m_Position;
+
+		if (a_Options & TIL_FILE_SEEK_START) 
+		{ 
+			position = a_Bytes;
+		}
+		else if (a_Options & TIL_FILE_SEEK_CURR) 
+		{ 
+			position = (a_Bytes > m_Size - m_Position) ? m_Size + 1 : m_Position + a_Bytes;
+		}
+		else if (a_Options & TIL_FILE_SEEK_END) 
+		{ 
+			position = (a_Bytes > 0) ? m_Size + 1 : m_Size;
+		}
+
+		if (position > m_Size)
+		{
+			m_Position = m_Size;
+			return false;
+		}
+
+		m_Position = position;
+
+		return true;
+	}
+
+	bool FileStreamZip::EndOfFile()
+	{
+		return (m_Position >= m_Size);
+	}
+
+	uint32 FileStreamZip::GetSize()
+	{
+		return m_Size;
+	}
+
+	bool FileStreamZip::Close()
+	{
+		if (m_Data) { delete [] m_Data; }
+		m_Data = NULL;
+		m_Offset = 0;
+		m_Size = 0;
+		m_Position = 0;
+
+		return true;
+	}
+
+}; // namespace til
\ No newline at end of file
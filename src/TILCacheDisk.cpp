@@ -0,0 +1,635 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILCacheDisk.cpp
+*/
+
+#include "TILCacheDisk.h"
+#include "TILArchivePack.h"
+#include "TILFileStreamMemory.h"
+#include "TILInternal.h"
+#include "TinyImageLoader.h"
+
+#if (TIL_PLATFORM == TIL_PLATFORM_WINDOWS)
+	#define TIL_CACHE_STAT_WINDOWS
+	#include <sys/types.h>
+	#include <sys/stat.h>
+#elif (TIL_PLATFORM == TIL_PLATFORM_LINUX || TIL_PLATFORM == TIL_PLATFORM_ANDROID)
+	#define TIL_CACHE_STAT_POSIX
+	#include <sys/types.h>
+	#include <sys/stat.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+	Every image is stored as a pack with a single image, named after the key.
+
+	The list of files is stored in the same directory, as little-endian dwords:
+
+	header:       magic, version, number of images, last tick
+	images:       key (low dword first), size of the pack, tick of the last use
+*/
+
+#define CACHE_MAGIC                    0x434C4954 // "TILC"
+#define CACHE_VERSION                  1
+
+#define CACHE_INDEX                    "index.tilcache"
+#define CACHE_INDEX_TEMP               "index.tilcache.tmp"
+
+#define CACHE_NOT_FOUND                0xFFFFFFFF
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	static void CACHE_GetFullPath(char* a_Dst, const char* a_Path, uint32 a_Options)
+	{
+		memset(a_Dst, 0, TIL_MAX_PATH);
+
+		if (a_Options & TIL_FILE_ADDWORKINGDIR)
+		{
+			TIL_AddWorkingDirectory(a_Dst, TIL_MAX_PATH, a_Path);
+		}
+		else
+		{
+			strncpy(a_Dst, a_Path, TIL_MAX_PATH - 1);
+		}
+	}
+
+#endif
+
+	CacheDisk::CacheDisk()
+	{
+		m_Directory = NULL;
+		m_MaxSize = 0;
+		m_Size = 0;
+		m_Key = KEY_CONTENT;
+
+		m_Entries = NULL;
+		m_EntryTotal = m_EntryMax = 0;
+		m_Table = NULL;
+		m_TableMask = 0;
+		m_Tick = 0;
+		m_Temp = 0;
+	}
+
+	CacheDisk::~CacheDisk()
+	{
+		Close();
+	}
+
+	bool CacheDisk::Open(const char* a_Directory, uint32 a_Options, uint64 a_MaxSize, KeyType a_Key /*= KEY_CONTENT*/)
+	{
+		Close();
+
+		char path[TIL_MAX_PATH];
+		CACHE_GetFullPath(path, a_Directory, a_Options);
+
+		// room for the names of the files
+		size_t length = strlen(path);
+		if (length == 0 || length > TIL_MAX_PATH - 32)
+		{
+			TIL_ERROR_EXPLAIN("Invalid cache directory '%s'.", path);
+			return false;
+		}
+
+		m_Directory = new char[length + 2];
+		strcpy(m_Directory, path);
+		if (path[length - 1] != '/' && path[length - 1] != '\\')
+		{
+			m_Directory[length] = '/';
+			m_Directory[length + 1] = 0;
+		}
+
+		m_MaxSize = a_MaxSize;
+		m_Key = a_Key;
+
+		m_Lock.Lock();
+
+		// a missing list is an empty cache
+		LoadIndex();
+		Evict();
+
+		// also tells whether the directory can be written to
+		bool result = SaveIndex();
+
+		m_Lock.Unlock();
+
+		if (!result)
+		{
+			TIL_ERROR_EXPLAIN("Could not write to cache directory '%s'.", m_Directory);
+			Close();
+			return false;
+		}
+
+		TIL_PRINT_DEBUG("Cache: %i images, %i bytes", m_EntryTotal, (uint32)m_Size);
+
+		return true;
+	}
+
+	void CacheDisk::Close()
+	{
+		if (!m_Directory) { return; }
+
+		m_Lock.Lock();
+		SaveIndex();
+		m_Lock.Unlock();
+
+		delete [] m_Directory;
+		m_Directory = NULL;
+
+		if (m_Entries) { delete [] m_Entries; }
+		m_Entries = NULL;
+		m_EntryTotal = m_EntryMax = 0;
+		if (m_Table) { delete [] m_Table; }
+		m_Table = NULL;
+		m_TableMask = 0;
+
+		m_Size = 0;
+		m_Tick = 0;
+	}
+
+	Image* CacheDisk::Load(const char* a_FileName, uint32 a_Options)
+	{
+		if (!m_Directory)
+		{
+			TIL_ERROR_EXPLAIN("Cache is not open.");
+			return NULL;
+		}
+
+		uint64 key;
+		byte* data = NULL;
+		uint32 size = 0;
+
+		// files that can't be read are left to TIL_Load to report
+		if (!GetKey(a_FileName, a_Options, key, data, size))
+		{
+			return TIL_Load(a_FileName, a_Options);
+		}
+
+		Image* result = Find(key);
+		if (result)
+		{
+			TIL_PRINT_DEBUG("Cache: Found '%s'", a_FileName);
+
+			if (data) { delete [] data; }
+			return result;
+		}
+
+		// the contents were already read to make the key
+
+		if (data)
+		{
+			FileStreamMemory* stream = new FileStreamMemory();
+			stream->SetData(data, size);
+			stream->Open(a_FileName, TIL_FILE_ABSOLUTEPATH);
+
+			result = TIL_Load(stream, a_Options);
+
+			delete [] data;
+		}
+		else
+		{
+			result = TIL_Load(a_FileName, a_Options);
+		}
+
+		if (result) { Store(key, a_FileName, result); }
+
+		return result;
+	}
+
+	uint64 CacheDisk::GetSize()
+	{
+		return m_Size;
+	}
+
+	uint32 CacheDisk::GetImageCount()
+	{
+		return m_EntryTotal;
+	}
+
+	bool CacheDisk::GetKey(const char* a_FileName, uint32 a_Options, uint64& a_Key, byte*& a_Data, uint32& a_Size)
+	{
+		uint64 key = Internal::g_HashStart64;
+
+		key = Internal::HashDWord64(key, m_Key);
+		key = Internal::HashDWord64(key, a_Options & (TIL_DEPTH_MASK | TIL_LOAD_MASK));
+
+		// the extension decides how the file is loaded
+		uint32 length = strlen(a_FileName);
+		uint32 extension = (length > 4) ? 4 : length;
+		key = Internal::Hash64(key, a_FileName + length - extension, extension);
+
+#if defined(TIL_CACHE_STAT_WINDOWS) || defined(TIL_CACHE_STAT_POSIX)
+
+		if (m_Key == KEY_PATH)
+		{
+			char path[TIL_MAX_PATH];
+			CACHE_GetFullPath(path, a_FileName, a_Options & TIL_FILE_MASK);
+
+	#if defined(TIL_CACHE_STAT_WINDOWS)
+			struct _stat info;
+			int found = _stat(path, &info);
+	#else
+			struct stat info;
+			int found = stat(path, &info);
+	#endif
+
+			if (found == 0)
+			{
+				uint64 size = (uint64)info.st_size;
+				uint64 time = (uint64)info.st_mtime;
+
+				key = Internal::Hash64(key, path, strlen(path));
+				key = Internal::HashDWord64(key, (uint32)(size & 0xFFFFFFFF));
+				key = Internal::HashDWord64(key, (uint32)(size >> 32));
+				key = Internal::HashDWord64(key, (uint32)(time & 0xFFFFFFFF));
+				key = Internal::HashDWord64(key, (uint32)(time >> 32));
+
+				a_Key = key;
+				a_Data = NULL;
+				a_Size = 0;
+
+				return true;
+			}
+		}
+
+#endif
+
+		FileStream* stream = Internal::OpenStream(a_FileName, a_Options & TIL_FILE_MASK);
+		if (!stream) { return false; }
+
+		uint32 size = stream->GetSize();
+		byte* data = NULL;
+
+		if (size > 0)
+		{
+			data = new byte[size];
+			if (!stream->ReadByte(data, size))
+			{
+				delete [] data;
+				data = NULL;
+			}
+		}
+
+		stream->Close();
+		if (!stream->IsReusable()) { delete stream; }
+
+		if (!data)
+		{
+			TIL_ERROR_EXPLAIN("Could not read '%s' for the cache.", a_FileName);
+			return false;
+		}
+
+		key = Internal::Hash64(key, data, size);
+		key = Internal::HashDWord64(key, size);
+
+		a_Key = key;
+		a_Data = data;
+		a_Size = size;
+
+		return true;
+	}
+
+	Image* CacheDisk::Find(uint64 a_Key)
+	{
+		m_Lock.Lock();
+
+		uint32 index = Lookup(a_Key);
+		if (index != CACHE_NOT_FOUND) { m_Entries[index].tick = ++m_Tick; }
+
+		m_Lock.Unlock();
+
+		if (index == CACHE_NOT_FOUND) { return NULL; }
+
+		char path[TIL_MAX_PATH];
+		GetPath(path, a_Key, ".tilpack");
+
+		ArchivePack* pack = new ArchivePack();
+		ImagePack* result = NULL;
+
+		if (pack->Open(path, TIL_FILE_ABSOLUTEPATH)) 
+		{ 
+			result = pack->Load((uint32)0); 
+		}
+
+		// stored with a different pitch function
+
+		if (result && result->GetBitDepth() != Image::BPP_NATIVE)
+		{
+			for (uint32 i = 0; i < result->GetFrameCount(); i++)
+			{
+				uint32 pitchx = 0;
+				uint32 pitchy = 0;
+				Internal::GetPitch(result->GetWidth(i), result->GetHeight(i), result->m_BPP, pitchx, pitchy);
+
+				if (pitchx != result->GetPitchX(i) || pitchy != result->GetPitchY(i))
+				{
+					TIL_PRINT_DEBUG("Cache: Pitch changed, decoding again", 0);
+
+					delete result;
+					result = NULL;
+					break;
+				}
+			}
+		}
+
+		if (!result)
+		{
+			delete pack;
+			return NULL;
+		}
+
+		// the pack is closed when the image is released
+		result->m_Owner = pack;
+
+		return result;
+	}
+
+	void CacheDisk::Store(uint64 a_Key, const char* a_FileName, Image* a_Image)
+	{
+		char path[TIL_MAX_PATH];
+		GetPath(path, a_Key, ".tilpack");
+
+		// written under another name first, so a pack is either complete or missing
+
+		m_Lock.Lock();
+		uint32 temp_index = m_Temp++;
+		m_Lock.Unlock();
+
+		char extension[32];
+		sprintf(extension, ".%lu.tmp", (unsigned long)temp_index);
+
+		char temp[TIL_MAX_PATH];
+		GetPath(temp, a_Key, extension);
+
+		PackBuilder* builder = new PackBuilder();
+		bool result = builder->Open(temp, TIL_FILE_ABSOLUTEPATH) && builder->AddImage(a_FileName, a_Image);
+		result = builder->Close() && result;
+		delete builder;
+
+		long size = 0;
+		if (result)
+		{
+			FILE* handle = fopen(temp, "rb");
+			if (handle)
+			{
+				fseek(handle, 0, SEEK_END);
+				size = ftell(handle);
+				fclose(handle);
+			}
+		}
+
+		if (size <= 0)
+		{
+			TIL_ERROR_EXPLAIN("Could not store '%s' in the cache.", a_FileName);
+			remove(temp);
+			return;
+		}
+
+		remove(path);
+		if (rename(temp, path) != 0)
+		{
+			TIL_ERROR_EXPLAIN("Could not store '%s' in the cache.", a_FileName);
+			remove(temp);
+			return;
+		}
+
+		m_Lock.Lock();
+
+		Insert(a_Key, (uint32)size);
+		Evict();
+		SaveIndex();
+
+		m_Lock.Unlock();
+
+		TIL_PRINT_DEBUG("Cache: Stored '%s' (%i bytes)", a_FileName, (uint32)size);
+	}
+
+	uint32 CacheDisk::Lookup(uint64 a_Key)
+	{
+		if (!m_Table) { return CACHE_NOT_FOUND; }
+
+		uint32 slot = (uint32)((a_Key ^ (a_Key >> 32)) & m_TableMask);
+		while (m_Table[slot] != CACHE_NOT_FOUND)
+		{
+			if (m_Entries[m_Table[slot]].key == a_Key) { return m_Table[slot]; }
+			slot = (slot + 1) & m_TableMask;
+		}
+
+		return CACHE_NOT_FOUND;
+	}
+
+	void CacheDisk::Insert(uint64 a_Key, uint32 a_Size)
+	{
+		uint32 index = Lookup(a_Key);
+		if (index != CACHE_NOT_FOUND)
+		{
+			m_Size -= m_Entries[index].size;
+			m_Entries[index].size = a_Size;
+			m_Entries[index].tick = ++m_Tick;
+			m_Size += a_Size;
+
+			return;
+		}
+
+		if (m_EntryTotal == m_EntryMax)
+		{
+			uint32 max = (m_EntryMax < 16) ? 16 : m_EntryMax * 2;
+
+			EntryCache* entries = new EntryCache[max];
+			if (m_Entries)
+			{
+				memcpy(entries, m_Entries, m_EntryTotal * sizeof(EntryCache));
+				delete [] m_Entries;
+			}
+
+			m_Entries = entries;
+			m_EntryMax = max;
+		}
+
+		EntryCache* entry = &m_Entries[m_EntryTotal++];
+		entry->key = a_Key;
+		entry->size = a_Size;
+		entry->tick = ++m_Tick;
+		m_Size += a_Size;
+
+		// the table is kept at most half full
+
+		if (m_EntryTotal * 2 > m_TableMask + 1 || !m_Table)
+		{
+			BuildTable();
+		}
+		else
+		{
+			uint32 slot = (uint32)((a_Key ^ (a_Key >> 32)) & m_TableMask);
+			while (m_Table[slot] != CACHE_NOT_FOUND) { slot = (slot + 1) & m_TableMask; }
+			m_Table[slot] = m_EntryTotal - 1;
+		}
+	}
+
+	void CacheDisk::Evict()
+	{
+		bool removed = false;
+
+		while (m_Size > m_MaxSize && m_EntryTotal > 0)
+		{
+			// the tick wraps around, so compare how long ago they were used
+			uint32 oldest = 0;
+			for (uint32 i = 1; i < m_EntryTotal; i++)
+			{
+				if (m_Tick - m_Entries[i].tick > m_Tick - m_Entries[oldest].tick) { oldest = i; }
+			}
+
+			char path[TIL_MAX_PATH];
+			GetPath(path, m_Entries[oldest].key, ".tilpack");
+			remove(path);
+
+			TIL_PRINT_DEBUG("Cache: Removed %s", path);
+
+			m_Size -= m_Entries[oldest].size;
+			m_Entries[oldest] = m_Entries[--m_EntryTotal];
+			removed = true;
+		}
+
+		if (removed) { BuildTable(); }
+	}
+
+	void CacheDisk::BuildTable()
+	{
+		uint32 table_size = 16;
+		while (table_size < m_EntryTotal * 2) { table_size *= 2; }
+
+		if (!m_Table || table_size != m_TableMask + 1)
+		{
+			if (m_Table) { delete [] m_Table; }
+			m_Table = new uint32[table_size];
+			m_TableMask = table_size - 1;
+		}
+
+		for (uint32 i = 0; i < table_size; i++) { m_Table[i] = CACHE_NOT_FOUND; }
+
+		for (uint32 i = 0; i < m_EntryTotal; i++)
+		{
+			uint64 key = m_Entries[i].key;
+			uint32 slot = (uint32)((key ^ (key >> 32)) & m_TableMask);
+			while (m_Table[slot] != CACHE_NOT_FOUND) { slot = (slot + 1) & m_TableMask; }
+			m_Table[slot] = i;
+		}
+	}
+
+	bool CacheDisk::LoadIndex()
+	{
+		char path[TIL_MAX_PATH];
+		sprintf(path, "%s%s", m_Directory, CACHE_INDEX);
+
+		FILE* handle = fopen(path, "rb");
+		if (!handle) { return false; }
+
+		byte header[16];
+		if (
+			fread(header, 16, 1, handle) != 1 || 
+			Internal::GetDWord(header) != CACHE_MAGIC || 
+			Internal::GetDWord(header + 4) != CACHE_VERSION
+		)
+		{
+			TIL_PRINT_DEBUG("Cache: Ignoring invalid list of files", 0);
+			fclose(handle);
+			return false;
+		}
+
+		uint32 count = Internal::GetDWord(header + 8);
+
+		byte record[16];
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (fread(record, 16, 1, handle) != 1) { break; }
+
+			uint64 key = ((uint64)Internal::GetDWord(record + 4) << 32) | Internal::GetDWord(record);
+			Insert(key, Internal::GetDWord(record + 8));
+			m_Entries[Lookup(key)].tick = Internal::GetDWord(record + 12);
+		}
+
+		m_Tick = Internal::GetDWord(header + 12);
+
+		fclose(handle);
+
+		return true;
+	}
+
+	bool CacheDisk::SaveIndex()
+	{
+		char path[TIL_MAX_PATH];
+		sprintf(path, "%s%s", m_Directory, CACHE_INDEX);
+		char temp[TIL_MAX_PATH];
+		sprintf(temp, "%s%s", m_Directory, CACHE_INDEX_TEMP);
+
+		FILE* handle = fopen(temp, "wb");
+		if (!handle) { return false; }
+
+		byte header[16];
+		Internal::PutDWord(header, CACHE_MAGIC);
+		Internal::PutDWord(header + 4, CACHE_VERSION);
+		Internal::PutDWord(header + 8, m_EntryTotal);
+		Internal::PutDWord(header + 12, m_Tick);
+		bool result = (fwrite(header, 16, 1, handle) == 1);
+
+		byte record[16];
+		for (uint32 i = 0; i < m_EntryTotal && result; i++)
+		{
+			Internal::PutDWord(record, (uint32)(m_Entries[i].key & 0xFFFFFFFF));
+			Internal::PutDWord(record + 4, (uint32)(m_Entries[i].key >> 32));
+			Internal::PutDWord(record + 8, m_Entries[i].size);
+			Internal::PutDWord(record + 12, m_Entries[i].tick);
+			result = (fwrite(record, 16, 1, handle) == 1);
+		}
+
+		if (fclose(handle) != 0) { result = false; }
+
+		if (result)
+		{
+			remove(path);
+			result = (rename(temp, path) == 0);
+		}
+
+		if (!result) { remove(temp); }
+
+		return result;
+	}
+
+	void CacheDisk::GetPath(char* a_Dst, uint64 a_Key, const char* a_Extension)
+	{
+		sprintf(
+			a_Dst, "%s%08lx%08lx%s", 
+			m_Directory, 
+			(unsigned long)(a_Key >> 32), (unsigned long)(a_Key & 0xFFFFFFFF), 
+			a_Extension
+		);
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -0,0 +1,379 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILCacheMemory.cpp
+*/
+
+#include "TILCacheMemory.h"
+#include "TILInternal.h"
+#include "TinyImageLoader.h"
+
+#include <string.h>
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	static uint32 CACHE_HashName(const char* a_Name, uint32 a_Options)
+	{
+		uint32 hash = Internal::g_HashStart;
+		for (const char* src = a_Name; *src; src++)
+		{
+			hash = Internal::Hash(hash, (byte)*src);
+		}
+		return Internal::HashDWord(hash, a_Options);
+	}
+
+#endif
+
+	// =========================================
+	// ImageShared
+	// =========================================
+
+	ImageShared::ImageShared() : Image()
+	{
+		m_Cache = NULL;
+		m_Entry = NULL;
+		m_Image = NULL;
+	}
+
+	ImageShared::~ImageShared()
+	{
+		if (m_Cache) { m_Cache->Release(m_Entry); }
+	}
+
+	bool ImageShared::Parse(uint32 /*a_Options*/)
+	{
+		return true;
+	}
+
+	uint32 ImageShared::GetFrameCount()
+	{
+		return m_Image->GetFrameCount();
+	}
+
+	float ImageShared::GetDelay()
+	{
+		return m_Image->GetDelay();
+	}
+
+	byte* ImageShared::GetPixels(uint32 a_Frame /*= 0*/)
+	{
+		return m_Image->GetPixels(a_Frame);
+	}
+
+	uint32 ImageShared::GetWidth(uint32 a_Frame /*= 0*/)
+	{
+		return m_Image->GetWidth(a_Frame);
+	}
+
+	uint32 ImageShared::GetHeight(uint32 a_Frame /*= 0*/)
+	{
+		return m_Image->GetHeight(a_Frame);
+	}
+
+	uint32 ImageShared::GetPitchX(uint32 a_Frame /*= 0*/)
+	{
+		return m_Image->GetPitchX(a_Frame);
+	}
+
+	uint32 ImageShared::GetPitchY(uint32 a_Frame /*= 0*/)
+	{
+		return m_Image->GetPitchY(a_Frame);
+	}
+
+	uint32 ImageShared::GetDataSize(uint32 a_Frame /*= 0*/)
+	{
+		return m_Image->GetDataSize(a_Frame);
+	}
+
+	Image* ImageShared::GetImage()
+	{
+		return m_Image;
+	}
+
+	// =========================================
+	// CacheMemory
+	// =========================================
+
+	CacheMemory::CacheMemory(uint64 a_MaxSize)
+	{
+		m_MaxSize = a_MaxSize;
+		m_Size = 0;
+		m_EntryTotal = 0;
+
+		m_TableMask = 63;
+		m_Table = new EntryShared*[m_TableMask + 1];
+		memset(m_Table, 0, (m_TableMask + 1) * sizeof(EntryShared*));
+		m_Newest = NULL;
+		m_Oldest = NULL;
+	}
+
+	CacheMemory::~CacheMemory()
+	{
+		Clear();
+
+		delete [] m_Table;
+	}
+
+	void CacheMemory::SetMaxSize(uint64 a_MaxSize)
+	{
+		m_Lock.Lock();
+
+		m_MaxSize = a_MaxSize;
+		Evict();
+
+		m_Lock.Unlock();
+	}
+
+	Image* CacheMemory::Load(const char* a_FileName, uint32 a_Options)
+	{
+		return Load(a_FileName, NULL, a_Options);
+	}
+
+	Image* CacheMemory::Load(FileStream* a_Stream, uint32 a_Options)
+	{
+		if (!a_Stream) { return NULL; }
+
+		// without a path there's nothing to find it by
+		const char* name = a_Stream->GetFilePath();
+		if (!name) { return TIL_Load(a_Stream, a_Options); }
+
+		return Load(name, a_Stream, a_Options);
+	}
+
+	void CacheMemory::Clear()
+	{
+		m_Lock.Lock();
+
+		EntryShared* entry = m_Oldest;
+		while (entry)
+		{
+			EntryShared* newer = entry->newer;
+			if (entry->references == 0) { Remove(entry); }
+			entry = newer;
+		}
+
+		m_Lock.Unlock();
+	}
+
+	uint64 CacheMemory::GetSize()
+	{
+		return m_Size;
+	}
+
+	uint32 CacheMemory::GetImageCount()
+	{
+		return m_EntryTotal;
+	}
+
+	Image* CacheMemory::Load(const char* a_Name, FileStream* a_Stream, uint32 a_Options)
+	{
+		uint32 hash = CACHE_HashName(a_Name, a_Options);
+
+		m_Lock.Lock();
+
+		EntryShared* entry = Find(a_Name, a_Options, hash);
+		if (entry)
+		{
+			entry->references++;
+
+			// wait for the thread that's loading it
+			if (entry->loading)
+			{
+				entry->waiting++;
+
+				m_Lock.Unlock();
+				entry->ready.Wait();
+				m_Lock.Lock();
+			}
+		}
+		else
+		{
+			entry = new EntryShared;
+			entry->name = new char[strlen(a_Name) + 1];
+			strcpy(entry->name, a_Name);
+			entry->options = a_Options;
+			entry->hash = hash;
+			entry->image = NULL;
+			entry->size = 0;
+			entry->references = 1;
+			entry->loading = true;
+			entry->waiting = 0;
+
+			// the table has as many buckets as entries at most
+
+			if (m_EntryTotal + 1 > m_TableMask + 1)
+			{
+				uint32 table_size = (m_TableMask + 1) * 2;
+
+				delete [] m_Table;
+				m_Table = new EntryShared*[table_size];
+				memset(m_Table, 0, table_size * sizeof(EntryShared*));
+				m_TableMask = table_size - 1;
+
+				for (EntryShared* curr = m_Newest; curr; curr = curr->older)
+				{
+					curr->next = m_Table[curr->hash & m_TableMask];
+					m_Table[curr->hash & m_TableMask] = curr;
+				}
+			}
+
+			entry->next = m_Table[hash & m_TableMask];
+			m_Table[hash & m_TableMask] = entry;
+
+			entry->older = m_Newest;
+			entry->newer = NULL;
+			if (m_Newest) { m_Newest->newer = entry; }
+			m_Newest = entry;
+			if (!m_Oldest) { m_Oldest = entry; }
+
+			m_EntryTotal++;
+
+			m_Lock.Unlock();
+
+			Image* image = (a_Stream) ? TIL_Load(a_Stream, a_Options) : TIL_Load(a_Name, a_Options);
+			a_Stream = NULL;
+
+			uint32 size = 0;
+			if (image)
+			{
+				for (uint32 i = 0; i < image->GetFrameCount(); i++) { size += image->GetDataSize(i); }
+			}
+
+			m_Lock.Lock();
+
+			entry->image = image;
+			entry->size = size;
+			entry->loading = false;
+			m_Size += size;
+
+			if (entry->waiting > 0)
+			{
+				entry->ready.Post(entry->waiting);
+				entry->waiting = 0;
+			}
+		}
+
+		ImageShared* result = NULL;
+
+		if (entry->image)
+		{
+			Use(entry);
+
+			result = new ImageShared();
+			result->m_Cache = this;
+			result->m_Entry = entry;
+			result->m_Image = entry->image;
+			result->SetBPP(entry->image->GetBitDepth() << 16);
+		}
+		else
+		{
+			// the last one to find out it couldn't be loaded removes it
+			if (--entry->references == 0) { Remove(entry); }
+		}
+
+		Evict();
+
+		m_Lock.Unlock();
+
+		// not needed, because it was already loaded
+		if (a_Stream)
+		{
+			a_Stream->Close();
+			if (!a_Stream->IsReusable()) { delete a_Stream; }
+		}
+
+		return result;
+	}
+
+	void CacheMemory::Release(EntryShared* a_Entry)
+	{
+		m_Lock.Lock();
+
+		if (--a_Entry->references == 0) { Evict(); }
+
+		m_Lock.Unlock();
+	}
+
+	CacheMemory::EntryShared* CacheMemory::Find(const char* a_Name, uint32 a_Options, uint32 a_Hash)
+	{
+		for (EntryShared* curr = m_Table[a_Hash & m_TableMask]; curr; curr = curr->next)
+		{
+			if (curr->hash == a_Hash && curr->options == a_Options && !strcmp(curr->name, a_Name))
+			{
+				return curr;
+			}
+		}
+
+		return NULL;
+	}
+
+	void CacheMemory::Remove(EntryShared* a_Entry)
+	{
+		EntryShared** link = &m_Table[a_Entry->hash & m_TableMask];
+		while (*link != a_Entry) { link = &(*link)->next; }
+		*link = a_Entry->next;
+
+		if (a_Entry->newer) { a_Entry->newer->older = a_Entry->older; }
+		else { m_Newest = a_Entry->older; }
+		if (a_Entry->older) { a_Entry->older->newer = a_Entry->newer; }
+		else { m_Oldest = a_Entry->newer; }
+
+		m_Size -= a_Entry->size;
+		m_EntryTotal--;
+
+		if (a_Entry->image) { TIL_Release(a_Entry->image); }
+		delete [] a_Entry->name;
+		delete a_Entry;
+	}
+
+	void CacheMemory::Use(EntryShared* a_Entry)
+	{
+		if (a_Entry == m_Newest) { return; }
+
+		if (a_Entry->newer) { a_Entry->newer->older = a_Entry->older; }
+		if (a_Entry->older) { a_Entry->older->newer = a_Entry->newer; }
+		else { m_Oldest = a_Entry->newer; }
+
+		a_Entry->older = m_Newest;
+		a_Entry->newer = NULL;
+		m_Newest->newer = a_Entry;
+		m_Newest = a_Entry;
+	}
+
+	void CacheMemory::Evict()
+	{
+		EntryShared* entry = m_Oldest;
+		while (entry && m_Size > m_MaxSize)
+		{
+			EntryShared* newer = entry->newer;
+			if (entry->references == 0) { Remove(entry); }
+			entry = newer;
+		}
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -0,0 +1,686 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILCacheShared.cpp
+*/
+
+#include "TILCacheShared.h"
+#include "TILArchivePack.h"
+#include "TILInternal.h"
+#include "TinyImageLoader.h"
+
+#if (TIL_FORMAT & TIL_FORMAT_DDS)
+	#include "TILImageDDS.h"
+#endif
+
+#if (TIL_PLATFORM == TIL_PLATFORM_WINDOWS)
+	#define TIL_SHARED_WINDOWS
+#elif (TIL_PLATFORM == TIL_PLATFORM_LINUX)
+	#define TIL_SHARED_POSIX
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+	The shared memory starts with a header, followed by the slots and 
+	the images. Everything is stored as native 32-bit words, because 
+	the memory never leaves the machine.
+
+	header:       magic, version, state, size, number of slots, offset of
+	              the slots, offset of the images, offset of the free space
+	slots:        key (low word first), state, depth, number of frames, 
+	              offset of the frames, size, delay in microseconds, 
+	              fourcc, block size
+
+	A slot is claimed by swapping the low word of its key from zero, 
+	after which the process that claimed it is the only one that writes it.
+	The frames are stored the same way as in a pack, with offsets from the 
+	start of the shared memory.
+*/
+
+#define SHARED_MAGIC                   0x534C4954 // "TILS"
+#define SHARED_VERSION                 1
+
+#define SHARED_HEADER_SIZE             64
+#define SHARED_SLOT_SIZE               64
+#define SHARED_FRAME_SIZE              32
+
+#define SHARED_ALIGN                   16
+
+#define SHARED_STATE_EMPTY             0
+#define SHARED_STATE_WRITING           1
+#define SHARED_STATE_READY             2
+#define SHARED_STATE_FAILED            3
+
+// in milliseconds
+#define SHARED_WAIT_CREATE             5000
+#define SHARED_WAIT_LOAD               30000
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#if (TIL_COMPILER == TIL_COMPILER_MSVC)
+
+	typedef volatile LONG SharedWord;
+
+	static inline uint32 SHARED_CompareExchange(byte* a_Dst, uint32 a_Compare, uint32 a_Exchange)
+	{
+		return (uint32)(ULONG)InterlockedCompareExchange((SharedWord*)a_Dst, (LONG)a_Exchange, (LONG)a_Compare);
+	}
+
+	static inline void SHARED_Barrier()
+	{
+		MemoryBarrier();
+	}
+
+#else
+
+	typedef volatile int SharedWord;
+
+	static inline uint32 SHARED_CompareExchange(byte* a_Dst, uint32 a_Compare, uint32 a_Exchange)
+	{
+		return (uint32)(unsigned int)__sync_val_compare_and_swap((SharedWord*)a_Dst, (int)a_Compare, (int)a_Exchange);
+	}
+
+	static inline void SHARED_Barrier()
+	{
+		__sync_synchronize();
+	}
+
+#endif
+
+	static inline uint32 SHARED_Get(byte* a_Src)
+	{
+		return (uint32)(unsigned int)*(SharedWord*)a_Src;
+	}
+
+	static inline void SHARED_Put(byte* a_Dst, uint32 a_Value)
+	{
+		*(SharedWord*)a_Dst = (int)a_Value;
+	}
+
+	// reads a word written by another process before reading 
+	// what was written before it
+	static inline uint32 SHARED_Acquire(byte* a_Src)
+	{
+		uint32 result = SHARED_Get(a_Src);
+		SHARED_Barrier();
+		return result;
+	}
+
+	// makes everything written before visible before the word
+	static inline void SHARED_Release(byte* a_Dst, uint32 a_Value)
+	{
+		SHARED_Barrier();
+		SHARED_Put(a_Dst, a_Value);
+	}
+
+	static void SHARED_Sleep(uint32 a_Milliseconds)
+	{
+#if defined(TIL_SHARED_WINDOWS)
+		Sleep(a_Milliseconds);
+#elif defined(TIL_SHARED_POSIX)
+		usleep(a_Milliseconds * 1000);
+#endif
+	}
+
+	static uint64 SHARED_Hash(const char* a_Name, uint32 a_Options)
+	{
+		uint64 hash = Internal::g_HashStart64;
+		for (const char* src = a_Name; *src; src++)
+		{
+			hash = Internal::Hash64(hash, (byte)*src);
+		}
+		return Internal::HashDWord64(hash, a_Options);
+	}
+
+	static inline uint32 SHARED_Align(uint32 a_Value)
+	{
+		return (a_Value + SHARED_ALIGN - 1) & ~(SHARED_ALIGN - 1);
+	}
+
+#endif
+
+	CacheShared::CacheShared()
+	{
+		m_Map = NULL;
+		m_View = NULL;
+		m_Size = 0;
+		m_SlotTotal = 0;
+		m_Handle = NULL;
+	}
+
+	CacheShared::~CacheShared()
+	{
+		Close();
+	}
+
+	bool CacheShared::Open(const char* a_Name, uint32 a_Size, uint32 a_MaxImages)
+	{
+		Close();
+
+		if (!a_Name || !a_Name[0] || strlen(a_Name) > TIL_MAX_PATH - 2)
+		{
+			TIL_ERROR_EXPLAIN("Invalid name for shared cache.");
+			return false;
+		}
+
+		// only checked when the cache is created
+		uint32 slot_total = a_MaxImages;
+		uint32 data_offset = SHARED_Align(SHARED_HEADER_SIZE + (a_MaxImages & 0x00FFFFFF) * SHARED_SLOT_SIZE);
+		bool valid = (a_MaxImages > 0 && a_MaxImages <= 0x00FFFFFF && a_Size > data_offset);
+
+		bool created = false;
+		uint32 size = a_Size;
+
+#if defined(TIL_SHARED_POSIX)
+
+		// names of shared memory start with a slash
+		char name[TIL_MAX_PATH];
+		name[0] = '/';
+		strcpy(name + 1, (a_Name[0] == '/') ? a_Name + 1 : a_Name);
+
+		int handle = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0666);
+		if (handle >= 0)
+		{
+			created = true;
+			if (!valid || ftruncate(handle, (off_t)a_Size) != 0)
+			{
+				TIL_ERROR_EXPLAIN("Could not create shared cache '%s' of %i bytes for %i images.", name, a_Size, a_MaxImages);
+				close(handle);
+				shm_unlink(name);
+				return false;
+			}
+		}
+		else if (errno == EEXIST)
+		{
+			handle = shm_open(name, O_RDWR, 0666);
+			if (handle < 0)
+			{
+				TIL_ERROR_EXPLAIN("Could not open shared cache '%s'.", name);
+				return false;
+			}
+
+			// the process that created it might not have resized it yet
+			struct stat info;
+			for (uint32 i = 0; i < SHARED_WAIT_CREATE; i++)
+			{
+				if (fstat(handle, &info) != 0 || info.st_size != 0) { break; }
+				SHARED_Sleep(1);
+			}
+
+			if (fstat(handle, &info) != 0 || (uint64)info.st_size < SHARED_HEADER_SIZE || (uint64)info.st_size > 0xFFFFFFFFULL)
+			{
+				TIL_ERROR_EXPLAIN("Invalid size for shared cache '%s'.", name);
+				close(handle);
+				return false;
+			}
+			size = (uint32)info.st_size;
+		}
+		else
+		{
+			TIL_ERROR_EXPLAIN("Could not create shared cache '%s'.", name);
+			return false;
+		}
+
+		void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+		void* view = mmap(NULL, size, PROT_READ, MAP_SHARED, handle, 0);
+
+		// the mappings keep the memory open
+		close(handle);
+
+		if (map == MAP_FAILED || view == MAP_FAILED)
+		{
+			TIL_ERROR_EXPLAIN("Could not map shared cache '%s'.", name);
+			if (map != MAP_FAILED) { munmap(map, size); }
+			if (view != MAP_FAILED) { munmap(view, size); }
+			return false;
+		}
+
+		m_Map = (byte*)map;
+		m_View = (byte*)view;
+
+#elif defined(TIL_SHARED_WINDOWS)
+
+		HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, valid ? a_Size : SHARED_HEADER_SIZE, a_Name);
+		if (!handle)
+		{
+			TIL_ERROR_EXPLAIN("Could not create shared cache '%s'.", a_Name);
+			return false;
+		}
+		created = (GetLastError() != ERROR_ALREADY_EXISTS);
+		if (created && !valid)
+		{
+			TIL_ERROR_EXPLAIN("Could not create shared cache '%s' of %i bytes for %i images.", a_Name, a_Size, a_MaxImages);
+			CloseHandle(handle);
+			return false;
+		}
+
+		m_Map = (byte*)MapViewOfFile(handle, FILE_MAP_WRITE, 0, 0, 0);
+		m_View = (byte*)MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+		m_Handle = (void*)handle;
+
+		if (!m_Map || !m_View)
+		{
+			TIL_ERROR_EXPLAIN("Could not map shared cache '%s'.", a_Name);
+			Close();
+			return false;
+		}
+
+		// the size of the view is a multiple of pages
+		MEMORY_BASIC_INFORMATION info;
+		if (!created && VirtualQuery(m_Map, &info, sizeof(info)))
+		{
+			size = (uint32)info.RegionSize;
+		}
+
+#else
+
+		TIL_ERROR_EXPLAIN("Shared caches are not supported on this platform.");
+		return false;
+
+#endif
+
+		m_Size = size;
+
+		if (created)
+		{
+			// the memory starts out as zeroes, which are empty slots
+			SHARED_Put(m_Map + 0, SHARED_MAGIC);
+			SHARED_Put(m_Map + 4, SHARED_VERSION);
+			SHARED_Put(m_Map + 12, a_Size);
+			SHARED_Put(m_Map + 16, slot_total);
+			SHARED_Put(m_Map + 20, SHARED_HEADER_SIZE);
+			SHARED_Put(m_Map + 24, data_offset);
+			SHARED_Put(m_Map + 28, data_offset);
+			SHARED_Release(m_Map + 8, 1);
+		}
+		else
+		{
+			uint32 i = 0;
+			while (SHARED_Acquire(m_Map + 8) == 0 && i++ < SHARED_WAIT_CREATE)
+			{
+				SHARED_Sleep(1);
+			}
+
+			if (SHARED_Get(m_Map + 8) == 0 || SHARED_Get(m_Map) != SHARED_MAGIC || SHARED_Get(m_Map + 4) != SHARED_VERSION)
+			{
+				TIL_ERROR_EXPLAIN("Shared cache '%s' is not a valid cache.", a_Name);
+				Close();
+				return false;
+			}
+
+			// the header decides, not the caller
+			uint32 total = SHARED_Get(m_Map + 12);
+			slot_total = SHARED_Get(m_Map + 16);
+			data_offset = SHARED_Get(m_Map + 24);
+			if (
+				total > m_Size || 
+				slot_total == 0 || slot_total > 0x00FFFFFF ||
+				SHARED_Get(m_Map + 20) != SHARED_HEADER_SIZE ||
+				data_offset < SHARED_HEADER_SIZE + slot_total * SHARED_SLOT_SIZE ||
+				data_offset > total
+			)
+			{
+				TIL_ERROR_EXPLAIN("Shared cache '%s' has an invalid header.", a_Name);
+				Close();
+				return false;
+			}
+			m_Size = total;
+		}
+
+		m_SlotTotal = slot_total;
+
+		TIL_PRINT_DEBUG("Shared cache: %s '%s' with %i bytes", created ? "Created" : "Opened", a_Name, m_Size);
+
+		return true;
+	}
+
+	void CacheShared::Close()
+	{
+#if defined(TIL_SHARED_POSIX)
+
+		if (m_Map) { munmap(m_Map, m_Size); }
+		if (m_View) { munmap(m_View, m_Size); }
+
+#elif defined(TIL_SHARED_WINDOWS)
+
+		if (m_Map) { UnmapViewOfFile(m_Map); }
+		if (m_View) { UnmapViewOfFile(m_View); }
+		if (m_Handle) { CloseHandle((HANDLE)m_Handle); }
+
+#endif
+
+		m_Map = NULL;
+		m_View = NULL;
+		m_Size = 0;
+		m_SlotTotal = 0;
+		m_Handle = NULL;
+	}
+
+	bool CacheShared::Remove(const char* a_Name)
+	{
+		if (!a_Name || !a_Name[0] || strlen(a_Name) > TIL_MAX_PATH - 2) { return false; }
+
+#if defined(TIL_SHARED_POSIX)
+
+		char name[TIL_MAX_PATH];
+		name[0] = '/';
+		strcpy(name + 1, (a_Name[0] == '/') ? a_Name + 1 : a_Name);
+
+		return (shm_unlink(name) == 0);
+
+#elif defined(TIL_SHARED_WINDOWS)
+
+		return true;
+
+#else
+
+		return false;
+
+#endif
+	}
+
+	Image* CacheShared::Load(const char* a_FileName, uint32 a_Options)
+	{
+		if (!m_Map) 
+		{
+			TIL_ERROR_EXPLAIN("Shared cache is not open.");
+			return NULL;
+		}
+
+		bool owner = false;
+		byte* slot = Claim(SHARED_Hash(a_FileName, a_Options), owner);
+		if (!slot)
+		{
+			TIL_PRINT_DEBUG("Shared cache: Full, loading '%s'", a_FileName);
+			return TIL_Load(a_FileName, a_Options);
+		}
+
+		if (owner)
+		{
+			Image* load = TIL_Load(a_FileName, a_Options);
+			if (!load || !Store(slot, a_FileName, load))
+			{
+				// other processes load it themselves
+				SHARED_Release(slot + 8, SHARED_STATE_FAILED);
+				return load;
+			}
+
+			SHARED_Release(slot + 8, SHARED_STATE_READY);
+			TIL_Release(load);
+
+			TIL_PRINT_DEBUG("Shared cache: Stored '%s'", a_FileName);
+		}
+		else
+		{
+			// another process is decoding it
+			uint32 i = 0;
+			while (SHARED_Acquire(slot + 8) == SHARED_STATE_WRITING && i++ < SHARED_WAIT_LOAD)
+			{
+				SHARED_Sleep(1);
+			}
+
+			if (SHARED_Acquire(slot + 8) != SHARED_STATE_READY)
+			{
+				return TIL_Load(a_FileName, a_Options);
+			}
+		}
+
+		Image* result = View(slot);
+		if (!result)
+		{
+			return TIL_Load(a_FileName, a_Options);
+		}
+
+		return result;
+	}
+
+	uint32 CacheShared::GetImageCount()
+	{
+		if (!m_Map) { return 0; }
+
+		uint32 total = 0;
+		for (uint32 i = 0; i < m_SlotTotal; i++)
+		{
+			if (SHARED_Acquire(m_Map + SHARED_HEADER_SIZE + i * SHARED_SLOT_SIZE + 8) == SHARED_STATE_READY) { total++; }
+		}
+		return total;
+	}
+
+	uint32 CacheShared::GetUsedSize()
+	{
+		if (!m_Map) { return 0; }
+
+		return SHARED_Acquire(m_Map + 28);
+	}
+
+	byte* CacheShared::Claim(uint64 a_Key, bool& a_Owner)
+	{
+		// zero is an empty slot
+		uint32 low = (uint32)(a_Key & 0xFFFFFFFF);
+		uint32 high = (uint32)(a_Key >> 32);
+		if (low == 0) { low = 1; }
+
+		byte* slots = m_Map + SHARED_HEADER_SIZE;
+		uint32 index = (uint32)((a_Key ^ (a_Key >> 32)) % m_SlotTotal);
+
+		for (uint32 i = 0; i < m_SlotTotal; i++)
+		{
+			byte* slot = slots + index * SHARED_SLOT_SIZE;
+
+			uint32 key = SHARED_Acquire(slot);
+			if (key == 0)
+			{
+				key = SHARED_CompareExchange(slot, 0, low);
+				if (key == 0)
+				{
+					SHARED_Put(slot + 4, high);
+					SHARED_Release(slot + 8, SHARED_STATE_WRITING);
+
+					a_Owner = true;
+					return slot;
+				}
+			}
+
+			if (key == low)
+			{
+				// the rest of the key is written right after claiming
+				uint32 j = 0;
+				while (SHARED_Acquire(slot + 8) == SHARED_STATE_EMPTY && j++ < SHARED_WAIT_CREATE)
+				{
+					SHARED_Sleep(1);
+				}
+
+				if (SHARED_Get(slot + 4) == high)
+				{
+					a_Owner = false;
+					return slot;
+				}
+			}
+
+			index = (index + 1) % m_SlotTotal;
+		}
+
+		return NULL;
+	}
+
+	bool CacheShared::Store(byte* a_Slot, const char* a_FileName, Image* a_Image)
+	{
+		uint32 frame_count = a_Image->GetFrameCount();
+		uint32 depth = a_Image->GetBitDepth();
+		if (frame_count == 0) { return false; }
+
+		// recognized the same way as by TIL_Load
+		Image* dds = NULL;
+		uint32 fourcc = 0;
+		uint32 block = 0;
+
+#if (TIL_FORMAT & TIL_FORMAT_DDS)
+		size_t length = strlen(a_FileName);
+		if (length >= 4 && !strncmp(a_FileName + length - 4, ".dds", 4))
+		{
+			dds = a_Image;
+			if (depth == Image::BPP_NATIVE)
+			{
+				fourcc = ((ImageDDS*)dds)->GetFourCC();
+				block = ((ImageDDS*)dds)->GetBlockSize();
+			}
+		}
+#endif
+
+		if (depth == Image::BPP_NATIVE && !dds) { return false; }
+
+		uint32 bpp = Internal::GetBPP(depth);
+
+		// the frames, followed by the pixels of every frame
+		uint64 total = SHARED_Align(frame_count * SHARED_FRAME_SIZE);
+		for (uint32 i = 0; i < frame_count; i++)
+		{
+			total += SHARED_Align(a_Image->GetDataSize(i));
+		}
+		if (total > m_Size) { return false; }
+
+		uint32 offset;
+		if (!Allocate((uint32)total, offset)) { return false; }
+
+		byte* frames = m_Map + offset;
+		uint32 position = offset + SHARED_Align(frame_count * SHARED_FRAME_SIZE);
+		for (uint32 i = 0; i < frame_count; i++)
+		{
+			byte* dst = frames + i * SHARED_FRAME_SIZE;
+
+			uint32 pitchx = a_Image->GetPitchX(i);
+			uint32 pitchy = a_Image->GetPitchY(i);
+			uint32 slice = pitchx * pitchy * bpp;
+			uint32 frame_depth = 1;
+			uint32 size = a_Image->GetDataSize(i);
+
+#if (TIL_FORMAT & TIL_FORMAT_DDS)
+			if (dds)
+			{
+				frame_depth = ((ImageDDS*)dds)->GetDepth(i);
+				slice = ((ImageDDS*)dds)->GetSlicePitch(i);
+			}
+#endif
+
+			SHARED_Put(dst + 0, a_Image->GetWidth(i));
+			SHARED_Put(dst + 4, a_Image->GetHeight(i));
+			SHARED_Put(dst + 8, pitchx);
+			SHARED_Put(dst + 12, pitchy);
+			SHARED_Put(dst + 16, frame_depth);
+			SHARED_Put(dst + 20, slice);
+			SHARED_Put(dst + 24, size);
+			SHARED_Put(dst + 28, position);
+
+			memcpy(m_Map + position, a_Image->GetPixels(i), size);
+			position += SHARED_Align(size);
+		}
+
+		SHARED_Put(a_Slot + 12, depth);
+		SHARED_Put(a_Slot + 16, frame_count);
+		SHARED_Put(a_Slot + 20, offset);
+		SHARED_Put(a_Slot + 24, (uint32)total);
+		SHARED_Put(a_Slot + 28, (uint32)(a_Image->GetDelay() * 1000000.f + 0.5f));
+		SHARED_Put(a_Slot + 32, fourcc);
+		SHARED_Put(a_Slot + 36, block);
+
+		return true;
+	}
+
+	Image* CacheShared::View(byte* a_Slot)
+	{
+		// written before the slot was ready
+		uint32 depth = SHARED_Get(a_Slot + 12);
+		uint32 frame_count = SHARED_Get(a_Slot + 16);
+		uint32 offset = SHARED_Get(a_Slot + 20);
+		uint32 size = SHARED_Get(a_Slot + 24);
+
+		if (
+			frame_count == 0 || frame_count > size / SHARED_FRAME_SIZE ||
+			offset > m_Size || size > m_Size - offset
+		)
+		{
+			TIL_ERROR_EXPLAIN("Invalid image in shared cache.");
+			return NULL;
+		}
+
+		byte* frames = m_View + offset;
+		for (uint32 i = 0; i < frame_count; i++)
+		{
+			uint32 frame_size = SHARED_Get(frames + i * SHARED_FRAME_SIZE + 24);
+			uint32 frame_offset = SHARED_Get(frames + i * SHARED_FRAME_SIZE + 28);
+			if (frame_offset < offset || frame_offset > offset + size || frame_size > offset + size - frame_offset)
+			{
+				TIL_ERROR_EXPLAIN("Invalid frame %i in shared cache.", i);
+				return NULL;
+			}
+		}
+
+		ImagePack* result = new ImagePack();
+		if (!result->SetBPP(depth << 16))
+		{
+			TIL_ERROR_EXPLAIN("Unknown color depth in shared cache: %i", depth);
+			delete result;
+			return NULL;
+		}
+
+		// the pixels can only be read
+		result->m_Data = m_View;
+		result->m_Frames = frames;
+		result->m_FrameTotal = frame_count;
+		result->m_Delay = (float)SHARED_Get(a_Slot + 28) / 1000000.f;
+		result->m_FourCC = SHARED_Get(a_Slot + 32);
+		result->m_BlockSize = SHARED_Get(a_Slot + 36);
+
+		return result;
+	}
+
+	bool CacheShared::Allocate(uint32 a_Size, uint32& a_Offset)
+	{
+		// moves the start of the free space, unless another process did
+		byte* free = m_Map + 28;
+		while (1)
+		{
+			uint32 offset = SHARED_Acquire(free);
+			if (offset > m_Size || a_Size > m_Size - offset) { return false; }
+
+			if (SHARED_CompareExchange(free, offset, offset + a_Size) == offset)
+			{
+				a_Offset = offset;
+				return true;
+			}
+		}
+	}
+
+}; // namespace til
\ No newline at end of file
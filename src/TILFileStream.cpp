@@ -37,6 +37,11 @@ namespace til
 
 	}
 
+	uint32 FileStream::GetSize()
+	{
+		return 0;
+	}
+
 	const char* FileStream::GetFilePath()
 	{
 		return (const char*)m_FilePath;
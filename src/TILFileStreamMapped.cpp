@@ -0,0 +1,189 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILFileStreamMapped.cpp
+*/
+
+#include "TILFileStreamMapped.h"
+#include "TILInternal.h"
+
+#if (TIL_PLATFORM == TIL_PLATFORM_WINDOWS)
+	#define TIL_MAPPED_WINDOWS
+#elif (TIL_PLATFORM == TIL_PLATFORM_LINUX || TIL_PLATFORM == TIL_PLATFORM_ANDROID)
+	#define TIL_MAPPED_POSIX
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+namespace til
+{
+
+	FileStreamMapped::FileStreamMapped() : FileStreamMemory()
+	{
+		m_Map = NULL;
+		m_MapSize = 0;
+	}
+
+	FileStreamMapped::~FileStreamMapped()
+	{
+		Close();
+	}
+
+	bool FileStreamMapped::Open(const char* a_File, uint32 a_Options)
+	{
+		Close();
+
+		char path[TIL_MAX_PATH] = { 0 };
+
+		if (a_Options & TIL_FILE_ADDWORKINGDIR)
+		{
+			TIL_AddWorkingDirectory(path, TIL_MAX_PATH, a_File);
+
+			TIL_PRINT_DEBUG("Final path: %s", path);
+		}
+		else
+		{
+			strncpy(path, a_File, TIL_MAX_PATH - 1);
+		}
+
+		uint32 size = 0;
+
+#if defined(TIL_MAPPED_WINDOWS)
+
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			TIL_ERROR_EXPLAIN("Could not open '%s'.", path);
+			return false;
+		}
+
+		DWORD high = 0;
+		size = GetFileSize(file, &high);
+		if (high != 0 || size == 0)
+		{
+			TIL_ERROR_EXPLAIN("Can't map '%s', it's empty or larger than 4 GB.", path);
+			CloseHandle(file);
+			return false;
+		}
+
+		// the view keeps the mapping alive, so the handles can be closed right away
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (mapping)
+		{
+			m_Map = (byte*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+
+#elif defined(TIL_MAPPED_POSIX)
+
+		int file = open(path, O_RDONLY);
+		if (file < 0)
+		{
+			TIL_ERROR_EXPLAIN("Could not open '%s'.", path);
+			return false;
+		}
+
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size <= 0 || (uint64)info.st_size > 0xFFFFFFFF)
+		{
+			TIL_ERROR_EXPLAIN("Can't map '%s', it's empty or larger than 4 GB.", path);
+			close(file);
+			return false;
+		}
+		size = (uint32)info.st_size;
+
+		void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		if (map != MAP_FAILED) { m_Map = (byte*)map; }
+		close(file);
+
+#else
+
+		FILE* file = fopen(path, "rb");
+		if (!file)
+		{
+			TIL_ERROR_EXPLAIN("Could not open '%s'.", path);
+			return false;
+		}
+
+		fseek(file, 0, SEEK_END);
+		long length = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (length <= 0)
+		{
+			TIL_ERROR_EXPLAIN("Can't map '%s', it's empty.", path);
+			fclose(file);
+			return false;
+		}
+		size = (uint32)length;
+
+		m_Map = new byte[size];
+		if (fread(m_Map, 1, size, file) != size)
+		{
+			delete [] m_Map;
+			m_Map = NULL;
+		}
+		fclose(file);
+
+#endif
+
+		if (!m_Map)
+		{
+			TIL_ERROR_EXPLAIN("Could not map '%s'.", path);
+			return false;
+		}
+
+		m_MapSize = size;
+		SetData(m_Map, m_MapSize);
+
+		return FileStreamMemory::Open(path, a_Options);
+	}
+
+	bool FileStreamMapped::Close()
+	{
+		FileStreamMemory::Close();
+
+		if (!m_Map) { return false; }
+
+#if defined(TIL_MAPPED_WINDOWS)
+		UnmapViewOfFile(m_Map);
+#elif defined(TIL_MAPPED_POSIX)
+		munmap(m_Map, m_MapSize);
+#else
+		delete [] m_Map;
+#endif
+
+		m_Map = NULL;
+		m_MapSize = 0;
+
+		return true;
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -0,0 +1,145 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+
+#include "TILFileStreamMemory.h"
+#include "TILInternal.h"
+
+#include <string.h>
+
+namespace til
+{
+
+	FileStreamMemory::FileStreamMemory() : FileStream()
+	{
+		m_FilePath = NULL;
+		m_Data = NULL;
+		m_Size = 0;
+		m_Position = 0;
+	}
+
+	FileStreamMemory::~FileStreamMemory()
+	{
+		if (m_FilePath) { delete [] m_FilePath; }
+	}
+
+	void FileStreamMemory::SetData(byte* a_Data, uint32 a_Size)
+	{
+		m_Data = a_Data;
+		m_Size = a_Size;
+		m_Position = 0;
+	}
+
+	byte* FileStreamMemory::GetData()
+	{
+		return m_Data;
+	}
+
+	bool FileStreamMemory::Open(const char* a_File, uint32 /*a_Options*/)
+	{
+		if (m_FilePath) { delete [] m_FilePath; }
+
+		m_FilePath = new char[strlen(a_File) + 1];
+		strcpy(m_FilePath, a_File);
+
+		m_Position = 0;
+
+		return (m_Data != NULL);
+	}
+
+	bool FileStreamMemory::Read(void* a_Dst, uint32 a_Size, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, a_Size * a_Count);
+	}
+
+	bool FileStreamMemory::ReadByte(byte* a_Dst, uint32 a_Count)
+	{
+		// copy what's left, like reading past the end of a file
+		uint32 left = m_Size - m_Position;
+		uint32 count = (a_Count > left) ? left : a_Count;
+
+		memcpy(a_Dst, m_Data + m_Position, count);
+		m_Position += count;
+
+		return (count == a_Count);
+	}
+
+	bool FileStreamMemory::ReadWord(word* a_Dst, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, sizeof(word) * a_Count);
+	}
+
+	bool FileStreamMemory::ReadDWord(dword* a_Dst, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, sizeof(dword) * a_Count);
+	}
+
+	bool FileStreamMemory::Seek(uint32 a_Bytes, uint32 a_Options)
+	{
+		uint32 position = m_Position;
+
+		if (a_Options & TIL_FILE_SEEK_START) 
+		{ 
+			position = a_Bytes;
+		}
+		else if (a_Options & TIL_FILE_SEEK_CURR) 
+		{ 
+			position = (a_Bytes > m_Size - m_Position) ? m_Size + 1 : m_Position + a_Bytes;
+		}
+		else if (a_Options & TIL_FILE_SEEK_END) 
+		{ 
+			position = (a_Bytes > 0) ? m_Size + 1 : m_Size;
+		}
+
+		if (position > m_Size)
+		{
+			m_Position = m_Size;
+			return false;
+		}
+
+		m_Position = position;
+
+		return true;
+	}
+
+	bool FileStreamMemory::EndOfFile()
+	{
+		return (m_Position >= m_Size);
+	}
+
+	uint32 FileStreamMemory::GetSize()
+	{
+		return m_Size;
+	}
+
+	bool FileStreamMemory::Close()
+	{
+		m_Data = NULL;
+		m_Size = 0;
+		m_Position = 0;
+
+		return true;
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -116,6 +116,16 @@ namespace til
 		return false;
 	}
 
+	uint32 FileStreamStd::GetSize()
+	{
+		long position = ftell(m_Handle);
+		fseek(m_Handle, 0, SEEK_END);
+		long size = ftell(m_Handle);
+		fseek(m_Handle, position, SEEK_SET);
+
+		return (size > 0) ? (uint32)size : 0;
+	}
+
 	bool FileStreamStd::Close()
 	{
 		if (m_Handle)
@@ -0,0 +1,143 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+#include "TILFileStreamWindow.h"
+#include "TILInternal.h"
+
+#include <string.h>
+
+namespace til
+{
+
+	FileStreamWindow::FileStreamWindow(FileStream* a_Parent, uint32 a_Offset, uint32 a_Length) : FileStream()
+	{
+		m_FilePath = NULL;
+		m_Parent = a_Parent;
+		m_Offset = a_Offset;
+		m_Length = a_Length;
+		m_Position = 0;
+		m_Moved = true;
+	}
+
+	FileStreamWindow::~FileStreamWindow()
+	{
+		if (m_FilePath) { delete [] m_FilePath; }
+	}
+
+	bool FileStreamWindow::Open(const char* a_File, uint32 /*a_Options*/)
+	{
+		if (m_FilePath) { delete [] m_FilePath; }
+
+		m_FilePath = new char[strlen(a_File) + 1];
+		strcpy(m_FilePath, a_File);
+
+		m_Position = 0;
+		m_Moved = true;
+
+		return (m_Parent != NULL);
+	}
+
+	bool FileStreamWindow::Read(void* a_Dst, uint32 a_Size, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, a_Size * a_Count);
+	}
+
+	bool FileStreamWindow::ReadByte(byte* a_Dst, uint32 a_Count)
+	{
+		// only seek the parent when the window was moved
+		if (m_Moved)
+		{
+			m_Parent->Seek(m_Offset + m_Position, TIL_FILE_SEEK_START);
+			m_Moved = false;
+		}
+
+		uint32 left = m_Length - m_Position;
+		uint32 count = (a_Count > left) ? left : a_Count;
+
+		bool result = (count == 0) || m_Parent->ReadByte(a_Dst, count);
+		m_Position += count;
+
+		return (result && count == a_Count);
+	}
+
+	bool FileStreamWindow::ReadWord(word* a_Dst, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, sizeof(word) * a_Count);
+	}
+
+	bool FileStreamWindow::ReadDWord(dword* a_Dst, uint32 a_Count)
+	{
+		return ReadByte((byte*)a_Dst, sizeof(dword) * a_Count);
+	}
+
+	bool FileStreamWindow::Seek(uint32 a_Bytes, uint32 a_Options)
+	{
+		uint32 position = m_Position;
+
+		if (a_Options & TIL_FILE_SEEK_START) 
+		{ 
+			position = a_Bytes;
+		}
+		else if (a_Options & TIL_FILE_SEEK_CURR) 
+		{ 
+			position = (a_Bytes > m_Length - m_Position) ? m_Length + 1 : m_Position + a_Bytes;
+		}
+		else if (a_Options & TIL_FILE_SEEK_END) 
+		{ 
+			position = (a_Bytes > 0) ? m_Length + 1 : m_Length;
+		}
+
+		m_Moved = true;
+
+		if (position > m_Length)
+		{
+			m_Position = m_Length;
+			return false;
+		}
+
+		m_Position = position;
+
+		return true;
+	}
+
+	bool FileStreamWindow::EndOfFile()
+	{
+		return (m_Position >= m_Length);
+	}
+
+	uint32 FileStreamWindow::GetSize()
+	{
+		return m_Length;
+	}
+
+	bool FileStreamWindow::Close()
+	{
+		// the parent belongs to someone else
+		m_Parent = NULL;
+		m_Position = 0;
+
+		return true;
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -37,6 +37,14 @@ namespace til
 	{
 		m_FileName = NULL;
 		m_Stream = NULL;
+		m_RowFunc = NULL;
+		m_RowUser = NULL;
+		m_RowTotal = 0;
+		m_RowStop = false;
+		m_RegionX = m_RegionY = 0;
+		m_RegionWidth = m_RegionHeight = 0;
+		m_RegionChecked = false;
+		m_RegionFailed = false;
 	}
 
 	Image::~Image()
@@ -49,6 +57,134 @@ namespace til
 		m_Stream = a_Stream;
 	}
 
+	bool Image::Decode(uint32 a_Options, RowFunc a_Func, void* a_User)
+	{
+		return DecodeRegion(a_Options, 0, 0, 0, 0, a_Func, a_User);
+	}
+
+	bool Image::DecodeRegion(uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height, RowFunc a_Func, void* a_User)
+	{
+		m_RowFunc = a_Func;
+		m_RowUser = a_User;
+		m_RowTotal = 0;
+		m_RowStop = false;
+
+		m_RegionX = a_X;
+		m_RegionY = a_Y;
+		m_RegionWidth = a_Width;
+		m_RegionHeight = a_Height;
+		m_RegionChecked = false;
+		m_RegionFailed = false;
+
+		// rows are always passed from the top down
+		bool result = Parse(a_Options & ~TIL_LOAD_BOTTOMUP);
+
+		// loaders stop as soon as the last row was passed on
+		if (m_RegionChecked && m_RowTotal == m_RegionHeight) { return true; }
+
+		// the reason was posted already
+		if (m_RowStop || m_RegionFailed) { return false; }
+
+		if (!result)
+		{
+			TIL_ERROR_EXPLAIN("Could not parse file.");
+			return false;
+		}
+
+		if (m_RowTotal > 0)
+		{
+			TIL_ERROR_EXPLAIN("Only %i of %i rows were decoded.", m_RowTotal, m_RegionHeight);
+			return false;
+		}
+
+		// loaders that can't pass on this image a row at a time report success 
+		// without passing any rows, the region is cut from the frame they kept
+
+		if (m_BPP == 0)
+		{
+			TIL_ERROR_EXPLAIN("Native data can't be passed row by row for this format.");
+			return false;
+		}
+
+		byte* pixels = GetPixels(0);
+		if (!pixels) { return false; }
+
+		uint32 pitch = GetPitchX(0) * m_BPP;
+		PushRows(pixels, 0, GetHeight(0), GetWidth(0), GetHeight(0), pitch);
+
+		return (m_RegionChecked && m_RowTotal == m_RegionHeight);
+	}
+
+	bool Image::PushRows(byte* a_Pixels, uint32 a_Row, uint32 a_Count, uint32 a_Width, uint32 a_Height, uint32 a_Pitch)
+	{
+		if (m_RowStop || !CheckRegion(a_Width, a_Height)) { return false; }
+
+		// crop the rows to the region
+
+		uint32 first = (a_Row > m_RegionY) ? a_Row : m_RegionY;
+		uint32 last = a_Row + a_Count;
+		if (last > m_RegionY + m_RegionHeight) { last = m_RegionY + m_RegionHeight; }
+
+		if (first < last)
+		{
+			RowData data;
+			data.pixels = a_Pixels + ((first - a_Row) * a_Pitch) + (m_RegionX * m_BPP);
+			data.row = first - m_RegionY;
+			data.count = last - first;
+			data.width = m_RegionWidth;
+			data.height = m_RegionHeight;
+			data.pitch = a_Pitch;
+			data.user = m_RowUser;
+
+			m_RowTotal += data.count;
+
+			if (!m_RowFunc(&data))
+			{
+				m_RowStop = true;
+				return false;
+			}
+		}
+
+		// nothing below the region is needed
+		return (m_RowTotal < m_RegionHeight);
+	}
+
+	bool Image::CheckRegion(uint32 a_Width, uint32 a_Height)
+	{
+		if (m_RegionChecked) { return true; }
+
+		// the error is only posted once
+		if (m_RegionFailed) { return false; }
+		m_RegionFailed = true;
+
+		if (m_RegionX >= a_Width || m_RegionY >= a_Height)
+		{
+			TIL_ERROR_EXPLAIN("Region starts at (%i, %i), outside of the image (%i, %i).", m_RegionX, m_RegionY, a_Width, a_Height);
+			return false;
+		}
+
+		if (m_RegionWidth == 0) { m_RegionWidth = a_Width - m_RegionX; }
+		if (m_RegionHeight == 0) { m_RegionHeight = a_Height - m_RegionY; }
+
+		if (m_RegionWidth > a_Width - m_RegionX || m_RegionHeight > a_Height - m_RegionY)
+		{
+			TIL_ERROR_EXPLAIN("Region (%i, %i) doesn't fit in the image (%i, %i).", m_RegionWidth, m_RegionHeight, a_Width, a_Height);
+			return false;
+		}
+
+		// native data can't be cut between pixels
+		if (m_BPP == 0 && (m_RegionWidth != a_Width || m_RegionHeight != a_Height))
+		{
+			TIL_ERROR_EXPLAIN("Native data can only be decoded as a whole.");
+			return false;
+		}
+
+		m_RegionFailed = false;
+		m_RegionChecked = true;
+
+		return true;
+	}
+
 	bool Image::Close()
 	{
 		if (m_Stream)
@@ -86,6 +222,12 @@ namespace til
 				m_BPP = 2;
 				break;
 			}
+
+		case TIL_DEPTH_NATIVE:
+			{
+				m_BPP = 0;
+				break;
+			}
 		default:
 			{
 				return false;
@@ -97,4 +239,9 @@ namespace til
 		return true;
 	}
 
+	uint32 Image::GetDataSize(uint32 a_Frame /*= 0*/)
+	{
+		return GetPitchX(a_Frame) * GetPitchY(a_Frame) * m_BPP;
+	}
+
 }; // namespace til
\ No newline at end of file
@@ -0,0 +1,389 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILImageAtlas.cpp
+*/
+
+#include "TILImageAtlas.h"
+#include "TILInternal.h"
+#include "TILThreads.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+namespace til
+{
+
+	ImageAtlas::ImageAtlas() : Image()
+	{
+		m_Pixels = NULL;
+		m_Width = m_Height = 0;
+		m_PitchX = m_PitchY = 0;
+		m_Options = 0;
+		m_Rects = NULL;
+		m_RectTotal = 0;
+		m_Entries = NULL;
+	}
+
+	ImageAtlas::~ImageAtlas()
+	{
+		if (m_Pixels) { delete [] m_Pixels; }
+		if (m_Rects) { delete [] m_Rects; }
+		if (m_Entries) { delete [] m_Entries; }
+	}
+
+	bool ImageAtlas::Parse(uint32 /*a_Options*/)
+	{
+		return true;
+	}
+
+	bool ImageAtlas::Build(FileStream** a_Streams, uint32 a_Count, uint32 a_Options, uint32 a_Width, uint32 a_Padding)
+	{
+		if (!SetBPP(a_Options & TIL_DEPTH_MASK) || m_BPP == 0)
+		{
+			TIL_ERROR_EXPLAIN("Atlases can't be made with this bit-depth: %i.", a_Options & TIL_DEPTH_MASK);
+			return false;
+		}
+
+		if (a_Count == 0)
+		{
+			TIL_ERROR_EXPLAIN("An atlas needs at least one image.");
+			return false;
+		}
+
+		m_Options = a_Options & (TIL_DEPTH_MASK | TIL_LOAD_MASK);
+
+		m_RectTotal = a_Count;
+		m_Rects = new AtlasRect[m_RectTotal];
+		m_Entries = new Entry[m_RectTotal];
+		for (uint32 i = 0; i < m_RectTotal; i++)
+		{
+			memset(&m_Rects[i], 0, sizeof(AtlasRect));
+
+			m_Entries[i].atlas = this;
+			m_Entries[i].stream = a_Streams[i];
+			m_Entries[i].rect = &m_Rects[i];
+			m_Entries[i].loaded = false;
+		}
+
+		// the sizes are needed before anything can be placed
+
+		Internal::ParallelFor(&ImageAtlas::ProbeJob, m_Entries, m_RectTotal);
+
+		// every image that failed is reported, not just the first one
+
+		bool failed = false;
+		for (uint32 i = 0; i < m_RectTotal; i++)
+		{
+			if (m_Entries[i].loaded) { continue; }
+
+			if (!a_Streams[i])
+			{
+				TIL_ERROR_EXPLAIN("Image %i of the atlas has no stream.", i);
+			}
+			else
+			{
+				TIL_ERROR_EXPLAIN("Could not read the size of image %i of the atlas: '%s'.", i, a_Streams[i]->GetFilePath());
+			}
+			failed = true;
+		}
+		if (failed) { return false; }
+
+		if (!Pack(a_Width, a_Padding)) { return false; }
+
+		m_Pixels = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		if (!m_Pixels) { return false; }
+		memset(m_Pixels, 0, m_PitchX * m_PitchY * m_BPP);
+
+		for (uint32 i = 0; i < m_RectTotal; i++)
+		{
+			AtlasRect* rect = &m_Rects[i];
+			rect->u0 = (float)rect->x / (float)m_PitchX;
+			rect->v0 = (float)rect->y / (float)m_PitchY;
+			rect->u1 = (float)(rect->x + rect->width) / (float)m_PitchX;
+			rect->v1 = (float)(rect->y + rect->height) / (float)m_PitchY;
+
+			m_Entries[i].loaded = false;
+		}
+
+		// every image is decoded straight into its own rectangle
+
+		Internal::ParallelFor(&ImageAtlas::DecodeJob, m_Entries, m_RectTotal);
+
+		for (uint32 i = 0; i < m_RectTotal; i++)
+		{
+			if (m_Entries[i].loaded) { continue; }
+
+			TIL_ERROR_EXPLAIN("Could not decode image %i into the atlas: '%s'.", i, a_Streams[i]->GetFilePath());
+			failed = true;
+		}
+
+		return !failed;
+	}
+
+	bool ImageAtlas::Pack(uint32 a_Width, uint32 a_Padding)
+	{
+		uint32 widest = 0;
+		uint64 area = 0;
+		for (uint32 i = 0; i < m_RectTotal; i++)
+		{
+			uint32 width = m_Rects[i].width + a_Padding;
+			if (width > widest) { widest = width; }
+			area += (uint64)width * (uint64)(m_Rects[i].height + a_Padding);
+		}
+
+		// without a width, the atlas is made about square
+		if (a_Width == 0)
+		{
+			a_Width = 1;
+			while ((uint64)a_Width * (uint64)a_Width < area || a_Width < widest) { a_Width <<= 1; }
+		}
+
+		if (widest > a_Width)
+		{
+			TIL_ERROR_EXPLAIN("An image of %i pixels wide doesn't fit in an atlas of %i pixels wide.", widest - a_Padding, a_Width);
+			return false;
+		}
+
+		// tallest first, so the steps in the skyline stay small
+
+		AtlasRect** order = new AtlasRect*[m_RectTotal];
+		for (uint32 i = 0; i < m_RectTotal; i++) { order[i] = &m_Rects[i]; }
+		qsort(order, m_RectTotal, sizeof(AtlasRect*), &ImageAtlas::CompareRects);
+
+		// every placed image adds at most one step
+
+		Skyline* steps = new Skyline[m_RectTotal + 2];
+		Skyline* spare = new Skyline[m_RectTotal + 2];
+		uint32 step_total = 1;
+		steps[0].x = 0;
+		steps[0].y = 0;
+		steps[0].width = a_Width;
+
+		m_Width = a_Width;
+		m_Height = 0;
+
+		for (uint32 i = 0; i < m_RectTotal; i++)
+		{
+			AtlasRect* rect = order[i];
+			uint32 width = rect->width + a_Padding;
+			uint32 height = rect->height + a_Padding;
+
+			// the lowest spot, the leftmost one when there are more
+
+			uint32 best = step_total;
+			uint32 best_y = 0;
+			for (uint32 j = 0; j < step_total && steps[j].x + width <= a_Width; j++)
+			{
+				// the image rests on the highest step under it
+				uint32 y = 0;
+				uint32 covered = 0;
+				for (uint32 k = j; covered < width; k++)
+				{
+					if (steps[k].y > y) { y = steps[k].y; }
+					covered += steps[k].width;
+				}
+
+				if (best == step_total || y < best_y)
+				{
+					best = j;
+					best_y = y;
+				}
+			}
+
+			rect->x = steps[best].x;
+			rect->y = best_y;
+			if (best_y + rect->height > m_Height) { m_Height = best_y + rect->height; }
+
+			// the steps under the image are replaced by a single one
+
+			uint32 end = rect->x + width;
+			uint32 total = 0;
+
+			for (uint32 j = 0; j < best; j++) { spare[total++] = steps[j]; }
+
+			spare[total].x = rect->x;
+			spare[total].y = best_y + height;
+			spare[total].width = width;
+			total++;
+
+			for (uint32 j = best; j < step_total; j++)
+			{
+				uint32 step_end = steps[j].x + steps[j].width;
+				if (step_end <= end) { continue; }
+
+				spare[total] = steps[j];
+				if (spare[total].x < end)
+				{
+					spare[total].x = end;
+					spare[total].width = step_end - end;
+				}
+				total++;
+			}
+
+			// steps of the same height are joined
+
+			step_total = 1;
+			steps[0] = spare[0];
+			for (uint32 j = 1; j < total; j++)
+			{
+				if (steps[step_total - 1].y == spare[j].y)
+				{
+					steps[step_total - 1].width += spare[j].width;
+				}
+				else
+				{
+					steps[step_total++] = spare[j];
+				}
+			}
+		}
+
+		delete [] steps;
+		delete [] spare;
+		delete [] order;
+
+		TIL_PRINT_DEBUG("Packed %i images in (%i, %i)", m_RectTotal, m_Width, m_Height);
+
+		return true;
+	}
+
+	int ImageAtlas::CompareRects(const void* a_Left, const void* a_Right)
+	{
+		AtlasRect* left = *(AtlasRect**)a_Left;
+		AtlasRect* right = *(AtlasRect**)a_Right;
+
+		if (left->height != right->height) { return (left->height > right->height) ? -1 : 1; }
+		if (left->width != right->width) { return (left->width > right->width) ? -1 : 1; }
+
+		// keep the order of the streams, so the result is always the same
+		return (left < right) ? -1 : ((left > right) ? 1 : 0);
+	}
+
+	void ImageAtlas::ProbeJob(void* a_Data, uint32 a_Index)
+	{
+		Entry* entry = &((Entry*)a_Data)[a_Index];
+		if (!entry->stream) { return; }
+
+		Image* image = Internal::CreateImage(entry->stream);
+		if (!image) { return; }
+
+		// only the header and the first row are decoded
+
+		image->Load(entry->stream);
+		if (image->SetBPP(entry->atlas->m_Options & TIL_DEPTH_MASK))
+		{
+			image->Decode(entry->atlas->m_Options, &ImageAtlas::ProbeRows, entry);
+		}
+
+		delete image;
+	}
+
+	bool ImageAtlas::ProbeRows(RowData* a_Data)
+	{
+		Entry* entry = (Entry*)a_Data->user;
+		entry->rect->width = a_Data->width;
+		entry->rect->height = a_Data->height;
+		entry->loaded = true;
+
+		return false;
+	}
+
+	void ImageAtlas::DecodeJob(void* a_Data, uint32 a_Index)
+	{
+		Entry* entry = &((Entry*)a_Data)[a_Index];
+
+		entry->stream->Seek(0, TIL_FILE_SEEK_START);
+
+		Image* image = Internal::CreateImage(entry->stream);
+		if (!image) { return; }
+
+		image->Load(entry->stream);
+		if (image->SetBPP(entry->atlas->m_Options & TIL_DEPTH_MASK))
+		{
+			entry->loaded = image->Decode(entry->atlas->m_Options, &ImageAtlas::CopyRows, entry);
+		}
+
+		delete image;
+	}
+
+	bool ImageAtlas::CopyRows(RowData* a_Data)
+	{
+		Entry* entry = (Entry*)a_Data->user;
+		ImageAtlas* atlas = entry->atlas;
+
+		// the image has to be the size it was when it was probed
+		if (a_Data->width != entry->rect->width || a_Data->height != entry->rect->height) { return false; }
+
+		uint32 pitch = atlas->m_PitchX * atlas->m_BPP;
+		uint32 size = a_Data->width * atlas->m_BPP;
+
+		byte* dst = atlas->m_Pixels + ((entry->rect->y + a_Data->row) * pitch) + (entry->rect->x * atlas->m_BPP);
+		byte* src = a_Data->pixels;
+		for (uint32 i = 0; i < a_Data->count; i++)
+		{
+			memcpy(dst, src, size);
+			dst += pitch;
+			src += a_Data->pitch;
+		}
+
+		return true;
+	}
+
+	uint32 ImageAtlas::GetRectCount()
+	{
+		return m_RectTotal;
+	}
+
+	const AtlasRect* ImageAtlas::GetRect(uint32 a_Index)
+	{
+		return (a_Index < m_RectTotal) ? &m_Rects[a_Index] : NULL;
+	}
+
+	byte* ImageAtlas::GetPixels(uint32 a_Frame /*= 0*/)
+	{
+		return m_Pixels;
+	}
+
+	uint32 ImageAtlas::GetWidth(uint32 a_Frame /*= 0*/)
+	{
+		return m_Width;
+	}
+
+	uint32 ImageAtlas::GetHeight(uint32 a_Frame /*= 0*/)
+	{
+		return m_Height;
+	}
+
+	uint32 ImageAtlas::GetPitchX(uint32 a_Frame /*= 0*/)
+	{
+		return m_PitchX;
+	}
+
+	uint32 ImageAtlas::GetPitchY(uint32 a_Frame /*= 0*/)
+	{
+		return m_PitchY;
+	}
+
+}; // namespace til
\ No newline at end of file
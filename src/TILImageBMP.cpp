@@ -31,6 +31,11 @@
 #include "TILInternal.h"
 #include "TILImageBMP.h"
 
+#if (TIL_FORMAT & TIL_FORMAT_PNG)
+	#include "TILImagePNG.h"
+	#include "TILFileStreamWindow.h"
+#endif
+
 #if (TIL_FORMAT & TIL_FORMAT_BMP)
 
 #if (TIL_RUN_TARGET == TIL_TARGET_DEVEL)
@@ -39,6 +44,9 @@
 	#define BMP_DEBUG(msg, ...)
 #endif
 
+// largest amount of pixels accepted, which keeps buffer sizes within 32 bits
+#define BMP_MAX_PIXELS                 0x04000000
+
 namespace til
 {
 
@@ -98,60 +106,345 @@ namespace til
 	{
 		m_ReadData = NULL;
 		m_Pixels = NULL;
+		m_Palette = NULL;
+		m_Swizzle = false;
+		m_Copy = false;
 	}
 
 	ImageBMP::~ImageBMP()
 	{
-		if (m_ReadData) { delete m_ReadData; }
+		if (m_ReadData) { delete [] m_ReadData; }
 		if (m_Pixels) { delete [] m_Pixels; }
+		if (m_Palette) { delete [] m_Palette; }
 	}
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	dword ImageBMP::GetDWord()
+	{
+		m_Stream->ReadByte(m_Data, 4);
+		return ((dword)m_Data[3] << 24) | (m_Data[2] << 16) | (m_Data[1] << 8) | (m_Data[0]);
+	}
+
+	word ImageBMP::GetWord()
+	{
+		m_Stream->ReadByte(m_Data, 2);
+		return (m_Data[1] << 8) | (m_Data[0]);
+	}
+
+	void ImageBMP::CompilePalette(uint32 a_Count, uint32 a_EntrySize)
+	{
+		// every possible index gets an entry, so indices outside 
+		// of the palette can't read past it
+
+		m_Palette = new byte[256 * m_BPP];
+		memset(m_Palette, 0, 256 * m_BPP);
+
+		if (a_Count > 256) { a_Count = 256; }
+
+		byte* entries = new byte[a_Count * a_EntrySize];
+		m_Stream->ReadByte(entries, a_Count * a_EntrySize);
+
+		// convert the colors to the target depth once, instead of for every pixel
+
+		byte color[4];
+		byte* src = entries;
+
+		for (uint32 i = 0; i < a_Count; i++)
+		{
+			color[0] = src[2];
+			color[1] = src[1];
+			color[2] = src[0];
+			color[3] = 255;
 
-	void GetComponents(byte* a_Dst, byte* a_Src, word a_Size)
+			(this->*m_ColorFunc)(m_Palette + (i * m_BPP), color);
+
+			src += a_EntrySize;
+		}
+
+		delete [] entries;
+	}
+
+	void ImageBMP::CompileBitFields(dword* a_Masks)
 	{
-		switch (a_Size)
+		for (uint32 i = 0; i < 4; i++)
 		{
+			m_Mask[i] = a_Masks[i];
+			m_Shift[i] = 0;
+			m_Scale[i] = 0;
+
+			dword mask = a_Masks[i];
+			if (mask == 0) { continue; }
 
-		case 3:
+			while (!(mask & 1)) { mask >>= 1; m_Shift[i]++; }
+
+			uint32 bits = 0;
+			while (mask & 1) { mask >>= 1; bits++; }
+
+			// only the highest 8 bits are used
+			if (bits > 8) 
+			{ 
+				m_Shift[i] += bits - 8; 
+				bits = 8;
+			}
+
+			// 16.16 fixed point factor from the range of the mask to 0 - 255
+			m_Scale[i] = (255 << 16) / ((1 << bits) - 1);
+		}
+	}
+
+	void ImageBMP::CopyPalette(byte* a_Dst, uint32 a_Index, uint32 a_Count)
+	{
+		if (m_BPP == 4)
+		{
+			color_32b* dst = (color_32b*)a_Dst;
+			color_32b color = ((color_32b*)m_Palette)[a_Index];
+			for (uint32 i = 0; i < a_Count; i++) { *dst++ = color; }
+		}
+		else
+		{
+			color_16b* dst = (color_16b*)a_Dst;
+			color_16b color = ((color_16b*)m_Palette)[a_Index];
+			for (uint32 i = 0; i < a_Count; i++) { *dst++ = color; }
+		}
+	}
+
+	void ImageBMP::DecodeRow(byte* a_Dst, byte* a_Src, uint32 a_Count)
+	{
+		byte color[4];
+
+		if (m_Depth <= 8)
+		{
+			uint32 mask = (1 << m_Depth) - 1;
+
+			for (uint32 x = 0; x < a_Count; x++)
 			{
-				a_Dst[0] = a_Src[2];
-				a_Dst[1] = a_Src[1];
-				a_Dst[2] = a_Src[0];
-				a_Dst[3] = 255;
+				// the leftmost pixel is stored in the highest bits
+				uint32 bit = x * m_Depth;
+				uint32 index = (a_Src[bit >> 3] >> (8 - m_Depth - (bit & 7))) & mask;
 
-				break;
+				CopyPalette(a_Dst, index, 1);
+				a_Dst += m_BPP;
 			}
+		}
+		else if (m_Depth == 24)
+		{
+			for (uint32 x = 0; x < a_Count; x++)
+			{
+				color[0] = a_Src[2];
+				color[1] = a_Src[1];
+				color[2] = a_Src[0];
+				color[3] = 255;
 
-		case 2:
+				(this->*m_ColorFunc)(a_Dst, color);
+
+				a_Src += 3;
+				a_Dst += m_BPP;
+			}
+		}
+		else
+		{
+			uint32 bytespp = m_Depth >> 3;
+
+			for (uint32 x = 0; x < a_Count; x++)
 			{
-				TIL_ERROR_EXPLAIN("Unimplemented bitdepth: 2");
-				break;
+				dword pixel = a_Src[0] | (a_Src[1] << 8);
+				if (bytespp == 4) { pixel |= (a_Src[2] << 16) | ((dword)a_Src[3] << 24); }
+
+				for (uint32 i = 0; i < 4; i++)
+				{
+					color[i] = (byte)((((pixel & m_Mask[i]) >> m_Shift[i]) * m_Scale[i] + 0x8000) >> 16);
+				}
+				if (m_Mask[3] == 0) { color[3] = 255; }
+
+				(this->*m_ColorFunc)(a_Dst, color);
+
+				a_Src += bytespp;
+				a_Dst += m_BPP;
 			}
+		}
+	}
+
+	void ImageBMP::CompileSwizzle()
+	{
+		m_Swizzle = false;
+		m_Copy = false;
+
+		// only 32-bit colors are made of whole bytes
+		if (m_BPP != 4 || (m_Depth != 24 && m_Depth != 32)) { return; }
+
+		// every mask has to select a whole byte, or be empty for alpha
+		if (m_Depth == 32)
+		{
+			for (uint32 i = 0; i < 4; i++)
+			{
+				if (m_Mask[i] == 0 && i == 3) { continue; }
+				if ((m_Shift[i] & 7) != 0 || m_Mask[i] != ((dword)0xFF << m_Shift[i])) { return; }
+			}
+		}
 
-		case 1:
+		// decode two pixels with different bytes and see where they end up,
+		// which also takes care of the byte order of the platform
+
+		byte probe[2][4] = { 
+			{ 0x12, 0x34, 0x56, 0x78 },
+			{ 0x9A, 0xBC, 0xDE, 0xF1 }
+		};
+		byte result[2][4];
+		DecodeRow(result[0], probe[0], 1);
+		DecodeRow(result[1], probe[1], 1);
+
+		uint32 bytespp = m_Depth >> 3;
+		m_Copy = (bytespp == 4);
+
+		for (uint32 i = 0; i < 4; i++)
+		{
+			// a byte that doesn't change is filled in
+			if (result[0][i] == result[1][i])
 			{
-				byte r = (((a_Src[0] & 0xD0) >> 5) * 0xFF) >> 3;
-				byte g = (((a_Src[0] & 0x1C) >> 2) * 0xFF) >> 3;
-				byte b = (((a_Src[0] & 0x03)     ) * 0xFF) >> 2;
+				m_SwizzleIndex[i] = 0;
+				m_SwizzleMask[i] = 0;
+				m_SwizzleFill[i] = result[0][i];
 
-				a_Dst[0] = b;
-				a_Dst[1] = g;
-				a_Dst[2] = r;
-				a_Dst[3] = 255;
+				m_Copy = false;
+				continue;
+			}
 
-				break;
+			uint32 j = 0;
+			while (j < bytespp && (probe[0][j] != result[0][i] || probe[1][j] != result[1][i])) { j++; }
+			if (j == bytespp) 
+			{ 
+				m_Copy = false;
+				return; 
 			}
 
+			m_SwizzleIndex[i] = j;
+			m_SwizzleMask[i] = 0xFF;
+			m_SwizzleFill[i] = 0;
+
+			if (j != i) { m_Copy = false; }
 		}
+
+		m_Swizzle = true;
+
+		BMP_DEBUG("Swizzle: %i %i %i %i (copy: %i)", m_SwizzleIndex[0], m_SwizzleIndex[1], m_SwizzleIndex[2], m_SwizzleIndex[3], m_Copy);
 	}
 
-#endif
+	void ImageBMP::SwizzleRow(byte* a_Dst, byte* a_Src, uint32 a_Count)
+	{
+		if (m_Copy)
+		{
+			memcpy(a_Dst, a_Src, a_Count * 4);
+			return;
+		}
 
-	dword ImageBMP::GetDWord()
+		const uint32 i0 = m_SwizzleIndex[0], i1 = m_SwizzleIndex[1], i2 = m_SwizzleIndex[2], i3 = m_SwizzleIndex[3];
+		const byte m0 = m_SwizzleMask[0], m1 = m_SwizzleMask[1], m2 = m_SwizzleMask[2], m3 = m_SwizzleMask[3];
+		const byte f0 = m_SwizzleFill[0], f1 = m_SwizzleFill[1], f2 = m_SwizzleFill[2], f3 = m_SwizzleFill[3];
+		const uint32 bytespp = m_Depth >> 3;
+
+		for (uint32 x = 0; x < a_Count; x++)
+		{
+			a_Dst[0] = (a_Src[i0] & m0) | f0;
+			a_Dst[1] = (a_Src[i1] & m1) | f1;
+			a_Dst[2] = (a_Src[i2] & m2) | f2;
+			a_Dst[3] = (a_Src[i3] & m3) | f3;
+
+			a_Src += bytespp;
+			a_Dst += 4;
+		}
+	}
+
+	void ImageBMP::DecompressRunLength(byte* a_Src, uint32 a_Size)
 	{
-		m_Stream->ReadByte(m_Data, 4);
-		return (m_Data[3] << 24) | (m_Data[2] << 16) | (m_Data[1] << 8) | (m_Data[0]);
+		byte* end = a_Src + a_Size;
+		byte* row = m_Target;
+		uint32 x = 0;
+		uint32 y = 0;
+
+		while (a_Src + 1 < end && y < m_Height)
+		{
+			uint32 count = *a_Src++;
+			uint32 value = *a_Src++;
+
+			// encoded run
+			if (count > 0)
+			{
+				if (x + count > m_Width) { count = (x < m_Width) ? m_Width - x : 0; }
+
+				if (m_Depth == 8)
+				{
+					CopyPalette(row + (x * m_BPP), value, count);
+				}
+				else
+				{
+					// 4-bit runs alternate between two colors
+					for (uint32 i = 0; i < count; i++)
+					{
+						CopyPalette(row + ((x + i) * m_BPP), (i & 1) ? (value & 0x0F) : (value >> 4), 1);
+					}
+				}
+
+				x += count;
+
+				continue;
+			}
+
+			switch (value)
+			{
+
+			// end of line
+			case 0:
+				{
+					x = 0;
+					y++;
+					row += m_Step;
+
+					break;
+				}
+
+			// end of bitmap
+			case 1:
+				{
+					return;
+				}
+
+			// skip pixels, which are left transparent
+			case 2:
+				{
+					if (a_Src + 1 >= end) { return; }
+
+					x += *a_Src++;
+					uint32 down = *a_Src++;
+
+					y += down;
+					row += (int32)down * m_Step;
+
+					break;
+				}
+
+			// absolute run of indices, padded to a word
+			default:
+				{
+					uint32 bytes = (m_Depth == 8) ? value : (value + 1) >> 1;
+					if (a_Src + bytes > end) { return; }
+
+					for (uint32 i = 0; i < value; i++, x++)
+					{
+						if (x >= m_Width) { continue; }
+
+						uint32 index;
+						if (m_Depth == 8) { index = a_Src[i]; }
+						else { index = (i & 1) ? (a_Src[i >> 1] & 0x0F) : (a_Src[i >> 1] >> 4); }
+
+						CopyPalette(row + (x * m_BPP), index, 1);
+					}
+
+					a_Src += (bytes + 1) & ~1;
+
+					break;
+				}
+
+			}
+		}
 	}
 
 	bool ImageBMP::Parse(uint32 a_Options)
@@ -194,22 +487,57 @@ namespace til
 			return false;
 		}
 
-		dword width =           GetDWord();
-		m_Width =               (uint32)width;
-		dword height =          GetDWord();
-		m_Height =              (uint32)height;
+		int32 width, height;
+		word bpp;
+		dword compression = COMP_RGB;
+		dword raw_size = 0;
+		dword colors_used = 0;
 
-		BMP_DEBUG("Dimensions: (%i, %i)", m_Width, m_Height);
+		// the oldest header only stores the dimensions and the bit depth
+		if (header_size == HDR_OS2V1)
+		{
+			width =             (int32)GetWord();
+			height =            (int32)(int16)GetWord();
+			GetWord();          // color planes, always 1
+			bpp =               GetWord();
+		}
+		else
+		{
+			width =             (int32)GetDWord();
+			height =            (int32)GetDWord();
+			GetWord();          // color planes, always 1
+			bpp =               GetWord();
+			compression =       GetDWord();
+			raw_size =          GetDWord();
+			GetDWord();         // horizontal resolution
+			GetDWord();         // vertical resolution
+			colors_used =       GetDWord();
+			GetDWord();         // important colors
+		}
 
-		word color_planes;      m_Stream->ReadWord(&color_planes);
-		BMP_DEBUG("Color plane: %i", color_planes);
+		// a negative height means the rows are stored from the top down
+		bool topdown = (height < 0);
+		m_Width = (uint32)width;
+		m_Height = (uint32)(topdown ? -height : height);
+		m_Depth = bpp;
 
-		word bpp;               m_Stream->ReadWord(&bpp);
+		BMP_DEBUG("Dimensions: (%i, %i)", m_Width, m_Height);
 		BMP_DEBUG("BPP: %i", bpp);
+		BMP_DEBUG("Raw size: %i", raw_size);
+		BMP_DEBUG("Colors used: %i", colors_used);
+
+		// rows that are passed on one at a time don't have to fit in a single buffer,
+		// except when they are run-length encoded
+		bool rows = (m_RowFunc && compression != COMP_RLE8 && compression != COMP_RLE4 && compression != COMP_PNG);
+
+		if (m_Width == 0 || m_Height == 0 || m_Width > BMP_MAX_PIXELS / (rows ? 1 : m_Height))
+		{
+			TIL_ERROR_EXPLAIN("Invalid dimensions: (%i, %i)", width, height);
+			return false;
+		}
 
-		word bytesperpixel = bpp >> 3;
+		if (m_RowFunc && !CheckRegion(m_Width, m_Height)) { return false; }
 
-		dword compression =      GetDWord();
 		switch (compression)
 		{
 		case COMP_RGB:
@@ -224,53 +552,48 @@ namespace til
 		case COMP_BITFIELDS:
 			BMP_DEBUG("Bitfields.");
 			break;
-		case COMP_JPEG:
-			BMP_DEBUG("Bitmap contains a JPEG image.");
+		case COMP_ALPHABITFIELDS:
+			BMP_DEBUG("Bitfields with alpha.");
 			break;
+		case COMP_JPEG:
+			TIL_ERROR_EXPLAIN("Bitmaps containing a JPEG image are not supported.");
+			return false;
 		case COMP_PNG:
-			BMP_DEBUG("Bitmap contains a PNG image.");
-			break;
+			{
+				BMP_DEBUG("Bitmap contains a PNG image.");
+
+				// the size of the image is optional
+				uint32 png_size = raw_size;
+				if (png_size == 0) { png_size = (size > pixel_offset) ? size - pixel_offset : 0xFFFFFFFF - pixel_offset; }
+
+				return ParsePNG(pixel_offset, png_size, a_Options);
+			}
 		default:
 			TIL_ERROR_EXPLAIN("Unknown compression method: %i", compression);
 			return false;
 		}
 
-		dword raw_size = GetDWord();
-		BMP_DEBUG("Raw size: %i", raw_size);
-
-		dword XPelsPerMeter = GetDWord();
-		dword YPelsPermeter = GetDWord();
-
-		dword colors_used = GetDWord();
-		BMP_DEBUG("Colors used: %i", colors_used);
-
-		dword colors_important = GetDWord();
-		BMP_DEBUG("Colors important: %i", colors_important);
-
-		// create pixels
-
-		m_Pixels = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
-		uint32 total = (m_Width * m_Height) >> 1;
-
-		uint32 pitch = m_PitchX * m_BPP;
-
-		m_Target = m_Pixels + ((m_Height - 1) * pitch);
-		
-		// pitch needs to be aligned to 32 bits
-		uint32 readpitch = m_Width * bytesperpixel;
-		readpitch += (readpitch % 4);
-
-		uint32 readbytes = raw_size;
-		m_ReadData = new byte[readbytes];
-
-		// read data
-
-		m_Stream->Seek(pixel_offset, TIL_FILE_SEEK_START);
-		m_Stream->ReadByte(m_ReadData, readbytes);
+		if (header_size == HDR_OS2V2 && compression != COMP_RGB)
+		{
+			TIL_ERROR_EXPLAIN("Unhandled OS/2 compression method: %i", compression);
+			return false;
+		}
 
-		byte* read = m_ReadData;
+		if (
+			(compression == COMP_RLE8 && bpp != 8) ||
+			(compression == COMP_RLE4 && bpp != 4) ||
+			((compression == COMP_BITFIELDS || compression == COMP_ALPHABITFIELDS) && bpp != 16 && bpp != 32)
+		)
+		{
+			TIL_ERROR_EXPLAIN("Invalid bit depth %i for compression method %i.", bpp, compression);
+			return false;
+		}
 
-		byte color[4];
+		if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32)
+		{
+			TIL_ERROR_EXPLAIN("Unhandled bit depth: %i", bpp);
+			return false;
+		}
 
 		switch (m_BPPIdent)
 		{
@@ -312,37 +635,227 @@ namespace til
 			return false;
 		}
 
-		// uncompressed
+		// color masks
 
-		if (compression == COMP_RGB)
+		if (compression == COMP_BITFIELDS || compression == COMP_ALPHABITFIELDS)
 		{
-			for (uint32 y = 0; y < m_Height; y++)
+			// the masks follow a V3 header and are part of the later headers
+			dword masks[4] = { 0, 0, 0, 0 };
+			uint32 mask_count = (compression == COMP_ALPHABITFIELDS || header_size >= HDR_WINDOWSV4) ? 4 : 3;
+			for (uint32 i = 0; i < mask_count; i++) { masks[i] = GetDWord(); }
+
+			BMP_DEBUG("Masks: 0x%x 0x%x 0x%x 0x%x", masks[0], masks[1], masks[2], masks[3]);
+
+			CompileBitFields(masks);
+		}
+		else if (bpp == 16)
+		{
+			dword masks[4] = { 0x7C00, 0x03E0, 0x001F, 0 };
+			CompileBitFields(masks);
+		}
+		else if (bpp == 32)
+		{
+			dword masks[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0 };
+			CompileBitFields(masks);
+		}
+
+		// palette
+
+		if (bpp <= 8)
+		{
+			uint32 count = (colors_used > 0) ? colors_used : (1 << bpp);
+			m_Stream->Seek(14 + header_size, TIL_FILE_SEEK_START);
+
+			CompilePalette(count, (header_size == HDR_OS2V1) ? 3 : 4);
+		}
+
+		CompileSwizzle();
+
+		// rows are aligned to 32 bits
+		uint32 readpitch = ((m_Width * bpp + 31) >> 5) << 2;
+
+		if (rows)
+		{
+			return DecodeRows(pixel_offset, readpitch, topdown);
+		}
+
+		// create pixels
+
+		m_Pixels = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		if (!m_Pixels) { return false; }
+
+		uint32 pitch = m_PitchX * m_BPP;
+
+		// rows are written in the order they are stored, 
+		// from the top or the bottom of the buffer
+
+		bool bottomup = ((a_Options & TIL_LOAD_BOTTOMUP) != 0);
+		if (topdown != bottomup)
+		{
+			m_Target = m_Pixels;
+			m_Step = (int32)pitch;
+		}
+		else
+		{
+			m_Target = m_Pixels + ((m_Height - 1) * pitch);
+			m_Step = -(int32)pitch;
+		}
+
+		uint32 readbytes = readpitch * m_Height;
+		if (compression == COMP_RLE8 || compression == COMP_RLE4)
+		{
+			if (raw_size == 0 && size <= pixel_offset)
 			{
-				byte* src = read;
-				uint8* dst = m_Target;
+				TIL_ERROR_EXPLAIN("Size of run-length encoded data is unknown.");
+				return false;
+			}
 
-				for (uint32 x = 0; x < m_Width; x++)
-				{
-					GetComponents(color, src, bytesperpixel);
-					(this->*m_ColorFunc)(dst, color);
+			readbytes = (raw_size > 0) ? raw_size : size - pixel_offset;
+		}
+
+		// read data
 
-					src += bytesperpixel;
-					dst += m_BPP;
+		m_Stream->Seek(pixel_offset, TIL_FILE_SEEK_START);
+
+		// rows that are already stored as requested are read straight into the pixels
+		if (m_Copy)
+		{
+			if (m_Step == (int32)readpitch)
+			{
+				m_Stream->ReadByte(m_Target, readbytes);
+			}
+			else
+			{
+				for (uint32 y = 0; y < m_Height; y++)
+				{
+					m_Stream->ReadByte(m_Target, readpitch);
+					m_Target += m_Step;
 				}
+			}
+
+			return true;
+		}
+
+		m_ReadData = new byte[readbytes];
+		memset(m_ReadData, 0, readbytes);
+
+		m_Stream->ReadByte(m_ReadData, readbytes);
+
+		if (compression == COMP_RLE8 || compression == COMP_RLE4)
+		{
+			DecompressRunLength(m_ReadData, readbytes);
+		}
+		else
+		{
+			byte* read = m_ReadData;
+
+			for (uint32 y = 0; y < m_Height; y++)
+			{
+				if (m_Swizzle) { SwizzleRow(m_Target, read, m_Width); }
+				else { DecodeRow(m_Target, read, m_Width); }
 
 				read += readpitch;
-				m_Target -= pitch;
+				m_Target += m_Step;
 			}
 		}
-		else
+
+		delete [] m_ReadData;
+		m_ReadData = NULL;
+
+		return true;
+	}
+
+	bool ImageBMP::DecodeRows(uint32 a_Offset, uint32 a_ReadPitch, bool a_TopDown)
+	{
+		if ((uint64)a_ReadPitch * m_Height > 0xFFFFFFFFULL - a_Offset)
 		{
-			TIL_ERROR_EXPLAIN("Unhandled compression method: %i", compression);
+			TIL_ERROR_EXPLAIN("Image is too large: (%i, %i)", m_Width, m_Height);
 			return false;
 		}
 
+		if (!CheckRegion(m_Width, m_Height)) { return false; }
+
+		m_PitchX = m_Width;
+		m_PitchY = 1;
+
+		uint32 pitch = m_Width * m_BPP;
+		m_Pixels = new byte[pitch];
+		m_ReadData = new byte[a_ReadPitch];
+
+		// only the columns in the region are read, but pixels 
+		// smaller than a byte are read from the start of the row
+
+		uint32 left = m_RegionX;
+		uint32 count = m_RegionWidth;
+		if (m_Depth < 8)
+		{
+			count += left;
+			left = 0;
+		}
+		uint32 skip = (left * m_Depth) >> 3;
+		uint32 read = ((count * m_Depth) + 7) >> 3;
+		bool seek = (!a_TopDown || count < m_Width);
+
+		uint32 bottom = m_RegionY + m_RegionHeight;
+		for (uint32 y = m_RegionY; y < bottom; y++)
+		{
+			// rows stored from the bottom up are read from the end
+			if (seek || y == m_RegionY)
+			{
+				uint32 stored = a_TopDown ? y : (m_Height - 1 - y);
+				m_Stream->Seek(a_Offset + (stored * a_ReadPitch) + skip, TIL_FILE_SEEK_START);
+			}
+
+			memset(m_ReadData, 0, a_ReadPitch);
+			m_Stream->ReadByte(m_ReadData, seek ? read : a_ReadPitch);
+
+			byte* dst = m_Pixels + (left * m_BPP);
+			if (m_Swizzle) { SwizzleRow(dst, m_ReadData, count); }
+			else { DecodeRow(dst, m_ReadData, count); }
+
+			if (!PushRows(m_Pixels, y, 1, m_Width, m_Height, pitch)) { return false; }
+		}
+
+		delete [] m_ReadData;
+		m_ReadData = NULL;
+
 		return true;
 	}
 
+	bool ImageBMP::ParsePNG(uint32 a_Offset, uint32 a_Size, uint32 a_Options)
+	{
+
+#if (TIL_FORMAT & TIL_FORMAT_PNG)
+
+		m_Pixels = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		if (!m_Pixels) { return false; }
+
+		// the image is read from the file and written to the pixels directly
+		FileStreamWindow stream(m_Stream, a_Offset, a_Size);
+
+		ImagePNG* png = new ImagePNG();
+		png->Load(&stream);
+		png->SetTarget(m_Pixels, m_Width, m_Height, m_PitchX, m_PitchY);
+
+		bool result = (png->SetBPP(a_Options & TIL_DEPTH_MASK) && png->Parse(a_Options));
+		if (!result)
+		{
+			TIL_ERROR_EXPLAIN("Could not parse embedded PNG image.");
+		}
+
+		delete png;
+
+		return result;
+
+#else
+
+		TIL_ERROR_EXPLAIN("Can't parse BMP containing a PNG image without PNG loader.");
+		return false;
+
+#endif
+
+	}
+
 	til::uint32 ImageBMP::GetFrameCount()
 	{
 		return 1;
@@ -0,0 +1,930 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILImageCompressed.cpp
+*/
+
+#include "TILImageCompressed.h"
+#include "TILInternal.h"
+#include "TILThreads.h"
+
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	#define COMPRESS_BAND_BLOCKS         16
+	#define COMPRESS_REFINE_STEPS        3
+
+	#define COMPRESS_FOURCC(a, b, c, d)  (((d) << 24) + ((c) << 16) + ((b) << 8) + (a))
+
+	#define DDSD_CAPS                    0x00000001
+	#define DDSD_HEIGHT                  0x00000002
+	#define DDSD_WIDTH                   0x00000004
+	#define DDSD_PIXELFORMAT             0x00001000
+	#define DDSD_MIPMAPCOUNT             0x00020000
+	#define DDSD_LINEARSIZE              0x00080000
+
+	#define DDPF_FOURCC                  0x00000004
+
+	#define DDSCAPS_COMPLEX              0x00000008
+	#define DDSCAPS_TEXTURE              0x00001000
+	#define DDSCAPS_MIPMAP               0x00400000
+
+	#define DDS_HEADER_SIZE              128
+#endif
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	/*
+		The blocks are made of the colors a decoder constructs from them,
+		the same way as the block decoders of ImageDDS, so the error that
+		is measured is the error that ends up on screen.
+	*/
+
+	inline float ClampColor(float a_Value)
+	{
+		return (a_Value < 0.0f) ? 0.0f : ((a_Value > 255.0f) ? 255.0f : a_Value);
+	}
+
+	// rounds a color with 8 bits per channel to a 16-bit 565 color
+	inline uint32 QuantizeColor(const float* a_Color)
+	{
+		uint32 r = (uint32)((ClampColor(a_Color[0]) * 31.0f / 255.0f) + 0.5f);
+		uint32 g = (uint32)((ClampColor(a_Color[1]) * 63.0f / 255.0f) + 0.5f);
+		uint32 b = (uint32)((ClampColor(a_Color[2]) * 31.0f / 255.0f) + 0.5f);
+
+		return (r << 11) | (g << 5) | b;
+	}
+
+	// expands a 16-bit 565 color to 8 bits per channel by replicating the high bits
+	inline void ExpandColor(int32* a_Dst, uint32 a_Color)
+	{
+		int32 r = (a_Color >> 11) & 0x1F;
+		int32 g = (a_Color >> 5) & 0x3F;
+		int32 b = (a_Color) & 0x1F;
+
+		a_Dst[0] = (r << 3) | (r >> 2);
+		a_Dst[1] = (g << 2) | (g >> 4);
+		a_Dst[2] = (b << 3) | (b >> 2);
+	}
+
+	// constructs the colors of a color block, with a_Count being 4, or 3 when the last one is transparent
+	static void GetPalette(int32 a_Palette[4][3], uint32 a_Color0, uint32 a_Color1, uint32 a_Count)
+	{
+		int32* c0 = a_Palette[0];
+		int32* c1 = a_Palette[1];
+		ExpandColor(c0, a_Color0);
+		ExpandColor(c1, a_Color1);
+
+		for (uint32 i = 0; i < 3; i++)
+		{
+			if (a_Count == 4)
+			{
+				a_Palette[2][i] = (2 * c0[i] + c1[i]) / 3;
+				a_Palette[3][i] = (c0[i] + 2 * c1[i]) / 3;
+			}
+			else
+			{
+				a_Palette[2][i] = (c0[i] + c1[i]) / 2;
+				a_Palette[3][i] = 0;
+			}
+		}
+	}
+
+	// picks the nearest color for every pixel in a_Mask and returns the total error,
+	// the pixels outside of it get the transparent color
+	static uint32 FitColorIndices(byte* a_Indices, byte* a_Block, uint32 a_Mask, int32 a_Palette[4][3], uint32 a_Count)
+	{
+		uint32 total = 0;
+
+		for (uint32 i = 0; i < 16; i++)
+		{
+			if (!(a_Mask & (1 << i)))
+			{
+				a_Indices[i] = 3;
+				continue;
+			}
+
+			byte* pixel = &a_Block[i * 4];
+
+			uint32 best = 0xFFFFFFFF;
+			for (uint32 j = 0; j < a_Count; j++)
+			{
+				int32 r = pixel[0] - a_Palette[j][0];
+				int32 g = pixel[1] - a_Palette[j][1];
+				int32 b = pixel[2] - a_Palette[j][2];
+				uint32 error = (uint32)((r * r) + (g * g) + (b * b));
+
+				if (error < best)
+				{
+					best = error;
+					a_Indices[i] = (byte)j;
+				}
+			}
+
+			total += best;
+		}
+
+		return total;
+	}
+
+	// finds the end points that fit the pixels best for the indices they were given,
+	// returns false when the pixels all have the same index
+	static bool RefineEndPoints(float* a_Color0, float* a_Color1, byte* a_Block, byte* a_Indices, uint32 a_Mask, uint32 a_Count)
+	{
+		// how much of the first end point every index is made of
+		static const float weights4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		static const float weights3[3] = { 1.0f, 0.0f, 1.0f / 2.0f };
+		const float* weights = (a_Count == 4) ? weights4 : weights3;
+
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ap[3] = { 0.0f, 0.0f, 0.0f };
+		float bp[3] = { 0.0f, 0.0f, 0.0f };
+
+		int32 first = -1;
+		bool spread = false;
+
+		for (uint32 i = 0; i < 16; i++)
+		{
+			if (!(a_Mask & (1 << i))) { continue; }
+
+			if (first < 0) { first = a_Indices[i]; }
+			else if (first != a_Indices[i]) { spread = true; }
+
+			float a = weights[a_Indices[i]];
+			float b = 1.0f - a;
+
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+
+			for (uint32 c = 0; c < 3; c++)
+			{
+				ap[c] += a * (float)a_Block[(i * 4) + c];
+				bp[c] += b * (float)a_Block[(i * 4) + c];
+			}
+		}
+
+		if (!spread) { return false; }
+
+		float scale = 1.0f / ((aa * bb) - (ab * ab));
+		for (uint32 c = 0; c < 3; c++)
+		{
+			a_Color0[c] = ((ap[c] * bb) - (bp[c] * ab)) * scale;
+			a_Color1[c] = ((bp[c] * aa) - (ap[c] * ab)) * scale;
+		}
+
+		return true;
+	}
+
+	// finds the end points whose third color comes closest to a single color,
+	// which is much closer than rounding it to 565 when the block is flat
+	static void FitSingleColor(uint32* a_Color0, uint32* a_Color1, const float* a_Color, uint32 a_Count)
+	{
+		static const uint32 bits[3] = { 5, 6, 5 };
+		static const uint32 shift[3] = { 11, 5, 0 };
+
+		*a_Color0 = *a_Color1 = 0;
+
+		for (uint32 c = 0; c < 3; c++)
+		{
+			int32 highest = (1 << bits[c]) - 1;
+			int32 target = (int32)(ClampColor(a_Color[c]) + 0.5f);
+			int32 rounded = (int32)((ClampColor(a_Color[c]) * (float)highest / 255.0f) + 0.5f);
+
+			int32 best = 256, best0 = rounded, best1 = rounded;
+			for (int32 i = rounded - 1; i <= rounded + 1; i++)
+			{
+				if (i < 0 || i > highest) { continue; }
+
+				for (int32 j = rounded - 1; j <= rounded + 1; j++)
+				{
+					if (j < 0 || j > highest) { continue; }
+
+					int32 e0 = (i << (8 - bits[c])) | (i >> ((2 * bits[c]) - 8));
+					int32 e1 = (j << (8 - bits[c])) | (j >> ((2 * bits[c]) - 8));
+					int32 value = (a_Count == 4) ? (((2 * e0) + e1) / 3) : ((e0 + e1) / 2);
+
+					int32 error = (value > target) ? (value - target) : (target - value);
+					if (error < best)
+					{
+						best = error;
+						best0 = i;
+						best1 = j;
+					}
+				}
+			}
+
+			*a_Color0 |= best0 << shift[c];
+			*a_Color1 |= best1 << shift[c];
+		}
+	}
+
+	// a_Mask has a bit for every pixel that is opaque, the others
+	// are only allowed in BC1 blocks and make it use three colors
+	static void EncodeColors(byte* a_Dst, byte* a_Block, uint32 a_Mask)
+	{
+		byte indices[16];
+
+		uint32 count = (a_Mask == 0xFFFF) ? 4 : 3;
+		uint32 color0 = 0, color1 = 0;
+
+		if (a_Mask == 0)
+		{
+			memset(indices, 3, 16);
+		}
+		else
+		{
+			// the mean and covariance of the colors
+
+			float mean[3] = { 0.0f, 0.0f, 0.0f };
+			float used = 0.0f;
+
+			byte lowest[3] = { 255, 255, 255 };
+			byte highest[3] = { 0, 0, 0 };
+
+			for (uint32 i = 0; i < 16; i++)
+			{
+				if (!(a_Mask & (1 << i))) { continue; }
+
+				for (uint32 c = 0; c < 3; c++)
+				{
+					byte value = a_Block[(i * 4) + c];
+					mean[c] += (float)value;
+					if (value < lowest[c]) { lowest[c] = value; }
+					if (value > highest[c]) { highest[c] = value; }
+				}
+				used += 1.0f;
+			}
+			for (uint32 c = 0; c < 3; c++) { mean[c] /= used; }
+
+			float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+			for (uint32 i = 0; i < 16; i++)
+			{
+				if (!(a_Mask & (1 << i))) { continue; }
+
+				float r = (float)a_Block[(i * 4) + 0] - mean[0];
+				float g = (float)a_Block[(i * 4) + 1] - mean[1];
+				float b = (float)a_Block[(i * 4) + 2] - mean[2];
+
+				covariance[0] += r * r;
+				covariance[1] += r * g;
+				covariance[2] += r * b;
+				covariance[3] += g * g;
+				covariance[4] += g * b;
+				covariance[5] += b * b;
+			}
+
+			// the line with the most spread is found by repeatedly
+			// multiplying with the covariance, starting from the range
+
+			float axis[3];
+			for (uint32 c = 0; c < 3; c++) { axis[c] = (float)(highest[c] - lowest[c]); }
+
+			for (uint32 k = 0; k < 4; k++)
+			{
+				float r = (axis[0] * covariance[0]) + (axis[1] * covariance[1]) + (axis[2] * covariance[2]);
+				float g = (axis[0] * covariance[1]) + (axis[1] * covariance[3]) + (axis[2] * covariance[4]);
+				float b = (axis[0] * covariance[2]) + (axis[1] * covariance[4]) + (axis[2] * covariance[5]);
+
+				float largest = (r < 0.0f) ? -r : r;
+				if ((g < 0.0f ? -g : g) > largest) { largest = (g < 0.0f) ? -g : g; }
+				if ((b < 0.0f ? -b : b) > largest) { largest = (b < 0.0f) ? -b : b; }
+				if (largest < 1.0f) { break; }
+
+				axis[0] = r / largest;
+				axis[1] = g / largest;
+				axis[2] = b / largest;
+			}
+
+			// the colors furthest apart on the line are the end points
+
+			float start[3], end[3];
+			float closest = 0.0f, furthest = 0.0f;
+			bool found = false;
+
+			for (uint32 i = 0; i < 16; i++)
+			{
+				if (!(a_Mask & (1 << i))) { continue; }
+
+				byte* pixel = &a_Block[i * 4];
+				float distance = (pixel[0] * axis[0]) + (pixel[1] * axis[1]) + (pixel[2] * axis[2]);
+
+				if (!found || distance < closest)
+				{
+					closest = distance;
+					for (uint32 c = 0; c < 3; c++) { end[c] = (float)pixel[c]; }
+				}
+				if (!found || distance > furthest)
+				{
+					furthest = distance;
+					for (uint32 c = 0; c < 3; c++) { start[c] = (float)pixel[c]; }
+				}
+				found = true;
+			}
+
+			color0 = QuantizeColor(start);
+			color1 = QuantizeColor(end);
+
+			int32 palette[4][3];
+			byte current[16];
+
+			GetPalette(palette, color0, color1, count);
+			uint32 error = FitColorIndices(indices, a_Block, a_Mask, palette, count);
+
+			for (uint32 k = 0; k < COMPRESS_REFINE_STEPS && error > 0; k++)
+			{
+				if (!RefineEndPoints(start, end, a_Block, indices, a_Mask, count)) { break; }
+
+				uint32 refined0 = QuantizeColor(start);
+				uint32 refined1 = QuantizeColor(end);
+				if (refined0 == color0 && refined1 == color1) { break; }
+
+				GetPalette(palette, refined0, refined1, count);
+				uint32 refined = FitColorIndices(current, a_Block, a_Mask, palette, count);
+				if (refined >= error) { break; }
+
+				color0 = refined0;
+				color1 = refined1;
+				error = refined;
+				memcpy(indices, current, 16);
+			}
+
+			if (color0 == color1 && error > 0)
+			{
+				uint32 single0, single1;
+				FitSingleColor(&single0, &single1, mean, count);
+
+				GetPalette(palette, single0, single1, count);
+				uint32 single = FitColorIndices(current, a_Block, a_Mask, palette, count);
+				if (single < error)
+				{
+					color0 = single0;
+					color1 = single1;
+					memcpy(indices, current, 16);
+				}
+			}
+
+			// four colors are used when the first end point is the larger one,
+			// swapping the end points swaps the first two indices and the last two
+
+			if (count == 4)
+			{
+				if (color0 == color1)
+				{
+					memset(indices, 0, 16);
+				}
+				else if (color0 < color1)
+				{
+					uint32 swap = color0;
+					color0 = color1;
+					color1 = swap;
+					for (uint32 i = 0; i < 16; i++) { indices[i] ^= 1; }
+				}
+			}
+			else if (color0 > color1)
+			{
+				uint32 swap = color0;
+				color0 = color1;
+				color1 = swap;
+				for (uint32 i = 0; i < 16; i++)
+				{
+					if (indices[i] < 2) { indices[i] ^= 1; }
+				}
+			}
+		}
+
+		a_Dst[0] = (byte)(color0 & 0xFF);
+		a_Dst[1] = (byte)(color0 >> 8);
+		a_Dst[2] = (byte)(color1 & 0xFF);
+		a_Dst[3] = (byte)(color1 >> 8);
+
+		for (uint32 y = 0; y < 4; y++)
+		{
+			byte* row = &indices[y * 4];
+			a_Dst[4 + y] = (byte)(row[0] | (row[1] << 2) | (row[2] << 4) | (row[3] << 6));
+		}
+	}
+
+	// constructs the eight values of an interpolated alpha block
+	static void GetAlphaValues(int32* a_Values, uint32 a_Alpha0, uint32 a_Alpha1)
+	{
+		a_Values[0] = a_Alpha0;
+		a_Values[1] = a_Alpha1;
+
+		if (a_Alpha0 > a_Alpha1)
+		{
+			for (uint32 i = 1; i < 7; i++)
+			{
+				a_Values[i + 1] = ((7 - i) * a_Alpha0 + i * a_Alpha1) / 7;
+			}
+		}
+		else
+		{
+			for (uint32 i = 1; i < 5; i++)
+			{
+				a_Values[i + 1] = ((5 - i) * a_Alpha0 + i * a_Alpha1) / 5;
+			}
+			a_Values[6] = 0;
+			a_Values[7] = 255;
+		}
+	}
+
+	static uint32 FitAlphaIndices(byte* a_Indices, byte* a_Block, int32* a_Values)
+	{
+		uint32 total = 0;
+
+		for (uint32 i = 0; i < 16; i++)
+		{
+			int32 alpha = a_Block[(i * 4) + 3];
+
+			uint32 best = 0xFFFFFFFF;
+			for (uint32 j = 0; j < 8; j++)
+			{
+				uint32 error = (uint32)((alpha - a_Values[j]) * (alpha - a_Values[j]));
+				if (error < best)
+				{
+					best = error;
+					a_Indices[i] = (byte)j;
+				}
+			}
+
+			total += best;
+		}
+
+		return total;
+	}
+
+	static void EncodeAlpha(byte* a_Dst, byte* a_Block)
+	{
+		// both ways of interpolating are tried, eight values between
+		// the lowest and highest alpha or six values between those that
+		// aren't 0 or 255, which are available as they are
+
+		uint32 lowest = 255, highest = 0;
+		uint32 inner_lowest = 255, inner_highest = 0;
+
+		for (uint32 i = 0; i < 16; i++)
+		{
+			uint32 alpha = a_Block[(i * 4) + 3];
+
+			if (alpha < lowest) { lowest = alpha; }
+			if (alpha > highest) { highest = alpha; }
+
+			if (alpha == 0 || alpha == 255) { continue; }
+
+			if (alpha < inner_lowest) { inner_lowest = alpha; }
+			if (alpha > inner_highest) { inner_highest = alpha; }
+		}
+
+		if (inner_lowest > inner_highest) { inner_lowest = inner_highest = 0; }
+
+		int32 values[8];
+		byte indices[16];
+		byte current[16];
+
+		uint32 alpha0 = inner_lowest;
+		uint32 alpha1 = inner_highest;
+		GetAlphaValues(values, alpha0, alpha1);
+		uint32 error = FitAlphaIndices(indices, a_Block, values);
+
+		if (error > 0 && highest > lowest)
+		{
+			GetAlphaValues(values, highest, lowest);
+			if (FitAlphaIndices(current, a_Block, values) < error)
+			{
+				alpha0 = highest;
+				alpha1 = lowest;
+				memcpy(indices, current, 16);
+			}
+		}
+
+		a_Dst[0] = (byte)alpha0;
+		a_Dst[1] = (byte)alpha1;
+
+		// two rows of 3-bit indices in every three bytes
+		for (uint32 j = 0; j < 2; j++)
+		{
+			byte* src = &indices[j * 8];
+
+			uint32 bits = 0;
+			for (uint32 i = 0; i < 8; i++) { bits |= src[i] << (i * 3); }
+
+			byte* dst = &a_Dst[2 + (j * 3)];
+			dst[0] = (byte)(bits & 0xFF);
+			dst[1] = (byte)((bits >> 8) & 0xFF);
+			dst[2] = (byte)((bits >> 16) & 0xFF);
+		}
+	}
+
+	inline byte* WriteDWord(byte* a_Dst, uint32 a_Value)
+	{
+		a_Dst[0] = (byte)(a_Value & 0xFF);
+		a_Dst[1] = (byte)((a_Value >> 8) & 0xFF);
+		a_Dst[2] = (byte)((a_Value >> 16) & 0xFF);
+		a_Dst[3] = (byte)((a_Value >> 24) & 0xFF);
+
+		return a_Dst + 4;
+	}
+
+#endif
+
+	ImageCompressed::ImageCompressed() : Image()
+	{
+		m_Levels = NULL;
+		m_LevelTotal = 0;
+		m_Format = 0;
+	}
+
+	ImageCompressed::~ImageCompressed()
+	{
+		if (m_Levels)
+		{
+			for (uint32 i = 0; i < m_LevelTotal; i++)
+			{
+				if (m_Levels[i].data) { delete [] m_Levels[i].data; }
+			}
+			delete [] m_Levels;
+		}
+	}
+
+	bool ImageCompressed::Parse(uint32 /*a_Options*/)
+	{
+		return true;
+	}
+
+	bool ImageCompressed::Compress(Image* a_Image, uint32 a_Format)
+	{
+		if (!a_Image || a_Image->GetBitDepth() == BPP_NATIVE)
+		{
+			TIL_ERROR_EXPLAIN("Images can't be compressed with this bit-depth.");
+			return false;
+		}
+
+		SetBPP(TIL_DEPTH_NATIVE);
+		m_Format = a_Format;
+
+		uint32 depth = a_Image->GetBitDepth() << 16;
+		uint32 bpp = (depth == TIL_DEPTH_R5G6B5 || depth == TIL_DEPTH_B5G6R5) ? 2 : 4;
+
+		m_LevelTotal = a_Image->GetFrameCount();
+		m_Levels = new Level[m_LevelTotal];
+		for (uint32 i = 0; i < m_LevelTotal; i++) { m_Levels[i].data = NULL; }
+
+		for (uint32 i = 0; i < m_LevelTotal; i++)
+		{
+			byte* src = a_Image->GetPixels(i);
+			if (!src)
+			{
+				TIL_ERROR_EXPLAIN("Frame %i has no pixels.", i);
+				return false;
+			}
+
+			Level* level = &m_Levels[i];
+			level->width = a_Image->GetWidth(i);
+			level->height = a_Image->GetHeight(i);
+			level->size = GetStoredSize(level->width, level->height, a_Format);
+			level->data = new byte[level->size];
+
+			if (!CompressPixels(
+				level->data,
+				src, level->width, level->height, a_Image->GetPitchX(i) * bpp,
+				depth, a_Format
+			))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ImageCompressed::CompressPixels(
+		byte* a_Dst,
+		byte* a_Src, uint32 a_Width, uint32 a_Height, uint32 a_Pitch,
+		uint32 a_Depth, uint32 a_Format
+	)
+	{
+		if (a_Format != TIL_COMPRESS_BC1 && a_Format != TIL_COMPRESS_BC3)
+		{
+			TIL_ERROR_EXPLAIN("Unknown block format: %i.", a_Format);
+			return false;
+		}
+
+		CompressJob job;
+		job.bpp = 4;
+		job.alpha = true;
+
+		// where the channels are in a pixel, in the order red, green, blue and alpha
+		switch (a_Depth)
+		{
+
+		case TIL_DEPTH_A8R8G8B8:
+			{
+				job.shift[0] = 16; job.shift[1] = 8; job.shift[2] = 0; job.shift[3] = 24;
+				break;
+			}
+
+		case TIL_DEPTH_A8B8G8R8:
+			{
+				job.shift[0] = 0; job.shift[1] = 8; job.shift[2] = 16; job.shift[3] = 24;
+				break;
+			}
+
+		case TIL_DEPTH_R8G8B8A8:
+			{
+				job.shift[0] = 24; job.shift[1] = 16; job.shift[2] = 8; job.shift[3] = 0;
+				break;
+			}
+
+		case TIL_DEPTH_B8G8R8A8:
+			{
+				job.shift[0] = 8; job.shift[1] = 16; job.shift[2] = 24; job.shift[3] = 0;
+				break;
+			}
+
+		case TIL_DEPTH_R8G8B8:
+			{
+				job.shift[0] = 16; job.shift[1] = 8; job.shift[2] = 0; job.shift[3] = 0;
+				job.alpha = false;
+				break;
+			}
+
+		case TIL_DEPTH_B8G8R8:
+			{
+				job.shift[0] = 0; job.shift[1] = 8; job.shift[2] = 16; job.shift[3] = 0;
+				job.alpha = false;
+				break;
+			}
+
+		case TIL_DEPTH_R5G6B5:
+			{
+				job.shift[0] = 11; job.shift[1] = 5; job.shift[2] = 0; job.shift[3] = 0;
+				job.bpp = 2;
+				job.alpha = false;
+				break;
+			}
+
+		case TIL_DEPTH_B5G6R5:
+			{
+				job.shift[0] = 0; job.shift[1] = 5; job.shift[2] = 11; job.shift[3] = 0;
+				job.bpp = 2;
+				job.alpha = false;
+				break;
+			}
+
+		default:
+			{
+				TIL_ERROR_EXPLAIN("Pixels can't be compressed with this bit-depth: %i.", a_Depth);
+				return false;
+			}
+
+		}
+
+		if (!a_Dst || !a_Src || a_Width == 0 || a_Height == 0)
+		{
+			TIL_ERROR_EXPLAIN("Can't compress an image of (%i, %i).", a_Width, a_Height);
+			return false;
+		}
+
+		TIL_PRINT_DEBUG("Compressing (%i, %i) to %s", a_Width, a_Height, (a_Format == TIL_COMPRESS_BC1) ? "BC1" : "BC3");
+
+		job.dst = a_Dst;
+		job.src = a_Src;
+		job.width = a_Width;
+		job.height = a_Height;
+		job.pitch = a_Pitch;
+		job.format = a_Format;
+
+		uint32 blocks_y = (a_Height + 3) >> 2;
+		Internal::ParallelFor(&ImageCompressed::CompressBand, &job, (blocks_y + COMPRESS_BAND_BLOCKS - 1) / COMPRESS_BAND_BLOCKS);
+
+		return true;
+	}
+
+	uint32 ImageCompressed::GetStoredSize(uint32 a_Width, uint32 a_Height, uint32 a_Format)
+	{
+		uint32 block_size = (a_Format == TIL_COMPRESS_BC1) ? 8 : 16;
+		return ((a_Width + 3) >> 2) * ((a_Height + 3) >> 2) * block_size;
+	}
+
+	void ImageCompressed::GatherBlock(byte* a_Dst, CompressJob* a_Job, uint32 a_X, uint32 a_Y)
+	{
+		for (uint32 y = 0; y < 4; y++)
+		{
+			uint32 sy = (a_Y + y < a_Job->height) ? (a_Y + y) : (a_Job->height - 1);
+			byte* row = a_Job->src + (sy * a_Job->pitch);
+
+			for (uint32 x = 0; x < 4; x++)
+			{
+				uint32 sx = (a_X + x < a_Job->width) ? (a_X + x) : (a_Job->width - 1);
+				byte* dst = &a_Dst[((y * 4) + x) * 4];
+
+				if (a_Job->bpp == 4)
+				{
+					color_32b pixel = ((color_32b*)row)[sx];
+
+					dst[0] = (byte)((pixel >> a_Job->shift[0]) & 0xFF);
+					dst[1] = (byte)((pixel >> a_Job->shift[1]) & 0xFF);
+					dst[2] = (byte)((pixel >> a_Job->shift[2]) & 0xFF);
+					dst[3] = a_Job->alpha ? (byte)((pixel >> a_Job->shift[3]) & 0xFF) : 255;
+				}
+				else
+				{
+					color_16b pixel = ((color_16b*)row)[sx];
+
+					byte r = (pixel >> a_Job->shift[0]) & 0x1F;
+					byte g = (pixel >> a_Job->shift[1]) & 0x3F;
+					byte b = (pixel >> a_Job->shift[2]) & 0x1F;
+
+					dst[0] = (r << 3) | (r >> 2);
+					dst[1] = (g << 2) | (g >> 4);
+					dst[2] = (b << 3) | (b >> 2);
+					dst[3] = 255;
+				}
+			}
+		}
+	}
+
+	void ImageCompressed::CompressBand(void* a_Data, uint32 a_Index)
+	{
+		CompressJob* job = (CompressJob*)a_Data;
+
+		uint32 blocks_x = (job->width + 3) >> 2;
+		uint32 blocks_y = (job->height + 3) >> 2;
+		uint32 block_size = (job->format == TIL_COMPRESS_BC1) ? 8 : 16;
+
+		uint32 top = a_Index * COMPRESS_BAND_BLOCKS;
+		uint32 bottom = (blocks_y - top > COMPRESS_BAND_BLOCKS) ? (top + COMPRESS_BAND_BLOCKS) : blocks_y;
+
+		byte* dst = job->dst + (top * blocks_x * block_size);
+		byte block[64];
+
+		for (uint32 by = top; by < bottom; by++)
+		{
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				GatherBlock(block, job, bx * 4, by * 4);
+
+				if (job->format == TIL_COMPRESS_BC1)
+				{
+					uint32 mask = 0;
+					for (uint32 i = 0; i < 16; i++)
+					{
+						if (block[(i * 4) + 3] >= 128) { mask |= (1 << i); }
+					}
+
+					EncodeColors(dst, block, mask);
+				}
+				else
+				{
+					EncodeAlpha(dst, block);
+					EncodeColors(dst + 8, block, 0xFFFF);
+				}
+
+				dst += block_size;
+			}
+		}
+	}
+
+	uint32 ImageCompressed::GetDDSSize()
+	{
+		if (m_LevelTotal == 0) { return 0; }
+
+		uint32 total = DDS_HEADER_SIZE + m_Levels[0].size;
+
+		for (uint32 i = 1; i < m_LevelTotal; i++)
+		{
+			Level* prev = &m_Levels[i - 1];
+			Level* curr = &m_Levels[i];
+
+			uint32 w = (prev->width > 1) ? (prev->width >> 1) : 1;
+			uint32 h = (prev->height > 1) ? (prev->height >> 1) : 1;
+			if (curr->width != w || curr->height != h) { return 0; }
+
+			total += curr->size;
+		}
+
+		return total;
+	}
+
+	bool ImageCompressed::WriteDDS(byte* a_Dst)
+	{
+		if (GetDDSSize() == 0)
+		{
+			TIL_ERROR_EXPLAIN("The frames can't be stored as the mipmaps of a DDS image.");
+			return false;
+		}
+
+		bool mipmaps = (m_LevelTotal > 1);
+
+		uint32 flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE;
+		if (mipmaps) { flags |= DDSD_MIPMAPCOUNT; }
+
+		uint32 caps = DDSCAPS_TEXTURE;
+		if (mipmaps) { caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP; }
+
+		memset(a_Dst, 0, DDS_HEADER_SIZE);
+
+		byte* dst = a_Dst;
+		dst = WriteDWord(dst, COMPRESS_FOURCC('D', 'D', 'S', ' '));
+
+		// surface description
+		dst = WriteDWord(dst, 124);
+		dst = WriteDWord(dst, flags);
+		dst = WriteDWord(dst, m_Levels[0].height);
+		dst = WriteDWord(dst, m_Levels[0].width);
+		dst = WriteDWord(dst, m_Levels[0].size);
+		dst = WriteDWord(dst, 0);
+		dst = WriteDWord(dst, m_LevelTotal);
+
+		// pixel format, after the reserved values
+		dst = a_Dst + 76;
+		dst = WriteDWord(dst, 32);
+		dst = WriteDWord(dst, DDPF_FOURCC);
+		dst = WriteDWord(dst, GetFourCC());
+
+		// capabilities, after the masks
+		dst = a_Dst + 108;
+		dst = WriteDWord(dst, caps);
+
+		dst = a_Dst + DDS_HEADER_SIZE;
+		for (uint32 i = 0; i < m_LevelTotal; i++)
+		{
+			memcpy(dst, m_Levels[i].data, m_Levels[i].size);
+			dst += m_Levels[i].size;
+		}
+
+		return true;
+	}
+
+	uint32 ImageCompressed::GetFrameCount()
+	{
+		return m_LevelTotal;
+	}
+
+	byte* ImageCompressed::GetPixels(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].data : NULL;
+	}
+
+	uint32 ImageCompressed::GetWidth(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].width : 0;
+	}
+
+	uint32 ImageCompressed::GetHeight(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].height : 0;
+	}
+
+	uint32 ImageCompressed::GetPitchX(uint32 a_Frame /*= 0*/)
+	{
+		return GetWidth(a_Frame);
+	}
+
+	uint32 ImageCompressed::GetPitchY(uint32 a_Frame /*= 0*/)
+	{
+		return GetHeight(a_Frame);
+	}
+
+	uint32 ImageCompressed::GetDataSize(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].size : 0;
+	}
+
+	uint32 ImageCompressed::GetFourCC()
+	{
+		return (m_Format == TIL_COMPRESS_BC1) ? COMPRESS_FOURCC('D', 'X', 'T', '1') : COMPRESS_FOURCC('D', 'X', 'T', '5');
+	}
+
+	uint32 ImageCompressed::GetBlockSize()
+	{
+		return (m_Format == TIL_COMPRESS_BC1) ? 8 : 16;
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -44,6 +44,7 @@
 
 #include "TILImageDDS.h"
 #include "TILInternal.h"
+#include "TILThreads.h"
 
 #if (TIL_FORMAT & TIL_FORMAT_DDS)
 
@@ -53,7 +54,7 @@
 	#define DDS_DEBUG(msg, ...)
 #endif
 
-//#include <math.h>
+#include <math.h>
 
 namespace til
 {
@@ -74,6 +75,12 @@ namespace til
 	static const uint32 DDS_FOURCC_RXGB               = DDS_FOURCC('R', 'X', 'G', 'B');
 	static const uint32 DDS_FOURCC_ATI1               = DDS_FOURCC('A', 'T', 'I', '1');
 	static const uint32 DDS_FOURCC_ATI2               = DDS_FOURCC('A', 'T', 'I', '2');
+	static const uint32 DDS_FOURCC_DX10               = DDS_FOURCC('D', 'X', '1', '0');
+
+	// BC6H and BC7 can only be stored with a DX10 header, these codes are used internally
+	static const uint32 DDS_FOURCC_BC6H               = DDS_FOURCC('B', 'C', '6', 'H');
+	static const uint32 DDS_FOURCC_BC6H_SIGNED        = DDS_FOURCC('B', 'C', '6', 'S');
+	static const uint32 DDS_FOURCC_BC7                = DDS_FOURCC('B', 'C', '7', 'L');
 
 	static const uint32 DDS_FOURCC_R16F               = 0x0000006F; // 16-bit float Red
 	static const uint32 DDS_FOURCC_G16R16F            = 0x00000070; // 16-bit float Red/Green
@@ -82,6 +89,24 @@ namespace til
 	static const uint32 DDS_FOURCC_G32R32F            = 0x00000073; // 32-bit float Red/Green
 	static const uint32 DDS_FOURCC_A32B32G32R32F      = 0x00000074; // 32-bit float RGBA
 
+	static const uint32 DDS_DXGI_R16G16B16A16_FLOAT   = 10;
+	static const uint32 DDS_DXGI_R8G8B8A8_UNORM       = 28;
+	static const uint32 DDS_DXGI_R8G8B8A8_UNORM_SRGB  = 29;
+	static const uint32 DDS_DXGI_BC1_UNORM            = 71;
+	static const uint32 DDS_DXGI_BC1_UNORM_SRGB       = 72;
+	static const uint32 DDS_DXGI_BC2_UNORM            = 74;
+	static const uint32 DDS_DXGI_BC2_UNORM_SRGB       = 75;
+	static const uint32 DDS_DXGI_BC3_UNORM            = 77;
+	static const uint32 DDS_DXGI_BC3_UNORM_SRGB       = 78;
+	static const uint32 DDS_DXGI_BC4_UNORM            = 80;
+	static const uint32 DDS_DXGI_BC5_UNORM            = 83;
+	static const uint32 DDS_DXGI_B8G8R8A8_UNORM       = 87;
+	static const uint32 DDS_DXGI_B8G8R8A8_UNORM_SRGB  = 91;
+	static const uint32 DDS_DXGI_BC6H_UF16            = 95;
+	static const uint32 DDS_DXGI_BC6H_SF16            = 96;
+	static const uint32 DDS_DXGI_BC7_UNORM            = 98;
+	static const uint32 DDS_DXGI_BC7_UNORM_SRGB       = 99;
+
 	#define DDSD_CAPS                    0x00000001
 	#define DDSD_HEIGHT                  0x00000002
 	#define DDSD_WIDTH                   0x00000004
@@ -104,6 +129,15 @@ namespace til
 	#define DDSCAPS2_CUBEMAP_NEGATIVEZ   0x00008000
 	#define DDSCAPS2_VOLUME              0x00200000
 
+	#define DDS_DIMENSION_TEXTURE1D      2
+	#define DDS_DIMENSION_TEXTURE2D      3
+	#define DDS_DIMENSION_TEXTURE3D      4
+
+	#define DDS_MISC_TEXTURECUBE         0x00000004
+
+	// rows per decoding task, must be a multiple of the block height
+	#define DDS_BAND_HEIGHT              64
+
 	struct DDPixelFormat
 	{
 		int size;
@@ -154,24 +188,1164 @@ namespace til
 		int textureStage;
 	};
 
-	struct DataDXT1
+	struct DDSHeaderDX10
+	{
+		int format;
+		int dimension;
+		int flags;
+		int arraySize;
+		int flags2;
+	};
+
+	// =========================================
+	// Block decoders
+	// =========================================
+
+	/*
+		The block decoders are templates specialized for every color depth,
+		so the palette of a block is constructed in the output format once 
+		and a row of four pixels is written with nothing more than a lookup
+		per pixel.
+
+		Every decoder works on a band of block rows, with a_Width and a_Height
+		being the dimensions of the band in pixels. Blocks on the right and
+		bottom edge are clipped if the dimensions aren't a multiple of four.
+	*/
+
+	// expands a 16-bit 565 color to 8 bits per channel by replicating the high bits
+	inline void ExpandColor(byte* a_Dst, byte* a_Src)
+	{
+		color_16b color = a_Src[0] | (a_Src[1] << 8);
+
+		byte r = (color >> 11) & 0x1F;
+		byte g = (color >> 5) & 0x3F;
+		byte b = (color) & 0x1F;
+
+		a_Dst[0] = (r << 3) | (r >> 2);
+		a_Dst[1] = (g << 2) | (g >> 4);
+		a_Dst[2] = (b << 3) | (b >> 2);
+	}
+
+	// decodes the four colors of a color block to 8 bits per channel
+	// returns false if the block uses the three-color mode, where the fourth color is transparent black
+	inline bool GetColors(byte a_Colors[4][3], byte* a_Src, bool a_ThreeColors)
+	{
+		byte* c0 = a_Colors[0];
+		byte* c1 = a_Colors[1];
+		ExpandColor(c0, a_Src);
+		ExpandColor(c1, a_Src + 2);
+
+		bool four_colors = ((a_Src[1] << 8) | a_Src[0]) > ((a_Src[3] << 8) | a_Src[2]);
+		if (four_colors || !a_ThreeColors)
+		{
+			for (uint32 i = 0; i < 3; i++)
+			{
+				a_Colors[2][i] = (2 * c0[i] + c1[i]) / 3;
+				a_Colors[3][i] = (c0[i] + 2 * c1[i]) / 3;
+			}
+
+			return true;
+		}
+		else
+		{
+			for (uint32 i = 0; i < 3; i++)
+			{
+				a_Colors[2][i] = (c0[i] + c1[i]) / 2;
+				a_Colors[3][i] = 0;
+			}
+
+			return false;
+		}
+	}
+
+	// constructs the four colors of a color block
+	// a_Alpha is the alpha of opaque colors, the three-color mode is only allowed for DXT1
+	template <typename F>
+	inline void ConstructColors(typename F::type* a_Colors, byte* a_Src, uint8 a_Alpha, bool a_ThreeColors)
+	{
+		byte colors[4][3];
+		bool four_colors = GetColors(colors, a_Src, a_ThreeColors);
+
+		for (uint32 i = 0; i < 4; i++)
+		{
+			a_Colors[i] = F::Construct(colors[i][0], colors[i][1], colors[i][2], a_Alpha);
+		}
+		if (!four_colors) { a_Colors[3] = F::Construct(0, 0, 0, 0); }
+	}
+
+	// decodes the eight values of an interpolated alpha block, 
+	// which is also used for the channels of ATI1 and ATI2
+	inline void GetAlphaValues(byte* a_Values, byte* a_Src)
+	{
+		uint32 a0 = a_Src[0];
+		uint32 a1 = a_Src[1];
+
+		a_Values[0] = a0;
+		a_Values[1] = a1;
+
+		if (a0 > a1)
+		{
+			for (uint32 i = 1; i < 7; i++)
+			{
+				a_Values[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+			}
+		}
+		else
+		{
+			for (uint32 i = 1; i < 5; i++)
+			{
+				a_Values[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+			}
+			a_Values[6] = 0;
+			a_Values[7] = 255;
+		}
+	}
+
+	// constructs the eight alpha values of an interpolated alpha block
+	template <typename F>
+	inline void ConstructAlpha(typename F::type* a_Alpha, byte* a_Src)
+	{
+		byte values[8];
+		GetAlphaValues(values, a_Src);
+
+		for (uint32 i = 0; i < 8; i++) { a_Alpha[i] = F::Construct(0, 0, 0, values[i]); }
+	}
+
+	// gets the 3-bit indices of a row in an interpolated alpha block
+	inline uint32 GetAlphaRow(byte* a_Src, uint32 a_Row)
+	{
+		byte* src = a_Src + 2 + ((a_Row >> 1) * 3);
+		uint32 bits = src[0] | (src[1] << 8) | (src[2] << 16);
+
+		return (bits >> ((a_Row & 1) * 12)) & 0xFFF;
+	}
+
+	// the columns and rows of a block that fall inside the image
+	inline uint32 GetBlockClip(uint32 a_Size, uint32 a_Block)
+	{
+		uint32 left = a_Size - (a_Block << 2);
+		return (left > 4) ? 4 : left;
+	}
+
+	template <typename F>
+	void DecodeDXT1(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		color colors[4];
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
+
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				ConstructColors<F>(colors, a_Src, 255, true);
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				if (rows == 4 && columns == 4)
+				{
+					for (uint32 y = 0; y < 4; y++)
+					{
+						uint32 bits = a_Src[4 + y];
+
+						dst[0] = colors[(bits     ) & 3];
+						dst[1] = colors[(bits >> 2) & 3];
+						dst[2] = colors[(bits >> 4) & 3];
+						dst[3] = colors[(bits >> 6)    ];
+
+						dst = (color*)((byte*)dst + a_Pitch);
+					}
+				}
+				else
+				{
+					for (uint32 y = 0; y < rows; y++)
+					{
+						uint32 bits = a_Src[4 + y];
+						for (uint32 x = 0; x < columns; x++) { dst[x] = colors[(bits >> (x * 2)) & 3]; }
+
+						dst = (color*)((byte*)dst + a_Pitch);
+					}
+				}
+
+				a_Src += 8;
+			}
+		}
+	}
+
+	template <typename F>
+	void DecodeDXT3(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		color colors[4];
+		color alpha[16];
+
+		// explicit alpha values are only four bits
+		for (uint32 i = 0; i < 16; i++) { alpha[i] = F::Construct(0, 0, 0, i * 17); }
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
+
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				ConstructColors<F>(colors, a_Src + 8, 0, false);
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				for (uint32 y = 0; y < rows; y++)
+				{
+					uint32 bits = a_Src[12 + y];
+					uint32 bits_alpha = a_Src[y * 2] | (a_Src[y * 2 + 1] << 8);
+
+					if (columns == 4)
+					{
+						dst[0] = colors[(bits     ) & 3] | alpha[(bits_alpha      ) & 0xF];
+						dst[1] = colors[(bits >> 2) & 3] | alpha[(bits_alpha >> 4 ) & 0xF];
+						dst[2] = colors[(bits >> 4) & 3] | alpha[(bits_alpha >> 8 ) & 0xF];
+						dst[3] = colors[(bits >> 6)    ] | alpha[(bits_alpha >> 12)      ];
+					}
+					else
+					{
+						for (uint32 x = 0; x < columns; x++) 
+						{ 
+							dst[x] = colors[(bits >> (x * 2)) & 3] | alpha[(bits_alpha >> (x * 4)) & 0xF]; 
+						}
+					}
+
+					dst = (color*)((byte*)dst + a_Pitch);
+				}
+
+				a_Src += 16;
+			}
+		}
+	}
+
+	// RXGB is DXT5 with the red channel stored in the alpha block
+	template <typename F, bool RXGB>
+	void DecodeDXT5(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		color colors[4];
+		color alpha[8];
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
+
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				if (RXGB)
+				{
+					byte values[8];
+					GetAlphaValues(values, a_Src);
+					for (uint32 i = 0; i < 8; i++) { alpha[i] = F::Construct(values[i], 0, 0, 0); }
+
+					byte rgb[4][3];
+					GetColors(rgb, a_Src + 8, false);
+					for (uint32 i = 0; i < 4; i++) { colors[i] = F::Construct(0, rgb[i][1], rgb[i][2], 255); }
+				}
+				else
+				{
+					ConstructAlpha<F>(alpha, a_Src);
+					ConstructColors<F>(colors, a_Src + 8, 0, false);
+				}
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				for (uint32 y = 0; y < rows; y++)
+				{
+					uint32 bits = a_Src[12 + y];
+					uint32 bits_alpha = GetAlphaRow(a_Src, y);
+
+					if (columns == 4)
+					{
+						dst[0] = colors[(bits     ) & 3] | alpha[(bits_alpha      ) & 7];
+						dst[1] = colors[(bits >> 2) & 3] | alpha[(bits_alpha >> 3 ) & 7];
+						dst[2] = colors[(bits >> 4) & 3] | alpha[(bits_alpha >> 6 ) & 7];
+						dst[3] = colors[(bits >> 6)    ] | alpha[(bits_alpha >> 9 )    ];
+					}
+					else
+					{
+						for (uint32 x = 0; x < columns; x++) 
+						{ 
+							dst[x] = colors[(bits >> (x * 2)) & 3] | alpha[(bits_alpha >> (x * 3)) & 7]; 
+						}
+					}
+
+					dst = (color*)((byte*)dst + a_Pitch);
+				}
+
+				a_Src += 16;
+			}
+		}
+	}
+
+	// restores the color of a premultiplied pixel
+	inline byte Unpremultiply(uint32 a_Value, uint32 a_Alpha)
+	{
+		if (a_Alpha == 0) { return 0; }
+
+		uint32 result = ((a_Value * 255) + (a_Alpha >> 1)) / a_Alpha;
+		return (result > 255) ? 255 : result;
+	}
+
+	// DXT2 and DXT4 are DXT3 and DXT5 with the colors multiplied by alpha,
+	// so the palette can't be combined with the alpha beforehand
+	template <typename F, bool Interpolated>
+	void DecodePremultiplied(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		byte colors[4][3];
+		byte alpha[16];
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
+
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				GetColors(colors, a_Src + 8, false);
+
+				if (Interpolated)
+				{
+					GetAlphaValues(alpha, a_Src);
+				}
+				else
+				{
+					for (uint32 i = 0; i < 16; i++) { alpha[i] = i * 17; }
+				}
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				for (uint32 y = 0; y < rows; y++)
+				{
+					uint32 bits = a_Src[12 + y];
+					uint32 bits_alpha = Interpolated ? GetAlphaRow(a_Src, y) : (a_Src[y * 2] | (a_Src[y * 2 + 1] << 8));
+
+					for (uint32 x = 0; x < columns; x++)
+					{
+						byte* rgb = colors[(bits >> (x * 2)) & 3];
+						uint32 a = Interpolated ? alpha[(bits_alpha >> (x * 3)) & 7] : alpha[(bits_alpha >> (x * 4)) & 0xF];
+
+						dst[x] = F::Construct(
+							Unpremultiply(rgb[0], a), 
+							Unpremultiply(rgb[1], a), 
+							Unpremultiply(rgb[2], a), 
+							a
+						);
+					}
+
+					dst = (color*)((byte*)dst + a_Pitch);
+				}
+
+				a_Src += 16;
+			}
+		}
+	}
+
+	// ATI1 stores a single channel, which is written as gray
+	template <typename F>
+	void DecodeATI1(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		byte values[8];
+		color colors[8];
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
+
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				GetAlphaValues(values, a_Src);
+				for (uint32 i = 0; i < 8; i++) { colors[i] = F::Construct(values[i], values[i], values[i], 255); }
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				for (uint32 y = 0; y < rows; y++)
+				{
+					uint32 bits = GetAlphaRow(a_Src, y);
+					for (uint32 x = 0; x < columns; x++) { dst[x] = colors[(bits >> (x * 3)) & 7]; }
+
+					dst = (color*)((byte*)dst + a_Pitch);
+				}
+
+				a_Src += 8;
+			}
+		}
+	}
+
+	// ATI2 stores the X and Y of a normal in two channels, Z is reconstructed 
+	// from the fact that the normal has unit length
+	template <typename F>
+	void DecodeATI2(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		byte values_x[8];
+		byte values_y[8];
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
+
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				GetAlphaValues(values_x, a_Src);
+				GetAlphaValues(values_y, a_Src + 8);
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				for (uint32 y = 0; y < rows; y++)
+				{
+					uint32 bits_x = GetAlphaRow(a_Src, y);
+					uint32 bits_y = GetAlphaRow(a_Src + 8, y);
+
+					for (uint32 x = 0; x < columns; x++)
+					{
+						int32 nx = (values_x[(bits_x >> (x * 3)) & 7] * 2) - 255;
+						int32 ny = (values_y[(bits_y >> (x * 3)) & 7] * 2) - 255;
+
+						int32 nz2 = (255 * 255) - (nx * nx) - (ny * ny);
+						uint32 nz = (nz2 > 0) ? (uint32)sqrt((double)nz2) : 0;
+
+						dst[x] = F::Construct((nx + 256) >> 1, (ny + 256) >> 1, (nz + 256) >> 1, 255);
+					}
+
+					dst = (color*)((byte*)dst + a_Pitch);
+				}
+
+				a_Src += 16;
+			}
+		}
+	}
+
+	// converts a 16-bit float to a byte, clamping it to [0, 1]
+	inline byte HalfToByte(uint32 a_Half)
+	{
+		uint32 exponent = (a_Half >> 10) & 0x1F;
+
+		// negative, zero and denormals that would round to zero
+		if ((a_Half & 0x8000) || exponent == 0) { return 0; }
+		// one and up, infinity and NaN
+		if (exponent >= 15) { return 255; }
+
+		// (1 + mantissa / 1024) * 2 ^ (exponent - 15) * 255
+		uint32 shift = 25 - exponent;
+		uint32 value = ((0x400 | (a_Half & 0x3FF)) * 255) + (1 << (shift - 1));
+
+		return (byte)(value >> shift);
+	}
+
+	template <typename F>
+	void DecodeHalf(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		for (uint32 y = 0; y < a_Height; y++)
+		{
+			color* dst = (color*)a_Dst;
+
+			for (uint32 x = 0; x < a_Width; x++)
+			{
+				dst[x] = F::Construct(
+					HalfToByte(a_Src[0] | (a_Src[1] << 8)),
+					HalfToByte(a_Src[2] | (a_Src[3] << 8)),
+					HalfToByte(a_Src[4] | (a_Src[5] << 8)),
+					HalfToByte(a_Src[6] | (a_Src[7] << 8))
+				);
+
+				a_Src += 8;
+			}
+
+			a_Dst += a_Pitch;
+		}
+	}
+
+	// =========================================
+	// BC6H and BC7
+	// =========================================
+
+	/*
+		BC6H and BC7 blocks start with a mode, which determines how the rest
+		of the 128 bits are laid out. Instead of a decoder per mode, the modes
+		are described in tables. A block is decoded to 16 pixels of 8 bits per 
+		channel, which are then written in the output format.
+	*/
+
+	// the subset of every pixel for two subsets, one bit per pixel
+	static const word DDS_PARTITION_2[64] = 
+	{
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+	};
+
+	// two bits per pixel for three subsets
+	static const uint32 DDS_PARTITION_3[64] = 
+	{
+		0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+		0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+		0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+		0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+		0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+		0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+		0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+		0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254
+	};
+
+	// the pixel of a subset whose index is stored with one bit less, 
+	// besides the first pixel, which is always the anchor of the first subset
+	static const byte DDS_ANCHOR_2[64] = 
+	{
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+	};
+
+	static const byte DDS_ANCHOR_3_1[64] = 
+	{
+		 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+		 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+		 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+		 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+	};
+
+	static const byte DDS_ANCHOR_3_2[64] = 
+	{
+		15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+		15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+		15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+		15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+	};
+
+	static const byte DDS_WEIGHTS_2[4]  = { 0, 21, 43, 64 };
+	static const byte DDS_WEIGHTS_3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	static const byte DDS_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	inline const byte* GetWeights(uint32 a_Bits)
 	{
-		byte c0_lo, c0_hi, c1_lo, c1_hi;
-		byte bits_0, bits_1, bits_2, bits_3;
+		return (a_Bits == 2) ? DDS_WEIGHTS_2 : ((a_Bits == 3) ? DDS_WEIGHTS_3 : DDS_WEIGHTS_4);
+	}
+
+	// reads a block as a stream of bits, starting with the least significant bit
+	class BlockBits
+	{
+
+	public:
+
+		BlockBits(byte* a_Src)
+		{
+			Internal::MemCpy(m_Data, a_Src, 16);
+			Internal::MemSet(m_Data + 16, 0, 4);
+			m_Position = 0;
+		}
+
+		// reads up to 24 bits
+		uint32 Read(uint32 a_Count)
+		{
+			byte* src = &m_Data[m_Position >> 3];
+			uint32 bits = 
+				(uint32)src[0] | ((uint32)src[1] << 8) | 
+				((uint32)src[2] << 16) | ((uint32)src[3] << 24);
+
+			uint32 result = (bits >> (m_Position & 7)) & ((1 << a_Count) - 1);
+			m_Position += a_Count;
+
+			return result;
+		}
+
+	private:
+
+		byte m_Data[20];
+		uint32 m_Position;
+
 	};
 
-	struct DataDXT5
+	// the subset of a pixel and whether its index is stored with one bit less
+	inline uint32 GetSubset(uint32 a_Subsets, uint32 a_Partition, uint32 a_Pixel, bool& a_Anchor)
 	{
-		byte alpha0, alpha1;
-		byte a_bits_0, a_bits_1, a_bits_2, a_bits_3, a_bits_4, a_bits_5;
+		if (a_Subsets == 2)
+		{
+			uint32 subset = (DDS_PARTITION_2[a_Partition] >> a_Pixel) & 1;
+			a_Anchor = (a_Pixel == 0 || (subset == 1 && a_Pixel == DDS_ANCHOR_2[a_Partition]));
+			return subset;
+		}
+		else if (a_Subsets == 3)
+		{
+			uint32 subset = (DDS_PARTITION_3[a_Partition] >> (a_Pixel * 2)) & 3;
+			a_Anchor = (
+				a_Pixel == 0 || 
+				(subset == 1 && a_Pixel == DDS_ANCHOR_3_1[a_Partition]) ||
+				(subset == 2 && a_Pixel == DDS_ANCHOR_3_2[a_Partition])
+			);
+			return subset;
+		}
+
+		a_Anchor = (a_Pixel == 0);
+		return 0;
+	}
+
+	struct ModeBC7
+	{
+		byte subsets;
+		byte partition_bits;
+		byte rotation_bits;
+		byte selection_bits;
+		byte color_bits;
+		byte alpha_bits;
+		byte endpoint_pbits;
+		byte shared_pbits;
+		byte index_bits;
+		byte index_bits2;
+	};
 
-		byte c0_lo, c0_hi, c1_lo, c1_hi;
-		byte bits_0, bits_1, bits_2, bits_3;
+	static const ModeBC7 DDS_MODES_BC7[8] = 
+	{
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
 	};
 
-#define GETCODE(x, y, data) (data & ((2 * (4 * y + x)) + 1))
+	// decodes a BC7 block to 16 pixels of RGBA
+	void DecodeBlockBC7(byte* a_Dst, byte* a_Src)
+	{
+		uint32 mode = 0;
+		while (mode < 8 && !(a_Src[0] & (1 << mode))) { mode++; }
+
+		// reserved
+		if (mode == 8)
+		{
+			Internal::MemSet(a_Dst, 0, 64);
+			return;
+		}
+
+		const ModeBC7& info = DDS_MODES_BC7[mode];
+
+		BlockBits bits(a_Src);
+		bits.Read(mode + 1);
+
+		uint32 partition = bits.Read(info.partition_bits);
+		uint32 rotation = bits.Read(info.rotation_bits);
+		uint32 selection = bits.Read(info.selection_bits);
+
+		uint32 endpoints = info.subsets * 2;
+		byte endpoint[6][4];
+
+		for (uint32 c = 0; c < 3; c++)
+		{
+			for (uint32 e = 0; e < endpoints; e++) { endpoint[e][c] = bits.Read(info.color_bits); }
+		}
+		for (uint32 e = 0; e < endpoints; e++) 
+		{ 
+			endpoint[e][3] = info.alpha_bits ? bits.Read(info.alpha_bits) : 255; 
+		}
+
+		// the lowest bit of the endpoints, stored per endpoint or per subset
+
+		uint32 pbit[6] = { 0 };
+		uint32 pbits = info.endpoint_pbits | info.shared_pbits;
+		if (info.endpoint_pbits)
+		{
+			for (uint32 e = 0; e < endpoints; e++) { pbit[e] = bits.Read(1); }
+		}
+		else if (info.shared_pbits)
+		{
+			for (uint32 s = 0; s < info.subsets; s++) { pbit[s * 2] = pbit[s * 2 + 1] = bits.Read(1); }
+		}
+
+		for (uint32 e = 0; e < endpoints; e++)
+		{
+			for (uint32 c = 0; c < 4; c++)
+			{
+				uint32 precision = (c < 3) ? info.color_bits : info.alpha_bits;
+				if (precision == 0) { continue; }
+
+				precision += pbits;
+				uint32 value = (endpoint[e][c] << pbits) | pbit[e];
+				value <<= (8 - precision);
+
+				endpoint[e][c] = value | (value >> precision);
+			}
+		}
+
+		// indices
+
+		byte subset[16];
+		byte index[16];
+		byte index2[16];
+
+		for (uint32 i = 0; i < 16; i++)
+		{
+			bool anchor;
+			subset[i] = GetSubset(info.subsets, partition, i, anchor);
+			index[i] = bits.Read(info.index_bits - (anchor ? 1 : 0));
+		}
+		if (info.index_bits2)
+		{
+			for (uint32 i = 0; i < 16; i++) { index2[i] = bits.Read(info.index_bits2 - ((i == 0) ? 1 : 0)); }
+		}
+
+		// interpolate
+
+		byte* index_color = index;
+		byte* index_alpha = index;
+		uint32 bits_color = info.index_bits;
+		uint32 bits_alpha = info.index_bits;
+		if (info.index_bits2)
+		{
+			if (selection)
+			{
+				index_color = index2;
+				bits_color = info.index_bits2;
+			}
+			else
+			{
+				index_alpha = index2;
+				bits_alpha = info.index_bits2;
+			}
+		}
+
+		const byte* weights_color = GetWeights(bits_color);
+		const byte* weights_alpha = GetWeights(bits_alpha);
+
+		byte* dst = a_Dst;
+		for (uint32 i = 0; i < 16; i++)
+		{
+			byte* e0 = endpoint[subset[i] * 2];
+			byte* e1 = endpoint[subset[i] * 2 + 1];
+
+			uint32 w = weights_color[index_color[i]];
+			for (uint32 c = 0; c < 3; c++) { dst[c] = (((64 - w) * e0[c]) + (w * e1[c]) + 32) >> 6; }
+
+			w = weights_alpha[index_alpha[i]];
+			dst[3] = (((64 - w) * e0[3]) + (w * e1[3]) + 32) >> 6;
+
+			if (rotation)
+			{
+				byte temp = dst[3];
+				dst[3] = dst[rotation - 1];
+				dst[rotation - 1] = temp;
+			}
+
+			dst += 4;
+		}
+	}
+
+	// fields of a BC6H mode, in the order of the endpoints and their color channels
+
+	enum FieldBC6H
+	{
+		R0, G0, B0,
+		R1, G1, B1,
+		R2, G2, B2,
+		R3, G3, B3,
+		FIELD_END
+	};
+
+	// a run of bits that is stored at a_Shift of a field
+	struct RunBC6H
+	{
+		byte field;
+		byte shift;
+		byte count;
+	};
+
+	struct ModeBC6H
+	{
+		byte code;
+		bool transformed;
+		byte endpoint_bits;
+		byte delta_bits[3];
+		RunBC6H layout[28];
+	};
+
+	/*
+		The endpoint bits of BC6H are interleaved differently for every mode. 
+		Runs that are stored in reverse are split into single bits.
+	*/
+	static const ModeBC6H DDS_MODES_BC6H[14] = 
+	{
+		{ 0x00, true, 10, { 5, 5, 5 }, {
+			{ G2, 4, 1 }, { B2, 4, 1 }, { B3, 4, 1 }, { R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, 
+			{ R1, 0, 5 }, { G3, 4, 1 }, { G2, 0, 4 }, { G1, 0, 5 }, { B3, 0, 1 }, { G3, 0, 4 }, 
+			{ B1, 0, 5 }, { B3, 1, 1 }, { B2, 0, 4 }, { R2, 0, 5 }, { B3, 2, 1 }, { R3, 0, 5 }, 
+			{ B3, 3, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x01, true, 7, { 6, 6, 6 }, {
+			{ G2, 5, 1 }, { G3, 4, 1 }, { G3, 5, 1 }, { R0, 0, 7 }, { B3, 0, 1 }, { B3, 1, 1 }, 
+			{ B2, 4, 1 }, { G0, 0, 7 }, { B2, 5, 1 }, { B3, 2, 1 }, { G2, 4, 1 }, { B0, 0, 7 }, 
+			{ B3, 3, 1 }, { B3, 5, 1 }, { B3, 4, 1 }, { R1, 0, 6 }, { G2, 0, 4 }, { G1, 0, 6 }, 
+			{ G3, 0, 4 }, { B1, 0, 6 }, { B2, 0, 4 }, { R2, 0, 6 }, { R3, 0, 6 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x02, true, 11, { 5, 4, 4 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 5 }, { R0, 10, 1 }, { G2, 0, 4 }, 
+			{ G1, 0, 4 }, { G0, 10, 1 }, { B3, 0, 1 }, { G3, 0, 4 }, { B1, 0, 4 }, { B0, 10, 1 }, 
+			{ B3, 1, 1 }, { B2, 0, 4 }, { R2, 0, 5 }, { B3, 2, 1 }, { R3, 0, 5 }, { B3, 3, 1 }, 
+			{ FIELD_END, 0, 0 } 
+		} },
+		{ 0x06, true, 11, { 4, 5, 4 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 4 }, { R0, 10, 1 }, { G3, 4, 1 }, 
+			{ G2, 0, 4 }, { G1, 0, 5 }, { G0, 10, 1 }, { G3, 0, 4 }, { B1, 0, 4 }, { B0, 10, 1 }, 
+			{ B3, 1, 1 }, { B2, 0, 4 }, { R2, 0, 4 }, { B3, 0, 1 }, { B3, 2, 1 }, { R3, 0, 4 }, 
+			{ G2, 4, 1 }, { B3, 3, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x0A, true, 11, { 4, 4, 5 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 4 }, { R0, 10, 1 }, { B2, 4, 1 }, 
+			{ G2, 0, 4 }, { G1, 0, 4 }, { G0, 10, 1 }, { B3, 0, 1 }, { G3, 0, 4 }, { B1, 0, 5 }, 
+			{ B0, 10, 1 }, { B2, 0, 4 }, { R2, 0, 4 }, { B3, 1, 1 }, { B3, 2, 1 }, { R3, 0, 4 }, 
+			{ B3, 4, 1 }, { B3, 3, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x0E, true, 9, { 5, 5, 5 }, {
+			{ R0, 0, 9 }, { B2, 4, 1 }, { G0, 0, 9 }, { G2, 4, 1 }, { B0, 0, 9 }, { B3, 4, 1 }, 
+			{ R1, 0, 5 }, { G3, 4, 1 }, { G2, 0, 4 }, { G1, 0, 5 }, { B3, 0, 1 }, { G3, 0, 4 }, 
+			{ B1, 0, 5 }, { B3, 1, 1 }, { B2, 0, 4 }, { R2, 0, 5 }, { B3, 2, 1 }, { R3, 0, 5 }, 
+			{ B3, 3, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x12, true, 8, { 6, 5, 5 }, {
+			{ R0, 0, 8 }, { G3, 4, 1 }, { B2, 4, 1 }, { G0, 0, 8 }, { B3, 2, 1 }, { G2, 4, 1 }, 
+			{ B0, 0, 8 }, { B3, 3, 1 }, { B3, 4, 1 }, { R1, 0, 6 }, { G2, 0, 4 }, { G1, 0, 5 }, 
+			{ B3, 0, 1 }, { G3, 0, 4 }, { B1, 0, 5 }, { B3, 1, 1 }, { B2, 0, 4 }, { R2, 0, 6 }, 
+			{ R3, 0, 6 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x16, true, 8, { 5, 6, 5 }, {
+			{ R0, 0, 8 }, { B3, 0, 1 }, { B2, 4, 1 }, { G0, 0, 8 }, { G2, 5, 1 }, { G2, 4, 1 }, 
+			{ B0, 0, 8 }, { G3, 5, 1 }, { B3, 4, 1 }, { R1, 0, 5 }, { G3, 4, 1 }, { G2, 0, 4 }, 
+			{ G1, 0, 6 }, { G3, 0, 4 }, { B1, 0, 5 }, { B3, 1, 1 }, { B2, 0, 4 }, { R2, 0, 5 }, 
+			{ B3, 2, 1 }, { R3, 0, 5 }, { B3, 3, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x1A, true, 8, { 5, 5, 6 }, {
+			{ R0, 0, 8 }, { B3, 1, 1 }, { B2, 4, 1 }, { G0, 0, 8 }, { B2, 5, 1 }, { G2, 4, 1 }, 
+			{ B0, 0, 8 }, { B3, 5, 1 }, { B3, 4, 1 }, { R1, 0, 5 }, { G3, 4, 1 }, { G2, 0, 4 }, 
+			{ G1, 0, 5 }, { B3, 0, 1 }, { G3, 0, 4 }, { B1, 0, 6 }, { B2, 0, 4 }, { R2, 0, 5 }, 
+			{ B3, 2, 1 }, { R3, 0, 5 }, { B3, 3, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x1E, false, 6, { 6, 6, 6 }, {
+			{ R0, 0, 6 }, { G3, 4, 1 }, { B3, 0, 1 }, { B3, 1, 1 }, { B2, 4, 1 }, { G0, 0, 6 }, 
+			{ G2, 5, 1 }, { B2, 5, 1 }, { B3, 2, 1 }, { G2, 4, 1 }, { B0, 0, 6 }, { G3, 5, 1 }, 
+			{ B3, 3, 1 }, { B3, 5, 1 }, { B3, 4, 1 }, { R1, 0, 6 }, { G2, 0, 4 }, { G1, 0, 6 }, 
+			{ G3, 0, 4 }, { B1, 0, 6 }, { B2, 0, 4 }, { R2, 0, 6 }, { R3, 0, 6 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x03, false, 10, { 10, 10, 10 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 10 }, { G1, 0, 10 }, { B1, 0, 10 }, 
+			{ FIELD_END, 0, 0 } 
+		} },
+		{ 0x07, true, 11, { 9, 9, 9 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 9 }, { R0, 10, 1 }, { G1, 0, 9 }, 
+			{ G0, 10, 1 }, { B1, 0, 9 }, { B0, 10, 1 }, { FIELD_END, 0, 0 } 
+		} },
+		{ 0x0B, true, 12, { 8, 8, 8 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 8 }, { R0, 11, 1 }, { R0, 10, 1 }, 
+			{ G1, 0, 8 }, { G0, 11, 1 }, { G0, 10, 1 }, { B1, 0, 8 }, { B0, 11, 1 }, { B0, 10, 1 }, 
+			{ FIELD_END, 0, 0 } 
+		} },
+		{ 0x0F, true, 16, { 4, 4, 4 }, {
+			{ R0, 0, 10 }, { G0, 0, 10 }, { B0, 0, 10 }, { R1, 0, 4 }, 
+			{ R0, 15, 1 }, { R0, 14, 1 }, { R0, 13, 1 }, { R0, 12, 1 }, { R0, 11, 1 }, { R0, 10, 1 }, 
+			{ G1, 0, 4 }, 
+			{ G0, 15, 1 }, { G0, 14, 1 }, { G0, 13, 1 }, { G0, 12, 1 }, { G0, 11, 1 }, { G0, 10, 1 }, 
+			{ B1, 0, 4 }, 
+			{ B0, 15, 1 }, { B0, 14, 1 }, { B0, 13, 1 }, { B0, 12, 1 }, { B0, 11, 1 }, { B0, 10, 1 }, 
+			{ FIELD_END, 0, 0 } 
+		} },
+	};
+
+	inline int32 SignExtend(int32 a_Value, uint32 a_Bits)
+	{
+		return (a_Value & (1 << (a_Bits - 1))) ? (a_Value - (1 << a_Bits)) : a_Value;
+	}
+
+	// scales an endpoint to 16 bits
+	inline int32 UnquantizeBC6H(int32 a_Value, uint32 a_Bits, bool a_Signed)
+	{
+		if (!a_Signed)
+		{
+			if (a_Bits >= 15 || a_Value == 0) { return a_Value; }
+			if (a_Value == (1 << a_Bits) - 1) { return 0xFFFF; }
+
+			return ((a_Value << 16) + 0x8000) >> a_Bits;
+		}
+		else
+		{
+			if (a_Bits >= 16) { return a_Value; }
+
+			bool negative = (a_Value < 0);
+			int32 value = negative ? -a_Value : a_Value;
+
+			if (value >= (1 << (a_Bits - 1)) - 1)
+			{
+				value = 0x7FFF;
+			}
+			else if (value != 0)
+			{
+				value = ((value << 15) + 0x4000) >> (a_Bits - 1);
+			}
+
+			return negative ? -value : value;
+		}
+	}
+
+	// scales an interpolated value to the bits of a 16-bit float
+	inline word FinishBC6H(int32 a_Value, bool a_Signed)
+	{
+		if (!a_Signed) { return (word)((a_Value * 31) >> 6); }
+
+		if (a_Value < 0) { return (word)(0x8000 | (((-a_Value) * 31) >> 5)); }
+		return (word)((a_Value * 31) >> 5);
+	}
+
+#endif
+
+	void ImageDDS::DecodeBC6H(word* a_Dst, byte* a_Src, bool a_Signed)
+	{
+		BlockBits bits(a_Src);
+
+		uint32 code = bits.Read(2);
+		if (code > 1) { code |= bits.Read(3) << 2; }
+
+		const ModeBC6H* info = NULL;
+		for (uint32 i = 0; i < 14; i++)
+		{
+			if (DDS_MODES_BC6H[i].code == code) 
+			{ 
+				info = &DDS_MODES_BC6H[i]; 
+				break; 
+			}
+		}
+
+		// reserved
+		if (!info)
+		{
+			for (uint32 i = 0; i < 48; i++) { a_Dst[i] = 0; }
+			return;
+		}
+
+		int32 endpoint[4][3] = { { 0 } };
+		for (const RunBC6H* run = info->layout; run->field != FIELD_END; run++)
+		{
+			endpoint[run->field / 3][run->field % 3] |= bits.Read(run->count) << run->shift;
+		}
+
+		// the two lowest bits are set only for modes with a single subset
+		uint32 subsets = (code & 3) == 3 ? 1 : 2;
+		uint32 partition = (subsets == 2) ? bits.Read(5) : 0;
+		uint32 endpoints = subsets * 2;
+		uint32 precision = info->endpoint_bits;
+
+		for (uint32 c = 0; c < 3; c++)
+		{
+			if (a_Signed) { endpoint[0][c] = SignExtend(endpoint[0][c], precision); }
+
+			for (uint32 e = 1; e < endpoints; e++)
+			{
+				if (info->transformed)
+				{
+					int32 delta = SignExtend(endpoint[e][c], info->delta_bits[c]);
+					endpoint[e][c] = (endpoint[0][c] + delta) & ((1 << precision) - 1);
+				}
+				if (a_Signed) { endpoint[e][c] = SignExtend(endpoint[e][c], precision); }
+			}
+
+			for (uint32 e = 0; e < endpoints; e++)
+			{
+				endpoint[e][c] = UnquantizeBC6H(endpoint[e][c], precision, a_Signed);
+			}
+		}
+
+		uint32 index_bits = (subsets == 2) ? 3 : 4;
+		const byte* weights = GetWeights(index_bits);
+
+		word* dst = a_Dst;
+		for (uint32 i = 0; i < 16; i++)
+		{
+			bool anchor;
+			uint32 subset = GetSubset(subsets, partition, i, anchor);
+			uint32 w = weights[bits.Read(index_bits - (anchor ? 1 : 0))];
+
+			int32* e0 = endpoint[subset * 2];
+			int32* e1 = endpoint[subset * 2 + 1];
+
+			for (uint32 c = 0; c < 3; c++)
+			{
+				int32 value = (((64 - (int32)w) * e0[c]) + ((int32)w * e1[c]) + 32) >> 6;
+				dst[c] = FinishBC6H(value, a_Signed);
+			}
+
+			dst += 3;
+		}
+	}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	// decodes a BC6H block to 16 pixels of RGBA, clamped to [0, 1]
+	template <bool Signed>
+	void DecodeBlockBC6H(byte* a_Dst, byte* a_Src)
+	{
+		word pixels[48];
+		ImageDDS::DecodeBC6H(pixels, a_Src, Signed);
+
+		word* src = pixels;
+		for (uint32 i = 0; i < 16; i++)
+		{
+			a_Dst[0] = HalfToByte(src[0]);
+			a_Dst[1] = HalfToByte(src[1]);
+			a_Dst[2] = HalfToByte(src[2]);
+			a_Dst[3] = 255;
+
+			a_Dst += 4;
+			src += 3;
+		}
+	}
+
+	typedef void (*PixelBlockFunc)(byte* a_Dst, byte* a_Src);
+
+	// writes blocks that are decoded to RGBA first
+	template <typename F, PixelBlockFunc D>
+	void DecodePixelBlocks(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
+	{
+		typedef typename F::type color;
+
+		byte pixels[64];
+
+		uint32 blocks_x = (a_Width + 3) >> 2;
+		uint32 blocks_y = (a_Height + 3) >> 2;
+
+		for (uint32 by = 0; by < blocks_y; by++)
+		{
+			byte* row = a_Dst + (by * 4 * a_Pitch);
+			uint32 rows = GetBlockClip(a_Height, by);
 
-	typedef void (*ColorFunc)(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& a_Alpha);
+			for (uint32 bx = 0; bx < blocks_x; bx++)
+			{
+				D(pixels, a_Src);
+
+				color* dst = (color*)row + (bx * 4);
+				uint32 columns = GetBlockClip(a_Width, bx);
+
+				for (uint32 y = 0; y < rows; y++)
+				{
+					byte* src = &pixels[y * 16];
+					for (uint32 x = 0; x < columns; x++) 
+					{ 
+						dst[x] = F::Construct(src[0], src[1], src[2], src[3]); 
+						src += 4;
+					}
+
+					dst = (color*)((byte*)dst + a_Pitch);
+				}
+
+				a_Src += 16;
+			}
+		}
+	}
+
+	typedef void (*BlockFunc)(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height);
+
+	template <typename F>
+	BlockFunc GetBlockFunc(uint32 a_Format)
+	{
+		if (a_Format == DDS_FOURCC_DXT1)
+		{
+			return DecodeDXT1<F>;
+		}
+		else if (a_Format == DDS_FOURCC_DXT3)
+		{
+			return DecodeDXT3<F>;
+		}
+		else if (a_Format == DDS_FOURCC_DXT5)
+		{
+			return DecodeDXT5<F, false>;
+		}
+		else if (a_Format == DDS_FOURCC_RXGB)
+		{
+			return DecodeDXT5<F, true>;
+		}
+		else if (a_Format == DDS_FOURCC_DXT2)
+		{
+			return DecodePremultiplied<F, false>;
+		}
+		else if (a_Format == DDS_FOURCC_DXT4)
+		{
+			return DecodePremultiplied<F, true>;
+		}
+		else if (a_Format == DDS_FOURCC_ATI1)
+		{
+			return DecodeATI1<F>;
+		}
+		else if (a_Format == DDS_FOURCC_ATI2)
+		{
+			return DecodeATI2<F>;
+		}
+		else if (a_Format == DDS_FOURCC_A16B16G16R16F)
+		{
+			return DecodeHalf<F>;
+		}
+		else if (a_Format == DDS_FOURCC_BC6H)
+		{
+			return DecodePixelBlocks<F, DecodeBlockBC6H<false> >;
+		}
+		else if (a_Format == DDS_FOURCC_BC6H_SIGNED)
+		{
+			return DecodePixelBlocks<F, DecodeBlockBC6H<true> >;
+		}
+		else if (a_Format == DDS_FOURCC_BC7)
+		{
+			return DecodePixelBlocks<F, DecodeBlockBC7>;
+		}
+
+		return NULL;
+	}
+
+	// =========================================
+	// Color functions
+	// =========================================
 
 	void ImageDDS::ColorFunc_A8B8G8R8(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& a_Alpha)
 	{
@@ -205,7 +1379,7 @@ namespace til
 		*dst = Construct_32b_R8G8B8A8(src[0], src[1], src[2], a_Alpha);
 	}
 
-	void ImageDDS::ColorFunc_B8G8R8(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& a_Alpha)
+	void ImageDDS::ColorFunc_B8G8R8(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& /*a_Alpha*/)
 	{
 		color_32b* dst = (color_32b*)&a_Dst[a_DstIndex];
 		byte* src = &a_Src[a_SrcIndex * 4];
@@ -213,7 +1387,7 @@ namespace til
 		*dst = Construct_32b_B8G8R8(src[0], src[1], src[2]);
 	}
 
-	void ImageDDS::ColorFunc_R8G8B8(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& a_Alpha)
+	void ImageDDS::ColorFunc_R8G8B8(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& /*a_Alpha*/)
 	{
 		color_32b* dst = (color_32b*)&a_Dst[a_DstIndex];
 		byte* src = &a_Src[a_SrcIndex * 4];
@@ -221,7 +1395,7 @@ namespace til
 		*dst = Construct_32b_R8G8B8(src[0], src[1], src[2]);
 	}
 
-	void ImageDDS::ColorFunc_B5G6R5(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& a_Alpha)
+	void ImageDDS::ColorFunc_B5G6R5(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& /*a_Alpha*/)
 	{
 		color_16b* dst = (color_16b*)&a_Dst[a_DstIndex];
 		byte* src = &a_Src[a_SrcIndex * 4];
@@ -229,7 +1403,7 @@ namespace til
 		*dst = Construct_16b_B5G6R5(src[0], src[1], src[2]);
 	}
 
-	void ImageDDS::ColorFunc_R5G6B5(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& a_Alpha)
+	void ImageDDS::ColorFunc_R5G6B5(byte* a_Dst, uint32 a_DstIndex, byte* a_Src, uint32 a_SrcIndex, byte& /*a_Alpha*/)
 	{
 		color_16b* dst = (color_16b*)&a_Dst[a_DstIndex];
 		byte* src = &a_Src[a_SrcIndex * 4];
@@ -242,25 +1416,38 @@ namespace til
 	ImageDDS::ImageDDS() : Image()
 	{
 		m_Data = NULL;
+		m_Tasks = NULL;
 		m_Pixels = NULL;
-		m_Colors = NULL;
-		m_Alpha = NULL;
 		m_ColorFunc = NULL;
+		m_BlockFunc = NULL;
 		m_MipMap = NULL;
 		m_MipMapCurrent = 0;
 		m_MipMapTotal = 0;
+		m_SkipSize = 0;
+		m_Deferred = false;
+		m_Decoded = 0;
 	}
 
 	ImageDDS::~ImageDDS()
 	{
-		if (m_Data) { delete m_Data; }
+		if (m_Data) { delete [] m_Data; }
+		if (m_Tasks) { delete [] m_Tasks; }
 		if (m_Pixels) { delete [] m_Pixels; }
-		if (m_Colors) { delete m_Colors; }
-		if (m_Alpha) { delete m_Alpha; }
-		if (m_MipMap) { delete [] m_MipMap; }
+		if (m_MipMap)
+		{
+			// native data points into a single buffer
+			if (m_BPPIdent != BPP_NATIVE)
+			{
+				for (uint32 i = 0; i < m_MipMapTotal * m_CubeMap; i++)
+				{
+					if (m_MipMap[i].data) { delete [] m_MipMap[i].data; }
+				}
+			}
+			delete [] m_MipMap;
+		}
 	}
 
-	bool ImageDDS::Parse(uint32 a_ColorDepth)
+	bool ImageDDS::Parse(uint32 a_Options)
 	{
 		dword header;
 		m_Stream->ReadDWord(&header);
@@ -275,10 +1462,20 @@ namespace til
 		m_Stream->Read(&ddsd, sizeof(DDSurfaceDesc));
 
 		m_Format = 0;
+		m_DXGIFormat = 0;
+		m_ArraySize = 1;
 		m_InternalBPP = 0;
 		m_InternalDepth = 0;
 
-		if (ddsd.format.fourCC != 0)
+		DDSHeaderDX10 dx10;
+		bool extended = (ddsd.format.fourCC == DDS_FOURCC_DX10);
+
+		if (extended)
+		{
+			m_Stream->Read(&dx10, sizeof(DDSHeaderDX10));
+			if (!ParseFormatDX10(dx10.format)) { return false; }
+		}
+		else if (ddsd.format.fourCC != 0)
 		{
 			m_Format = ddsd.format.fourCC;
 
@@ -339,7 +1536,7 @@ namespace til
 			case DDS_FOURCC_A16B16G16R16F:
 				{
 					DDS_DEBUG("Format: A16B16G16R16F");
-					m_BlockSize = 16;
+					m_BlockSize = 8;
 					break;
 				}
 			default:
@@ -385,7 +1582,7 @@ namespace til
 					DDS_DEBUG("Depth: B8G8R8");
 				}
 			}
-			else
+			else if (m_BPPIdent != BPP_NATIVE)
 			{
 				TIL_ERROR_EXPLAIN("Unknown bit-depth: %d", ddsd.format.bpp);
 				return false;
@@ -395,12 +1592,15 @@ namespace til
 		m_Offset = 0;
 		m_Width = ddsd.width;
 		m_Height = ddsd.height;
-		m_Depth = ddsd.depth;
+
+		// the depth is only valid for volume textures
+		bool volume = (ddsd.caps.caps2 & DDSCAPS2_VOLUME) || (extended && dx10.dimension == DDS_DIMENSION_TEXTURE3D);
+		m_Depth = (volume && ddsd.depth > 1) ? ddsd.depth : 1;
 
 		m_MipMapTotal = (ddsd.mipMapLevels >= 1 ? ddsd.mipMapLevels : 1);
 
 		DDS_DEBUG("Dimensions: (%d, %d)", m_Width, m_Height);
-		DDS_DEBUG("Depth: %d", m_Depth);
+		DDS_DEBUG("Slices: %d", m_Depth);
 		DDS_DEBUG("Mipmaps: %d", m_MipMapTotal);
 
 		m_CubeMap = 1;
@@ -418,7 +1618,49 @@ namespace til
 			m_CubeMap--;
 		}
 
+		// every element of an array can be a cubemap
+		if (extended)
+		{
+			m_ArraySize = (dx10.arraySize > 1) ? dx10.arraySize : 1;
+			m_CubeMap = m_ArraySize * ((dx10.flags & DDS_MISC_TEXTURECUBE) ? 6 : 1);
+
+			DDS_DEBUG("Array size: %d", m_ArraySize);
+		}
+
+		// mipmaps larger than the size hint are skipped, 
+		// the first one that is left becomes the first frame
+
+		uint32 size = TIL_LOAD_GETSIZE(a_Options);
+		while (size > 0 && m_MipMapTotal > 1)
+		{
+			uint32 w = (m_Width > 1) ? (m_Width >> 1) : 1;
+			uint32 h = (m_Height > 1) ? (m_Height >> 1) : 1;
+			if (w < size && h < size) { break; }
+
+			m_SkipSize += GetStoredSize(m_Width, m_Height) * m_Depth;
+
+			m_Width = w;
+			m_Height = h;
+			m_Depth = (m_Depth > 1) ? (m_Depth >> 1) : 1;
+			m_MipMapTotal--;
+		}
+
+		if (m_SkipSize > 0)
+		{
+			DDS_DEBUG("Skipped mipmaps for size %i: %i bytes per face", size, m_SkipSize);
+			DDS_DEBUG("Dimensions: (%d, %d)", m_Width, m_Height);
+		}
+
+		if (m_RowFunc && !CheckRegion(m_Width, m_Height)) { return false; }
+
 		m_MipMap = new MipMap[m_MipMapTotal * m_CubeMap];
+		for (uint32 i = 0; i < m_MipMapTotal * m_CubeMap; i++) { m_MipMap[i].data = NULL; }
+
+		if (m_BPPIdent == BPP_NATIVE)
+		{
+			if (m_RowFunc && m_Depth == 1) { return DecodeRows(true); }
+			return ParseNative();
+		}
 
 		switch (m_BPPIdent)
 		{
@@ -426,41 +1668,49 @@ namespace til
 		case BPP_32B_A8B8G8R8:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_A8B8G8R8;
+				m_BlockFunc = GetBlockFunc<Format_32b_A8B8G8R8>(m_Format);
 				break;
 			}
 		case BPP_32B_A8R8G8B8:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_A8R8G8B8;
+				m_BlockFunc = GetBlockFunc<Format_32b_A8R8G8B8>(m_Format);
 				break;
 			}
 		case BPP_32B_B8G8R8A8:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_B8G8R8A8;
+				m_BlockFunc = GetBlockFunc<Format_32b_B8G8R8A8>(m_Format);
 				break;
 			}
 		case BPP_32B_R8G8B8A8:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_R8G8B8A8;
+				m_BlockFunc = GetBlockFunc<Format_32b_R8G8B8A8>(m_Format);
 				break;
 			}
 		case BPP_32B_B8G8R8:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_B8G8R8;
+				m_BlockFunc = GetBlockFunc<Format_32b_B8G8R8>(m_Format);
 				break;
 			}
 		case BPP_32B_R8G8B8:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_R8G8B8;
+				m_BlockFunc = GetBlockFunc<Format_32b_R8G8B8>(m_Format);
 				break;
 			}
 		case BPP_16B_B5G6R5:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_B5G6R5;
+				m_BlockFunc = GetBlockFunc<Format_16b_B5G6R5>(m_Format);
 				break;
 			}
 		case BPP_16B_R5G6B5:
 			{
 				m_ColorFunc = &ImageDDS::ColorFunc_R5G6B5;
+				m_BlockFunc = GetBlockFunc<Format_16b_R5G6B5>(m_Format);
 				break;
 			}
 		default:
@@ -470,334 +1720,483 @@ namespace til
 			}
 		}
 
-		m_Pixels = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		if (!m_BlockFunc && m_Format != DDS_FOURCC_UNCOMPRESSED)
+		{
+			TIL_ERROR_EXPLAIN("Unknown or unhandled compression algorithm: 0x%x", m_Format);
+			return false;
+		}
 
-		m_Data = new byte[m_Width * m_Height * m_BlockSize];
-		m_Colors = new byte[m_BPP * 8];
-		if (m_Format == DDS_FOURCC_DXT5)
+		if (m_Format == DDS_FOURCC_UNCOMPRESSED)
 		{
-			m_Alpha = new byte[16 * sizeof(dword)];
+			if (m_BPP != 4)
+			{
+				TIL_ERROR_EXPLAIN("Unsupported bit depth: %i", m_BPP);
+				return false;
+			}
+			if (m_InternalDepth != TIL_DEPTH_A8R8G8B8 && m_InternalDepth != TIL_DEPTH_A8B8G8R8)
+			{
+				TIL_ERROR_EXPLAIN("Unsupported bit depth: %i", m_InternalDepth);
+				return false;
+			}
 		}
 
-		// decompress
+		if (m_RowFunc && m_Depth == 1) { return DecodeRows(false); }
+
+		m_Data = new byte[GetStoredFaceSize() * m_CubeMap];
+		if (!ReadFaces(m_Data)) { return false; }
+
+		// the offsets of every mipmap follow from the header,
+		// so each of them can be decoded on its own
+
+		byte* src = m_Data;
 
 		for (uint32 j = 0; j < m_CubeMap; j++)
 		{
 			uint32 w = m_Width;
 			uint32 h = m_Height;
+			uint32 d = m_Depth;
 
 			for (uint32 i = 0; i < m_MipMapTotal; i++)
 			{
 				w = (1 > w) ? 1 : w; 
 				h = (1 > h) ? 1 : h;
+				d = (1 > d) ? 1 : d;
 
-				if (m_Format == DDS_FOURCC_DXT1 || m_Format == DDS_FOURCC_DXT3 || m_Format == DDS_FOURCC_DXT5)
-				{
-					m_MipMapSize = ((w + 3) >> 2) * ((h + 3) >> 2) * m_BlockSize;
-				}
-				else
-				{
-					m_MipMapSize = w * h * m_BlockSize;
-				}
-
-				if (m_MipMapSize > m_Width * m_Height * m_BlockSize)
-				{
-					TIL_ERROR_EXPLAIN("Write buffer not big enough.");
-					return false;
-				}
-
-				GetBlocks(w, h);
-				AddMipMap(w, h);
+				// the slices of a volume are decoded to a single buffer
+				MipMap* curr = &m_MipMap[m_MipMapCurrent++];
+				curr->width = w;
+				curr->height = h;
+				curr->depth = d;
+				if (!Internal::GetPitch(w, h, m_BPP, curr->pitchx, curr->pitchy)) { return false; }
+				curr->slice = curr->pitchx * curr->pitchy * m_BPP;
+				curr->size = curr->slice * d;
+				curr->src = src;
 
-				DDS_DEBUG("Mipmap %i x %i - reading %i bytes", w, h, m_MipMapSize);
-
-				m_Stream->ReadByte(m_Data, m_MipMapSize);
-
-				if (m_Format == DDS_FOURCC_DXT1)
-				{
-					DecompressDXT1();
-				}
-				else if (m_Format == DDS_FOURCC_DXT5)
-				{
-					DecompressDXT5();
-				}
-				else if (m_Format == DDS_FOURCC_UNCOMPRESSED)
-				{
-					if (!DecompressUncompressed())
-					{
-						return false;
-					}
-				}
-				else
-				{
-					TIL_ERROR_EXPLAIN("Unknown or unhandled compression algorithm: 0x%x", m_Format);
-					return false;
-				}
+				DDS_DEBUG("Mipmap %i x %i x %i - %i bytes", w, h, d, GetStoredSize(w, h) * d);
 
-				m_MipMapCurrent++;
+				src += GetStoredSize(w, h) * d;
 
 				w >>= 1;
 				h >>= 1;
+				d >>= 1;
 			}
 		}
 
+		if (a_Options & TIL_LOAD_DEFERRED)
+		{
+			DDS_DEBUG("Deferring decoding");
+
+			m_Deferred = true;
+			return true;
+		}
+
+		uint32* frames = new uint32[m_MipMapCurrent];
+		for (uint32 i = 0; i < m_MipMapCurrent; i++) { frames[i] = i; }
+
+		DecodeFrames(frames, m_MipMapCurrent);
+
+		delete [] frames;
+
 		return true;
 	}
 
-	void ImageDDS::GetBlocks(uint32 a_Width, uint32 a_Height)
+	void ImageDDS::DecodeFrames(uint32* a_Frames, uint32 a_Count)
 	{
-		int powres = 1 << m_MipMapTotal;
-		int nW = a_Width / powres;
-		int nH = a_Height / powres;
-		int nD = m_Depth / powres;
+		m_Lock.Lock();
 
-		m_Blocks = 0;
+		// every mipmap is split into bands of block rows, 
+		// which can be decoded independently
 
-		// 4x4 blocks, 8 bytes per block
-		if (m_Format == DDS_FOURCC_DXT1)
+		uint32 task_total = 0;
+		for (uint32 i = 0; i < a_Count; i++)
 		{
-			//m_Size = (((nW + 3) / 4) * ((nH + 3) / 4) * 8);
-			m_Blocks = (a_Width / 4) * (a_Height / 4);
+			MipMap* curr = &m_MipMap[a_Frames[i]];
+			if (!curr->data) { task_total += ((curr->height + DDS_BAND_HEIGHT - 1) / DDS_BAND_HEIGHT) * curr->depth; }
 		}
-		// 4x4 blocks, 16 bytes per block
-		else if (m_Format == DDS_FOURCC_DXT5 || m_Format == DDS_FOURCC_DXT3)
+
+		if (task_total == 0)
 		{
-			//m_Size = (((nW + 3) / 4) * ((nH + 3) / 4) * 16);
-			m_Blocks = (a_Width / 4) * (a_Height / 4);
+			m_Lock.Unlock();
+			return;
 		}
-		else
+
+		m_Tasks = new DecodeTask[task_total];
+		DecodeTask* task = m_Tasks;
+
+		for (uint32 i = 0; i < a_Count; i++)
 		{
-			m_Blocks = a_Width * a_Height;
+			MipMap* dst = &m_MipMap[a_Frames[i]];
+			if (dst->data) { continue; }
+
+			dst->data = new byte[dst->size];
+			memset(dst->data, 0, dst->size);
+
+			// the slices of a volume don't depend on each other either
+			for (uint32 z = 0; z < dst->depth; z++)
+			{
+				byte* src = dst->src + (GetStoredSize(dst->width, dst->height) * z);
+
+				for (uint32 y = 0; y < dst->height; y += DDS_BAND_HEIGHT)
+				{
+					task->mipmap = dst;
+					task->src = src + GetStoredSize(dst->width, y);
+					task->z = z;
+					task->y = y;
+					task->height = (dst->height - y > DDS_BAND_HEIGHT) ? DDS_BAND_HEIGHT : dst->height - y;
+					task++;
+				}
+			}
+
+			m_Decoded++;
 		}
-	}
 
-	void ImageDDS::AddMipMap(uint32 a_Width, uint32 a_Height)
-	{
-		MipMap* curr = &m_MipMap[m_MipMapCurrent];
-		curr->width = a_Width;
-		curr->height = a_Height;
-		curr->data = Internal::CreatePixels(a_Width, a_Height, m_BPP, curr->pitchx, curr->pitchy);
+		Internal::ParallelFor(DecodeJob, this, (uint32)(task - m_Tasks));
+
+		delete [] m_Tasks;
+		m_Tasks = NULL;
+
+		// the stored data is no longer needed once everything is decoded
+		if (m_Decoded == m_MipMapTotal * m_CubeMap)
+		{
+			delete [] m_Data;
+			m_Data = NULL;
+		}
+
+		m_Lock.Unlock();
 	}
 
-	void ImageDDS::DecompressDXT1()
+	bool ImageDDS::StreamMipMaps(MipMapFunc a_Func, void* a_UserData)
 	{
-		uint32 curr = 0;
+		uint32* frames = new uint32[m_CubeMap];
 
-		DataDXT1* src = (DataDXT1*)m_Data;
-		MipMap* dst = &m_MipMap[m_MipMapCurrent];
+		bool result = true;
 
-		uint32 pitch_blocks = dst->width / 4;
+		for (uint32 i = m_MipMapTotal; i > 0; i--)
+		{
+			uint32 level = i - 1;
+			for (uint32 j = 0; j < m_CubeMap; j++) { frames[j] = (j * m_MipMapTotal) + level; }
 
-		uint32 glob_x = 0;
-		uint32 glob_y = 0;
-		uint32 pos_x = 0;
-		uint32 pos_y = 0;
+			if (m_Deferred) { DecodeFrames(frames, m_CubeMap); }
 
-		for (uint32 i = 0; i < m_Blocks; i++)
-		{
-			color_16b color0 = (src->c0_lo + (src->c0_hi << 8));
-			color_16b color1 = (src->c1_lo + (src->c1_hi << 8));
-			dword bits = (src->bits_0) | (src->bits_1 << 8) | (src->bits_2 << 16) | (src->bits_3 << 24);
+			if (!a_Func(this, level, a_UserData))
+			{
+				result = false;
+				break;
+			}
+		}
 
-			ConstructColors(color0, color1);
+		delete [] frames;
 
-			uint32 offset = (color0 > color1) ? 0 : 4;
-		
-			pos_y = glob_y;
-			byte alpha = 255;
+		return result;
+	}
 
-			for (int y = 0; y < 4; y++)
-			{
-				pos_x = glob_x;
+	void ImageDDS::DecodeJob(void* a_Data, uint32 a_Index)
+	{
+		ImageDDS* image = (ImageDDS*)a_Data;
+		DecodeTask* task = &image->m_Tasks[a_Index];
+		MipMap* dst = task->mipmap;
 
-				for (int x = 0; x < 4; x++)
-				{
-					uint32 curr = (2 * (4 * y + x));
-					uint32 enabled = ((bits & (0x3 << curr)) >> curr) + offset;
+		uint32 pitch = dst->pitchx * image->m_BPP;
+		byte* target = dst->data + (task->z * dst->slice) + (task->y * pitch);
+
+		if (image->m_BlockFunc)
+		{
+			image->m_BlockFunc(target, pitch, task->src, dst->width, task->height);
+		}
+		else
+		{
+			image->DecompressUncompressed(target, pitch, task->src, dst->width, task->height);
+		}
+	}
 
-					uint32 index = ((pos_y * dst->pitchx) + pos_x) * m_BPP;
-					(this->*m_ColorFunc)(dst->data, index, m_Colors, enabled, alpha);
+	bool ImageDDS::ParseFormatDX10(uint32 a_Format)
+	{
+		DDS_DEBUG("Format: DXGI %d", a_Format);
 
-					pos_x++;
-				}
+		m_DXGIFormat = a_Format;
+		m_BlockSize = 16;
 
-				pos_y++;
-			}
+		switch (a_Format)
+		{
 
-			glob_x += 4;
-			if (++curr == pitch_blocks)
+		case DDS_DXGI_BC1_UNORM:
+		case DDS_DXGI_BC1_UNORM_SRGB:
 			{
-				curr = 0;
-
-				glob_y += 4;
-				glob_x = 0;
+				m_Format = DDS_FOURCC_DXT1;
+				m_BlockSize = 8;
+				break;
+			}
+		case DDS_DXGI_BC2_UNORM:
+		case DDS_DXGI_BC2_UNORM_SRGB:
+			{
+				m_Format = DDS_FOURCC_DXT3;
+				break;
+			}
+		case DDS_DXGI_BC3_UNORM:
+		case DDS_DXGI_BC3_UNORM_SRGB:
+			{
+				m_Format = DDS_FOURCC_DXT5;
+				break;
+			}
+		case DDS_DXGI_BC4_UNORM:
+			{
+				m_Format = DDS_FOURCC_ATI1;
+				m_BlockSize = 8;
+				break;
+			}
+		case DDS_DXGI_BC5_UNORM:
+			{
+				m_Format = DDS_FOURCC_ATI2;
+				break;
+			}
+		case DDS_DXGI_BC6H_UF16:
+			{
+				m_Format = DDS_FOURCC_BC6H;
+				break;
+			}
+		case DDS_DXGI_BC6H_SF16:
+			{
+				m_Format = DDS_FOURCC_BC6H_SIGNED;
+				break;
+			}
+		case DDS_DXGI_BC7_UNORM:
+		case DDS_DXGI_BC7_UNORM_SRGB:
+			{
+				m_Format = DDS_FOURCC_BC7;
+				break;
+			}
+		case DDS_DXGI_R16G16B16A16_FLOAT:
+			{
+				m_Format = DDS_FOURCC_A16B16G16R16F;
+				m_BlockSize = 8;
+				break;
+			}
+		case DDS_DXGI_B8G8R8A8_UNORM:
+		case DDS_DXGI_B8G8R8A8_UNORM_SRGB:
+			{
+				m_Format = DDS_FOURCC_UNCOMPRESSED;
+				m_InternalDepth = TIL_DEPTH_A8R8G8B8;
+				m_InternalBPP = m_BlockSize = 4;
+				break;
+			}
+		case DDS_DXGI_R8G8B8A8_UNORM:
+		case DDS_DXGI_R8G8B8A8_UNORM_SRGB:
+			{
+				m_Format = DDS_FOURCC_UNCOMPRESSED;
+				m_InternalDepth = TIL_DEPTH_A8B8G8R8;
+				m_InternalBPP = m_BlockSize = 4;
+				break;
+			}
+		default:
+			{
+				TIL_ERROR_EXPLAIN("Unsupported DXGI format: %d", a_Format);
+				return false;
 			}
 
-			src++;
 		}
+
+		return true;
 	}
 
-	void ImageDDS::DecompressDXT5()
+	bool ImageDDS::ParseNative()
 	{
-		uint32 curr = 0;
+		DDS_DEBUG("Keeping native data");
 
-		DataDXT5* src = (DataDXT5*)m_Data;
-		MipMap* dst = &m_MipMap[m_MipMapCurrent];
+		m_Pixels = new byte[GetStoredFaceSize() * m_CubeMap];
+		if (!ReadFaces(m_Pixels)) { return false; }
 
-		uint32 pitch_blocks = dst->width / 4;
+		byte* src = m_Pixels;
 
-		uint32 glob_x = 0;
-		uint32 glob_y = 0;
-		uint32 pos_x = 0;
-		uint32 pos_y = 0;
-
-		for (uint32 i = 0; i < m_Blocks; i++)
+		for (uint32 j = 0; j < m_CubeMap; j++)
 		{
-			color_16b color0 = (src->c0_lo + (src->c0_hi << 8));
-			color_16b color1 = (src->c1_lo + (src->c1_hi << 8));
-			dword bits = (src->bits_0) | (src->bits_1 << 8) | (src->bits_2 << 16) | (src->bits_3 << 24);
+			uint32 w = m_Width;
+			uint32 h = m_Height;
+			uint32 d = m_Depth;
 
-			ConstructColors(color0, color1);
+			for (uint32 i = 0; i < m_MipMapTotal; i++)
+			{
+				w = (1 > w) ? 1 : w; 
+				h = (1 > h) ? 1 : h;
+				d = (1 > d) ? 1 : d;
 
-			// construct alpha
+				MipMap* curr = &m_MipMap[m_MipMapCurrent++];
+				curr->width = w;
+				curr->height = h;
+				curr->depth = d;
+				curr->pitchx = w;
+				curr->pitchy = h;
+				curr->slice = GetStoredSize(w, h);
+				curr->size = curr->slice * d;
+				curr->data = src;
 
-			uint64 a_bits_total = 
-				((uint64)src->a_bits_0      ) | ((uint64)src->a_bits_1 << 8 ) | 
-				((uint64)src->a_bits_2 << 16) | ((uint64)src->a_bits_3 << 24) |
-				((uint64)src->a_bits_4 << 32) | ((uint64)src->a_bits_5 << 40);
+				DDS_DEBUG("Mipmap %i x %i x %i - %i bytes", w, h, d, curr->size);
 
-			byte* alpha = (byte*)m_Alpha;
+				src += curr->size;
 
-			alpha[0] = src->alpha0;
-			alpha[1] = src->alpha1;
-			alpha[2] = (6 * src->alpha0 + 1 * src->alpha1) / 7;
-			alpha[3] = (5 * src->alpha0 + 2 * src->alpha1) / 7;
-			alpha[4] = (4 * src->alpha0 + 3 * src->alpha1) / 7;
-			alpha[5] = (3 * src->alpha0 + 4 * src->alpha1) / 7;
-			alpha[6] = (2 * src->alpha0 + 5 * src->alpha1) / 7;
-			alpha[7] = (1 * src->alpha0 + 6 * src->alpha1) / 7;
+				w >>= 1;
+				h >>= 1;
+				d >>= 1;
+			}
+		}
 
-			alpha[8] = src->alpha0;
-			alpha[9] = src->alpha1;
-			alpha[10] = (4 * src->alpha0 + 1 * src->alpha1) / 5;
-			alpha[11] = (3 * src->alpha0 + 2 * src->alpha1) / 5;
-			alpha[12] = (2 * src->alpha0 + 3 * src->alpha1) / 5;
-			alpha[13] = (1 * src->alpha0 + 4 * src->alpha1) / 5;
-			alpha[14] = 0;
-			alpha[15] = 255;
+		return true;
+	}
 
-			pos_y = glob_y;
+	bool ImageDDS::ReadFaces(byte* a_Dst)
+	{
+		// the faces and their mipmaps are stored back to back,
+		// so unless mipmaps were skipped the whole thing can be read in one go
 
-			int offset = 0;
-			if (src->alpha0 <= src->alpha1)
-			{
-				offset = 8;
-			}
+		uint32 count = (m_SkipSize > 0) ? m_CubeMap : 1;
+		uint32 size = GetStoredFaceSize() * (m_CubeMap / count);
 
-			for (int y = 0; y < 4; y++)
-			{
-				pos_x = glob_x;
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (m_SkipSize > 0) { m_Stream->Seek(m_SkipSize, TIL_FILE_SEEK_CURR); }
 
-				for (int x = 0; x < 4; x++)
-				{
-					uint64 bits_alpha = 0;
+			if (!m_Stream->ReadByte(a_Dst + (i * size), size))
+			{
+				TIL_ERROR_EXPLAIN("Could not read %i bytes of texture data.", size);
+				return false;
+			}
+		}
 
-					int curr_a = (3 * (4 * y + x));
-					bits_alpha = (a_bits_total & ((uint64)0x7 << curr_a)) >> curr_a;
+		return true;
+	}
 
-					uint32 curr = (2 * (4 * y + x));
-					uint32 enabled = ((bits & (0x3 << curr)) >> curr);
+	bool ImageDDS::DecodeRows(bool a_Native)
+	{
+		// the first image is stored first, so the other faces 
+		// and mipmaps don't have to be read at all
 
-					uint32 index = ((pos_y * dst->pitchx) + pos_x) * m_BPP;
-					(this->*m_ColorFunc)(dst->data, index, m_Colors, enabled, alpha[bits_alpha + offset]);
+		if (!CheckRegion(m_Width, m_Height)) { return false; }
 
-					pos_x++;
-				}
+		uint32 band = IsBlockCompressed() ? 4 : 1;
+		uint32 stored = GetStoredSize(m_Width, band);
+		uint32 pitch = m_Width * m_BPP;
 
-				pos_y++;
-			}
+		// only the bands and the columns of blocks in the region are read
 
-			glob_x += 4;
-			if (++curr == pitch_blocks)
-			{
-				curr = 0;
+		uint32 left = m_RegionX - (m_RegionX % band);
+		uint32 right = m_RegionX + m_RegionWidth;
+		right += (band - (right % band)) % band;
+		if (right > m_Width) { right = m_Width; }
 
-				glob_y += 4;
-				glob_x = 0;
-			}
+		uint32 skip = GetStoredSize(left, band);
+		uint32 read = GetStoredSize(right - left, band);
 
-			src++;
+		m_Data = new byte[read];
+		if (!a_Native)
+		{
+			m_Pixels = new byte[pitch * band];
+			Internal::MemSet(m_Pixels, 0, pitch * band);
 		}
-	}
 
-	bool ImageDDS::DecompressUncompressed()
-	{
-		byte* read = m_Data;
-		byte src[4];
-		MipMap* dst = &m_MipMap[m_MipMapCurrent];
+		// the stream can only be moved relative to the start of the data
+		uint32 position = 0;
+		if (m_SkipSize > 0) { m_Stream->Seek(m_SkipSize, TIL_FILE_SEEK_CURR); }
 
-		if (m_BPP == 4)
+		uint32 top = m_RegionY - (m_RegionY % band);
+		uint32 bottom = m_RegionY + m_RegionHeight;
+		for (uint32 y = top; y < bottom; y += band)
 		{
-			uint32 r, g, b, a;
+			uint32 count = (m_Height - y < band) ? (m_Height - y) : band;
+
+			uint32 offset = ((y / band) * stored) + skip;
+			if (offset > position) { m_Stream->Seek(offset - position, TIL_FILE_SEEK_CURR); }
 
-			if (m_InternalDepth == TIL_DEPTH_A8R8G8B8)
+			if (!m_Stream->ReadByte(m_Data, read))
 			{
-				r = 2;
-				g = 1;
-				b = 0;
-				a = 3;
+				TIL_ERROR_EXPLAIN("Could not read %i bytes of texture data.", read);
+				return false;
 			}
-			else
+			position = offset + read;
+
+			if (a_Native)
 			{
-				TIL_ERROR_EXPLAIN("Unsupported bit depth: %i", m_InternalDepth);
-				return false;
+				if (!PushRows(m_Data, y, count, m_Width, m_Height, stored)) { return false; }
+				continue;
 			}
 
-			for (uint32 y = 0; y < dst->height; y++)
+			byte* dst = m_Pixels + (left * m_BPP);
+			if (m_BlockFunc)
+			{
+				m_BlockFunc(dst, pitch, m_Data, right - left, count);
+			}
+			else
 			{
-				uint32 index_y = (y * dst->pitchx);
+				DecompressUncompressed(dst, pitch, m_Data, right - left, count);
+			}
 
-				for (uint32 x = 0; x < dst->width; x++)
-				{
-					src[0] = read[r];
-					src[1] = read[g];
-					src[2] = read[b];
-					src[3] = read[a];
+			if (!PushRows(m_Pixels, y, count, m_Width, m_Height, pitch)) { return false; }
+		}
 
-					uint32 index = index_y + x;
-					(this->*m_ColorFunc)(dst->data, index * m_BPP, src, 0, src[3]);
+		return true;
+	}
 
-					read += 4;
-				}
-			}
-		}
-		else if (m_BPP == 2)
+	uint32 ImageDDS::GetStoredSize(uint32 a_Width, uint32 a_Height)
+	{
+		if (IsBlockCompressed())
 		{
-			TIL_ERROR_EXPLAIN("Unsupported bit depth: %i", m_BPP);
-			return false;
+			return ((a_Width + 3) >> 2) * ((a_Height + 3) >> 2) * m_BlockSize;
 		}
 		else
 		{
-			TIL_ERROR_EXPLAIN("Unsupported bit depth: %i", m_BPP);
-			return false;
+			return a_Width * a_Height * m_BlockSize;
 		}
-		
-		return true;
 	}
 
-	void ImageDDS::ConstructColors(color_16b a_Color0, color_16b a_Color1)
+	uint32 ImageDDS::GetStoredFaceSize()
+	{
+		uint32 total = 0;
+
+		uint32 w = m_Width;
+		uint32 h = m_Height;
+		uint32 d = m_Depth;
+		for (uint32 i = 0; i < m_MipMapTotal; i++)
+		{
+			w = (1 > w) ? 1 : w; 
+			h = (1 > h) ? 1 : h;
+			d = (1 > d) ? 1 : d;
+
+			total += GetStoredSize(w, h) * d;
+
+			w >>= 1;
+			h >>= 1;
+			d >>= 1;
+		}
+
+		return total;
+	}
+
+	void ImageDDS::DecompressUncompressed(byte* a_Dst, uint32 a_Pitch, byte* a_Src, uint32 a_Width, uint32 a_Height)
 	{
-		color_32b* colors = (color_32b*)m_Colors;
+		// only A8R8G8B8 and A8B8G8R8 are stored uncompressed for now, checked when parsing
+
+		uint32 r = (m_InternalDepth == TIL_DEPTH_A8R8G8B8) ? 2 : 0;
+		uint32 b = 2 - r;
+
+		byte src[4];
+
+		for (uint32 y = 0; y < a_Height; y++)
+		{
+			byte* dst = a_Dst;
+
+			for (uint32 x = 0; x < a_Width; x++)
+			{
+				src[0] = a_Src[r];
+				src[1] = a_Src[1];
+				src[2] = a_Src[b];
+				src[3] = a_Src[3];
+
+				(this->*m_ColorFunc)(dst, 0, src, 0, src[3]);
 
-		colors[0] = Convert_From_16b_R5G6B5_To_32b_A8B8G8R8(a_Color0);
-		colors[1] = Convert_From_16b_R5G6B5_To_32b_A8B8G8R8(a_Color1);
-		colors[2] = Convert_From_16b_R5G6B5_To_32b_A8B8G8R8(Blend_16b_R5G6B5(a_Color0, a_Color1, 0xAA));
-		colors[3] = Convert_From_16b_R5G6B5_To_32b_A8B8G8R8(Blend_16b_R5G6B5(a_Color0, a_Color1, 0x55));
+				dst += m_BPP;
+				a_Src += 4;
+			}
 
-		colors[4] = colors[0];
-		colors[5] = colors[1];
-		colors[6] = Convert_From_16b_R5G6B5_To_32b_A8B8G8R8(Blend_16b_R5G6B5(a_Color0, a_Color1, 0x80));
-		colors[7] = 0;
+			a_Dst += a_Pitch;
+		}
 	}
 
 	uint32 ImageDDS::GetFrameCount()
@@ -805,8 +2204,14 @@ namespace til
 		return m_MipMapTotal * m_CubeMap;
 	}
 
+	bool ImageDDS::HasSizes()
+	{
+		return true;
+	}
+
 	byte* ImageDDS::GetPixels(uint32 a_Frame /*= 0*/)
 	{
+		if (m_Deferred) { DecodeFrames(&a_Frame, 1); }
 		return m_MipMap[a_Frame].data;
 	}
 
@@ -830,6 +2235,97 @@ namespace til
 		return m_MipMap[a_Frame].pitchy;
 	}
 
+	uint32 ImageDDS::GetDepth(uint32 a_Frame /*= 0*/)
+	{
+		return m_MipMap[a_Frame].depth;
+	}
+
+	uint32 ImageDDS::GetSlicePitch(uint32 a_Frame /*= 0*/)
+	{
+		return m_MipMap[a_Frame].slice;
+	}
+
+	bool ImageDDS::IsVolume()
+	{
+		return (m_Depth > 1);
+	}
+
+	uint32 ImageDDS::GetFourCC()
+	{
+		return m_Format;
+	}
+
+	uint32 ImageDDS::GetBlockSize()
+	{
+		return m_BlockSize;
+	}
+
+	bool ImageDDS::IsBlockCompressed()
+	{
+		return (
+			m_Format == DDS_FOURCC_DXT1 || m_Format == DDS_FOURCC_DXT2 ||
+			m_Format == DDS_FOURCC_DXT3 || m_Format == DDS_FOURCC_DXT4 ||
+			m_Format == DDS_FOURCC_DXT5 || m_Format == DDS_FOURCC_RXGB ||
+			m_Format == DDS_FOURCC_ATI1 || m_Format == DDS_FOURCC_ATI2 ||
+			m_Format == DDS_FOURCC_BC6H || m_Format == DDS_FOURCC_BC6H_SIGNED ||
+			m_Format == DDS_FOURCC_BC7
+		);
+	}
+
+	uint32 ImageDDS::GetMipMapCount()
+	{
+		return m_MipMapTotal;
+	}
+
+	uint32 ImageDDS::GetFaceCount()
+	{
+		return m_CubeMap;
+	}
+
+	uint32 ImageDDS::GetArraySize()
+	{
+		return m_ArraySize;
+	}
+
+	uint32 ImageDDS::GetDXGIFormat()
+	{
+		return m_DXGIFormat;
+	}
+
+	uint32 ImageDDS::GetDataSize(uint32 a_Frame /*= 0*/)
+	{
+		return m_MipMap[a_Frame].size;
+	}
+
+	uint32 ImageDDS::GetFaceSize()
+	{
+		uint32 total = 0;
+		for (uint32 i = 0; i < m_MipMapTotal; i++) { total += m_MipMap[i].size; }
+		return total;
+	}
+
+	float ImageDDS::HalfToFloat(word a_Half)
+	{
+		int32 exponent = (a_Half >> 10) & 0x1F;
+		int32 mantissa = a_Half & 0x3FF;
+
+		double result;
+		if (exponent == 0)
+		{
+			result = ldexp((double)mantissa, -24);
+		}
+		else if (exponent == 31)
+		{
+			result = (mantissa == 0) ? HUGE_VAL : 0.0;
+		}
+		else
+		{
+			result = ldexp((double)(mantissa | 0x400), exponent - 25);
+		}
+
+		return (float)((a_Half & 0x8000) ? -result : result);
+	}
+
 }; // namespace til
 
 #endif
\ No newline at end of file
@@ -76,6 +76,7 @@ namespace til
 		m_CurrentColors = NULL;
 		m_PrevBuffer = NULL;
 		m_Delay = 0.f;
+		m_Row = 0;
 	}
 
 	ImageGIF::~ImageGIF()
@@ -87,6 +88,25 @@ namespace til
 		if (m_Palette) { delete m_Palette; }
 	}
 
+	bool ImageGIF::NextRow(byte*& a_Target)
+	{
+		if (!m_RowFunc)
+		{
+			a_Target += m_LocalPitch;
+			return true;
+		}
+
+		// every row of the first frame is written to the same buffer
+		if (m_Row < m_Height)
+		{
+			if (!PushRows(m_PrevBuffer, m_Row, 1, m_Width, m_Height, m_Width * m_BPP)) { return false; }
+			Internal::MemSet(m_PrevBuffer, 0, m_Width * m_BPP);
+		}
+		m_Row++;
+
+		return true;
+	}
+
 	void ImageGIF::AddBuffer()
 	{
 		uint32 pitchx, pitchy;
@@ -267,6 +287,12 @@ namespace til
 
 	bool ImageGIF::Parse(uint32 a_Options/*= TIL_DEPTH_A8R8G8B8*/)
 	{
+		if (m_BPPIdent == BPP_NATIVE)
+		{
+			TIL_ERROR_EXPLAIN("Unhandled color format: %i", m_BPPIdent);
+			return false;
+		}
+
 		m_Stream->ReadByte(m_Buffer, 6);
 
 		if (*(uint32*)m_Buffer != GIF_TYPE('G', 'I', 'F', '8'))
@@ -389,8 +415,19 @@ namespace til
 
 		//m_TotalBytes = m_Width * m_Height * m_BPP;
 		m_TotalBytes = m_LocalPitchX * m_LocalPitchY * m_BPP;
-		m_PrevBuffer = new byte[m_TotalBytes];
-		Internal::MemSet(m_PrevBuffer, 0, m_TotalBytes);
+		if (m_RowFunc)
+		{
+			if (!CheckRegion(m_Width, m_Height)) { return false; }
+
+			// only the first frame is decoded, a row at a time
+			m_PrevBuffer = new byte[m_Width * m_BPP];
+			Internal::MemSet(m_PrevBuffer, 0, m_Width * m_BPP);
+		}
+		else
+		{
+			m_PrevBuffer = new byte[m_TotalBytes];
+			Internal::MemSet(m_PrevBuffer, 0, m_TotalBytes);
+		}
 
 		GIF_DEBUG("Width: %i", m_Width);
 		GIF_DEBUG("Height: %i", m_Height);
@@ -421,10 +458,17 @@ namespace til
 			m_Frames++;
 			GIF_DEBUG("Frame: %i", m_Frames);
 
-			AddBuffer();
-			target = m_Current->buffer;
+			if (m_RowFunc)
+			{
+				target = m_PrevBuffer;
+			}
+			else
+			{
+				AddBuffer();
+				target = m_Current->buffer;
 
-			Internal::MemCpy(target, m_PrevBuffer, m_TotalBytes);
+				Internal::MemCpy(target, m_PrevBuffer, m_TotalBytes);
+			}
 			//memcpy(target, m_PrevBuffer, m_TotalBytes);
 
 			uint32 xy = (m_OffsetY * m_Width) + (m_OffsetX);
@@ -534,7 +578,7 @@ namespace til
 
 					if (width-- == 0)
 					{
-						target += m_LocalPitch;
+						if (!NextRow(target)) { return false; }
 						int32 xy = (int32)((m_OffsetY * m_Pitch) + (m_OffsetX * m_BPP));
 						dst = target + xy;
 						width = m_LocalWidth - 1;
@@ -583,7 +627,7 @@ namespace til
 					{
 						if (width-- == 0)
 						{
-							target += m_LocalPitch;
+							if (!NextRow(target)) { return false; }
 							
 							int32 xy = (int32)((m_OffsetY * m_Pitch) + (m_OffsetX * m_BPP));
 							dst = target + xy;
@@ -614,6 +658,17 @@ namespace til
 				}
 			}
 
+			// the last row is passed on with the rows that weren't written
+			if (m_RowFunc)
+			{
+				while (m_Row < m_Height)
+				{
+					if (!NextRow(target)) { return false; }
+				}
+
+				return true;
+			}
+
 			// image block identifier: 21 F9 04
 			uint32 header = 0;
 			m_Stream->Read(&header, 1, 3);
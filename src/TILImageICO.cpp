@@ -29,6 +29,8 @@
 
 #if (TIL_FORMAT & TIL_FORMAT_PNG)
 	#include "TILImagePNG.h"
+	#include "TILFileStreamMemory.h"
+	#include "TILFileStreamWindow.h"
 #endif
 
 #if (TIL_RUN_TARGET == TIL_TARGET_DEVEL)
@@ -37,81 +39,29 @@
 	#define ICO_DEBUG(msg, ...)
 #endif
 
-//#define GETBIT(data, place) 0
-#define GETBIT(data, place) ((data >> (8 - place)) & 1)
+// largest amount of stored data accepted for a single image
+#define ICO_MAX_DATA                   0x04000000
+
+// largest amount of pixels accepted for a single image
+#define ICO_MAX_PIXELS                 0x01000000
 
 namespace til
 {
 
 	ImageICO::ImageICO()
 	{
-		m_First = m_Current = NULL;
+		m_Images = 0;
+		m_Entries = NULL;
 	}
 
 	ImageICO::~ImageICO()
 	{
-		ReleaseMemory(m_First);
-		delete m_First;
-	}
-
-	void ImageICO::AddBuffer(uint32 a_Width, uint32 a_Height)
-	{
-		if (m_First)
-		{	
-			m_Current->next = new BufferICO;
-			m_Current->next->next    = NULL;
-			m_Current->next->width   = a_Width;
-			m_Current->next->height  = a_Height;
-			m_Current->next->pitch   = a_Width;
-			m_Current->next->buffer  = new byte[a_Width * a_Height * m_BPP];
-			m_Current->next->colors  = NULL;
-			m_Current = m_Current->next;
-		}
-		else
-		{ 
-			m_First = new BufferICO;
-			m_Current = m_First;
-			m_Current->next    = NULL;
-			m_Current->width   = a_Width;
-			m_Current->height  = a_Height;
-			m_Current->pitch   = a_Width;
-			m_Current->buffer  = new byte[a_Width * a_Height * m_BPP];
-			m_Current->colors  = NULL;
-		}
-	}
-
-	void ImageICO::ExpandPalette(BufferICO* a_Buffer)
-	{
-		a_Buffer->colors = new byte[a_Buffer->palette * m_BPP];
-
-		switch (m_BPPIdent)
+		for (uint32 i = 0; i < m_Images; i++)
 		{
-			case BPP_32B_A8B8G8R8:
-				{
-					color_32b* dst = (color_32b*)a_Buffer->colors;
-
-					for (int i = 0; i < a_Buffer->palette; i++)
-					{
-						byte read[4];
-						m_Stream->ReadByte(read, 4);
-						*dst++ = Construct_32b_A8R8G8B8(read[0], read[1], read[2], (a_Buffer->palette > 0) ? 255 : read[3]);
-					}
-
-					break;
-				}
-			default:
-				{
-					TIL_ERROR_EXPLAIN("Unhandled color format: %i", m_BPPIdent);
-					break;
-				}
+			if (m_Entries[i].buffer) { delete [] m_Entries[i].buffer; }
+			if (m_Entries[i].data) { delete [] m_Entries[i].data; }
 		}
-
-		/*for (int i = 0; i < a_Buffer->palette; i++)
-		{
-			byte read[4];
-			m_Stream->ReadByte(read, 4);
-			*dst++ = Construct_32b_A8R8G8B8(read[0], read[1], read[2], (a_Buffer->palette > 0) ? 255 : read[3]);
-		}*/
+		if (m_Entries) { delete [] m_Entries; }
 	}
 
 	bool ImageICO::Parse(uint32 a_ColorDepth)
@@ -119,60 +69,21 @@ namespace til
 		// empty anyway
 		m_Stream->Seek(2, TIL_FILE_SEEK_CURR);
 
-		word header;          m_Stream->ReadWord(&header);
-		if (header != 1 && header != 2)
+		byte header[4];
+		m_Stream->ReadByte(header, 4);
+
+		uint32 type = Internal::GetWord(header);
+		if (type != 1 && type != 2)
 		{
 			TIL_ERROR_EXPLAIN("Not a valid ICO file!");
 			return false;
 		}
 
-		word imagecount;      m_Stream->ReadWord(&imagecount);
-		m_Images = imagecount;
-
-		byte width, height, palette, reserved;
-		word planes, bpp;
-		dword datasize, offset;
-
-		for (uint16 i = 0; i < imagecount; i++)
+		m_Images = Internal::GetWord(header + 2);
+		if (m_Images == 0)
 		{
-			m_Stream->ReadByte(&width);
-			m_Stream->ReadByte(&height);
-
-			m_Stream->ReadByte(&palette);
-			m_Stream->ReadByte(&reserved);
-
-			m_Stream->ReadWord(&planes);
-			m_Stream->ReadWord(&bpp);
-
-			m_Stream->ReadDWord(&datasize);
-			m_Stream->ReadDWord(&offset);
-
-			unsigned long w = (width == 0) ? 256 : width;
-			unsigned long h = (height == 0) ? 256 : height;
-
-			AddBuffer(w, h);
-
-			m_Current->offset    = offset;
-			m_Current->datasize  = datasize;
-			m_Current->palette   = palette;
-
-			if (bpp == 0) 
-			{ 
-				m_Current->bytespp = datasize / (width * height); 
-				m_Current->bitspp = 0;
-			}
-			else
-			{
-				if (bpp == 4)
-				{
-					m_Current->bytespp = 1;
-				}
-				else
-				{
-					m_Current->bytespp = bpp >> 3;
-				}
-				m_Current->bitspp = bpp;
-			}
+			TIL_ERROR_EXPLAIN("Icon doesn't contain any images.");
+			return false;
 		}
 
 		switch (m_BPPIdent)
@@ -221,191 +132,326 @@ namespace til
 		default:
 			{
 				TIL_ERROR_EXPLAIN("Unhandled color format: %i", m_BPPIdent);
-				break;
+				return false;
 			}
 		};
 
-		BufferICO* cur = m_First;
-		for (uint32 i = 0; i < m_Images; cur = cur->next, i++)
-		{
-			/*
-				typedef struct tagBITMAPINFOHEADER{
-				DWORD      biSize;
-				LONG       biWidth;
-				LONG       biHeight;
-				WORD       biPlanes;
-				WORD       biBitCount;
-				DWORD      biCompression;
-				DWORD      biSizeImage;
-				LONG       biXPelsPerMeter;
-				LONG       biYPelsPerMeter;
-				DWORD      biClrUsed;
-				DWORD      biClrImportant;
-				} BITMAPINFOHEADER, FAR *LPBITMAPINFOHEADER, *PBITMAPINFOHEADER;
-			*/
-
-			//unsigned long size2 = sizeof(BITMAPINFOHEADER);
+		// the directory
+
+		m_Entries = new BufferICO[m_Images];
+		memset(m_Entries, 0, m_Images * sizeof(BufferICO));
+
+		for (uint32 i = 0; i < m_Images; i++)
+		{
+			byte entry[16];
+			if (!m_Stream->ReadByte(entry, 16))
+			{
+				TIL_ERROR_EXPLAIN("Directory of image %i is incomplete.", i);
+				return false;
+			}
 
+			BufferICO* cur = &m_Entries[i];
+
+			cur->width    = (entry[0] == 0) ? 256 : entry[0];
+			cur->height   = (entry[1] == 0) ? 256 : entry[1];
+			cur->bitspp   = Internal::GetWord(entry + 6);
+			cur->datasize = Internal::GetDWord(entry + 8);
+			cur->offset   = Internal::GetDWord(entry + 12);
+
+			if (cur->datasize < 24 || cur->datasize > ICO_MAX_DATA)
+			{
+				TIL_ERROR_EXPLAIN("Invalid data size for image %i: %i", i, cur->datasize);
+				return false;
+			}
+		}
+
+		// the headers are more reliable than the directory
+
+		for (uint32 i = 0; i < m_Images; i++)
+		{
+			BufferICO* cur = &m_Entries[i];
+
+			byte header[24];
 			m_Stream->Seek(cur->offset, TIL_FILE_SEEK_START);
+			if (!m_Stream->ReadByte(header, 24))
+			{
+				TIL_ERROR_EXPLAIN("Header of image %i is incomplete.", i);
+				return false;
+			}
 
-			//BITMAPINFOHEADER bleh;
-			//fread(&bleh, sizeof(bleh), 1, m_Handle);
+			if (!memcmp(header, "\x89PNG", 4))
+			{
+				cur->png = true;
+				cur->width  = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+				cur->height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+				if (cur->bitspp == 0) { cur->bitspp = 32; }
+			}
+			else
+			{
+				// the height includes the and mask
+				cur->width  = Internal::GetDWord(header + 4);
+				cur->height = Internal::GetDWord(header + 8) / 2;
+				cur->bitspp = Internal::GetWord(header + 14);
+			}
 
-			dword size;           m_Stream->ReadDWord(&size);
-			int32 width;          m_Stream->Read(&width, sizeof(int32));
-			int32 height;         m_Stream->Read(&height, sizeof(int32));
-			word planes;          m_Stream->ReadWord(&planes);
-			word bitcount;        m_Stream->ReadWord(&bitcount);
-			dword compression;    m_Stream->ReadDWord(&compression);
-			dword sizeimage;      m_Stream->ReadDWord(&sizeimage);
-			int32 xpermeter;      m_Stream->Read(&xpermeter, sizeof(int32));
-			int32 ypermeter;      m_Stream->Read(&ypermeter, sizeof(int32));
-			dword colorused;      m_Stream->ReadDWord(&colorused);
-			dword colorimportant; m_Stream->ReadDWord(&colorimportant);
+			if (cur->width == 0 || cur->height == 0 || cur->width > ICO_MAX_PIXELS / cur->height)
+			{
+				TIL_ERROR_EXPLAIN("Invalid dimensions for image %i: (%i, %i)", i, cur->width, cur->height);
+				return false;
+			}
 
-			//m_Stream->Seek(24, TIL_FILE_SEEK_CURR);
+			Internal::GetPitch(cur->width, cur->height, m_BPP, cur->pitch, cur->pitchy);
 
 			ICO_DEBUG("Image: %i", i);
 			ICO_DEBUG("Dimensions: (%i, %i)", cur->width, cur->height);
-			ICO_DEBUG("Bytes per pixel: %i", cur->bytespp);
-			ICO_DEBUG("Bitcount: %i", bitcount);
+			ICO_DEBUG("Bitcount: %i", cur->bitspp);
+			ICO_DEBUG("PNG: %i", cur->png);
+		}
+
+		// the image closest to the size hint becomes the first frame
+
+		uint32 size = TIL_LOAD_GETSIZE(a_ColorDepth);
+		if (size > 0)
+		{
+			uint32 best = GetBestFrame(size, size);
+
+			BufferICO swap = m_Entries[0];
+			m_Entries[0] = m_Entries[best];
+			m_Entries[best] = swap;
+
+			ICO_DEBUG("Best image for size %i: %i", size, best);
+		}
 
-			uint16 colors_used = 0;
-			if (bitcount == 8) 
-			{ 
-				colors_used = 256; 
-			} 
-			else if (bitcount == 4) 
-			{ 
-				colors_used = 16; 
+		uint32 count = (size > 0) ? 1 : m_Images;
+		if (a_ColorDepth & TIL_LOAD_DEFERRED)
+		{
+			ICO_DEBUG("Deferring decoding");
+			count = 0;
+		}
+
+		for (uint32 i = 0; i < m_Images; i++)
+		{
+			BufferICO* cur = &m_Entries[i];
+
+			// the data of images decoded later is kept, because the stream
+			// is closed after loading, but PNG images decoded now are read
+			// straight from the file
+
+			if (i >= count || !cur->png)
+			{
+				cur->data = new byte[cur->datasize];
+				memset(cur->data, 0, cur->datasize);
+
+				m_Stream->Seek(cur->offset, TIL_FILE_SEEK_START);
+				m_Stream->ReadByte(cur->data, cur->datasize);
 			}
 
-			cur->palette = colors_used;
+			if (i < count && !DecodeEntry(cur)) { return false; }
+		}
+
+		return true;
+	}
+
+	bool ImageICO::DecodeEntry(BufferICO* a_Entry)
+	{
+		if (a_Entry->buffer) { return true; }
+
+		byte* pixels = Internal::CreatePixels(a_Entry->width, a_Entry->height, m_BPP, a_Entry->pitch, a_Entry->pitchy);
+		if (!pixels) { return false; }
+
+		bool result = (a_Entry->png) ? DecodePNG(a_Entry, pixels) : DecodeBitmap(a_Entry, pixels);
+
+		if (!result)
+		{
+			delete [] pixels;
+			return false;
+		}
+
+		// the stored data is no longer needed once it's decoded
+		delete [] a_Entry->data;
+		a_Entry->data = NULL;
+
+		a_Entry->buffer = pixels;
+
+		return true;
+	}
+
+	bool ImageICO::DecodeBitmap(BufferICO* a_Entry, byte* a_Dst)
+	{
+		byte* data = a_Entry->data;
+		byte* end = data + a_Entry->datasize;
+
+		uint32 header_size = Internal::GetDWord(data);
+		uint32 compression = Internal::GetDWord(data + 16);
+		uint32 colors_used = Internal::GetDWord(data + 32);
+		uint32 bpp = a_Entry->bitspp;
+
+		if (header_size < 40 || header_size > a_Entry->datasize)
+		{
+			TIL_ERROR_EXPLAIN("Invalid header size: %i", header_size);
+			return false;
+		}
+
+		if (compression != 0)
+		{
+			TIL_ERROR_EXPLAIN("Unhandled compression method: %i", compression);
+			return false;
+		}
 
-			uint32 current = 0;
+		if (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 24 && bpp != 32)
+		{
+			TIL_ERROR_EXPLAIN("Unhandled bit depth: %i", bpp);
+			return false;
+		}
 
-			uint32 pitch = cur->pitch * m_BPP;
-			cur->pitchy = cur->height;
+		// the palette is converted to the target depth once
 
-			byte* src;
+		byte* palette = NULL;
+		byte* src = data + header_size;
 
-			byte* target = cur->buffer + ((cur->height - 1) * pitch);
+		if (bpp <= 8)
+		{
+			uint32 count = (colors_used > 0 && colors_used < (uint32)(1 << bpp)) ? colors_used : (1 << bpp);
+			if (src + (count * 4) > end)
+			{
+				TIL_ERROR_EXPLAIN("Palette is incomplete.");
+				return false;
+			}
 
-			ICO_DEBUG("Palette: %i", cur->palette);
+			palette = new byte[256 * m_BPP];
+			memset(palette, 0, 256 * m_BPP);
 
-			if (cur->palette > 0)
+			for (uint32 i = 0; i < count; i++)
 			{
-				ExpandPalette(cur);
+				(this->*m_ColorFunc)(palette + (i * m_BPP), src, 1, 3);
+				src += 4;
+			}
+		}
 
-				int div = 1; // palette = 256
-				if (cur->palette == 16) { div = 2; }
+		// rows are aligned to 32 bits and stored from the bottom up,
+		// the and mask follows the colors
 
-				cur->readpx = cur->width / div;
-				cur->readpy = cur->height / div;
+		uint32 w = a_Entry->width;
+		uint32 h = a_Entry->height;
+		uint32 readpitch = ((w * bpp + 31) >> 5) << 2;
+		uint32 maskpitch = ((w + 31) >> 5) << 2;
 
-				src = new byte[cur->width * cur->readpy * cur->bytespp];
-				m_Stream->Read(src, cur->bytespp, cur->width * cur->readpy);
+		if (src + (readpitch * h) > end)
+		{
+			TIL_ERROR_EXPLAIN("Pixel data is incomplete.");
+			if (palette) { delete [] palette; }
+			return false;
+		}
 
-				cur->andmask = new byte[(cur->width / 8) * cur->height];
-				m_Stream->Read(cur->andmask, sizeof(byte), (cur->width / 8) * cur->height);
+		// 32-bit images have an alpha channel instead
+		byte* mask = src + (readpitch * h);
+		if (bpp == 32 || mask + (maskpitch * h) > end) { mask = NULL; }
 
-				byte* read = src;
-				byte* andmask = cur->andmask;
+		uint32 pitch = a_Entry->pitch * m_BPP;
+		byte* target = a_Dst + ((h - 1) * pitch);
 
-				int offset = (cur->width / 8);
+		for (uint32 y = 0; y < h; y++)
+		{
+			if (bpp <= 8)
+			{
+				uint32 bits = (1 << bpp) - 1;
+				byte* dst = target;
 
-				if (cur->palette == 16)
+				for (uint32 x = 0; x < w; x++)
 				{
-					for (uint32 y = 0; y < cur->readpy; y++)
-					{
-						WriteColumnAnd(target, read, cur->width, cur->colors, andmask);
-						target -= pitch;
-						read += cur->readpx;
-						andmask += cur->width / 8;
-
-						WriteColumnAnd(target, read, cur->width, cur->colors, andmask);
-						target -= pitch;
-						read += cur->readpx;
-						andmask += cur->width / 8;
-					}
+					// the leftmost pixel is stored in the highest bits
+					uint32 bit = x * bpp;
+					uint32 index = (src[bit >> 3] >> (8 - bpp - (bit & 7))) & bits;
+
+					memcpy(dst, palette + (index * m_BPP), m_BPP);
+					dst += m_BPP;
 				}
-				else
+			}
+			else
+			{
+				(this->*m_ColorFunc)(target, src, w, bpp >> 3);
+			}
+
+			// pixels in the and mask are transparent
+			if (mask)
+			{
+				for (uint32 x = 0; x < w; x++)
 				{
-					for (uint32 y = 0; y < cur->height; y++)
-					{
-						WriteColumnPalette(target, read, cur->width, cur->colors);
-
-						target -= pitch;
-						read += cur->readpx;
-						andmask += cur->width / 8;
-					}
+					if (mask[x >> 3] & (0x80 >> (x & 7))) { memset(target + (x * m_BPP), 0, m_BPP); }
 				}
 
-				delete src;
-				delete cur->andmask;
+				mask += maskpitch;
 			}
-			else
-			{
-				m_Stream->Seek(cur->offset, TIL_FILE_SEEK_START);
 
-				dword png_header;
-				m_Stream->ReadDWord(&png_header);
+			src += readpitch;
+			target -= pitch;
+		}
 
-				if (png_header == PNG_TYPE('G', 'N', 'P', 0x89))
-				{
+		if (palette) { delete [] palette; }
+
+		return true;
+	}
+
+	bool ImageICO::DecodePNG(BufferICO* a_Entry, byte* a_Dst)
+	{
 
 #if (TIL_FORMAT & TIL_FORMAT_PNG)
 
-					ICO_DEBUG("Loading PNG.");
+		ICO_DEBUG("Loading PNG.");
+
+		FileStreamMemory memory;
+		memory.SetData(a_Entry->data, a_Entry->datasize);
+		FileStreamWindow window(m_Stream, a_Entry->offset, a_Entry->datasize);
 
-					m_Stream->Seek(cur->offset, TIL_FILE_SEEK_START);
+		// decoded straight into the pixels of the entry
+		ImagePNG* png = new ImagePNG();
+		png->Load((a_Entry->data) ? (FileStream*)&memory : (FileStream*)&window);
+		png->SetTarget(a_Dst, a_Entry->width, a_Entry->height, a_Entry->pitch, a_Entry->pitchy);
 
-					ImagePNG* png_compressed = new ImagePNG();
-					png_compressed->Load(m_Stream);
-					png_compressed->SetBPP(a_ColorDepth);
-					png_compressed->Parse(a_ColorDepth);
+		uint32 depth = (uint32)m_BPPIdent << 16;
+		bool result = (png->SetBPP(depth) && png->Parse(depth));
+		if (!result)
+		{
+			TIL_ERROR_EXPLAIN("Could not parse embedded PNG image.");
+		}
 
-					Internal::MemCpy(
-						cur->buffer, 
-						png_compressed->GetPixels(), 
-						png_compressed->GetPitchX() * png_compressed->GetPitchY() * m_BPP
-					);
+		delete png;
 
-					delete png_compressed;
+		return result;
 
 #else
 
-					TIL_ERROR_EXPLAIN("Can't parse ICO without PNG loader.", 0);
-					Internal::MemSet(cur->buffer, 0, cur->width * cur->height * cur->bytespp);
+		TIL_ERROR_EXPLAIN("Can't parse ICO without PNG loader.", 0);
+		return false;
 
 #endif
 
-				}
-				else
-				{
-					ICO_DEBUG("Loading uncompressed data.");
-
-					m_Stream->Seek(cur->offset + 40, TIL_FILE_SEEK_START);
+	}
 
-					src = new byte[cur->width * cur->height * bpp];
-					m_Stream->Read(src, bpp, cur->width * cur->height);
+	bool ImageICO::FitsBetter(BufferICO* a_First, BufferICO* a_Second, uint32 a_Width, uint32 a_Height)
+	{
+		bool first_fits = (a_First->width >= a_Width && a_First->height >= a_Height);
+		bool second_fits = (a_Second->width >= a_Width && a_Second->height >= a_Height);
+		if (first_fits != second_fits) { return first_fits; }
 
-					byte* read = src;
+		// the smallest image that fits, or the largest that doesn't
+		uint32 first_area = a_First->width * a_First->height;
+		uint32 second_area = a_Second->width * a_Second->height;
+		if (first_area != second_area) { return (first_fits) ? (first_area < second_area) : (first_area > second_area); }
 
-					for (uint32 y = 0; y < cur->height; y++)
-					{
-						(this->*m_ColorFunc)(target, read, cur->width, bpp);
+		return (a_First->bitspp > a_Second->bitspp);
+	}
 
-						target -= pitch;
-						read += cur->pitch * cur->bytespp;
-					}
+	uint32 ImageICO::GetBestFrame(uint32 a_Width, uint32 a_Height)
+	{
+		uint32 best = 0;
 
-					delete src;
-				}
-			}
+		for (uint32 i = 1; i < m_Images; i++)
+		{
+			if (FitsBetter(&m_Entries[i], &m_Entries[best], a_Width, a_Height)) { best = i; }
 		}
 
-		return true;
+		return best;
 	}
 
 	uint32 ImageICO::GetFrameCount()
@@ -413,124 +459,52 @@ namespace til
 		return m_Images;
 	}
 
-	void ImageICO::ReleaseMemory(BufferICO* a_Buffer)
+	bool ImageICO::HasSizes()
 	{
-		if (a_Buffer && a_Buffer->next) 
-		{
-			ReleaseMemory(a_Buffer->next); 
-		}
-		delete a_Buffer->next;
-		delete a_Buffer->buffer;
-		if (a_Buffer->colors) { delete a_Buffer->colors; }
+		return true;
 	}
 
 	byte* ImageICO::GetPixels(uint32 a_Frame /*= 0*/)
 	{
-		if (a_Frame >= 0 && a_Frame < m_Images)
-		{
-			//if (a_Frame == 6) { a_Frame--; }
-			BufferICO* current = m_First;
-			for (uint32 i = 0; i < a_Frame; i++) { current = current->next; }
-			return current->buffer;
-		}
+		if (a_Frame >= m_Images) { return NULL; }
+
+		BufferICO* entry = &m_Entries[a_Frame];
 
-		return NULL;
+		m_Lock.Lock();
+		DecodeEntry(entry);
+		m_Lock.Unlock();
+
+		return entry->buffer;
 	}
 
 	uint32 ImageICO::GetWidth(uint32 a_Frame)
 	{
-		if (a_Frame >= 0 && a_Frame < m_Images)
-		{
-			BufferICO* current = m_First;
-			for (uint32 i = 0; i < a_Frame; i++) { current = current->next; }
-			return current->width;
-		}
-
-		return 0;
+		return (a_Frame < m_Images) ? m_Entries[a_Frame].width : 0;
 	}
 
 	uint32 ImageICO::GetHeight(uint32 a_Frame)
 	{
-		if (a_Frame >= 0 && a_Frame < m_Images)
-		{
-			BufferICO* current = m_First;
-			for (uint32 i = 0; i < a_Frame; i++) { current = current->next; }
-			return current->height;
-		}
-
-		return 0;
+		return (a_Frame < m_Images) ? m_Entries[a_Frame].height : 0;
 	}
 
 	uint32 ImageICO::GetPitchX(uint32 a_Frame /*= 0*/)
 	{
-		if (a_Frame >= 0 && a_Frame < m_Images)
-		{
-			BufferICO* current = m_First;
-			for (uint32 i = 0; i < a_Frame; i++) { current = current->next; }
-			return current->pitch;
-		}
-
-		return 0;
+		return (a_Frame < m_Images) ? m_Entries[a_Frame].pitch : 0;
 	}
 
 	uint32 ImageICO::GetPitchY(uint32 a_Frame /*= 0*/)
 	{
-		if (a_Frame >= 0 && a_Frame < m_Images)
-		{
-			BufferICO* current = m_First;
-			for (uint32 i = 0; i < a_Frame; i++) { current = current->next; }
-			return current->pitchy;
-		}
-
-		return 0;
+		return (a_Frame < m_Images) ? m_Entries[a_Frame].pitchy : 0;
 	}
 
-	void ImageICO::WriteColumnAnd(uint8* a_Dst, uint8* a_Src, uint32 a_Width, uint8* a_Palette, uint8* a_AndMask)
+	uint32 ImageICO::GetBitCount(uint32 a_Frame /*= 0*/)
 	{
-		uint32 bpp = m_BPP;
-
-		for (uint32 i = 0; i < a_Width; i += 8)
-		{
-			for (int32 j = 1; j < 8; j += 2)
-			{
-				if (GETBIT(*a_AndMask, j    ) == 0) 
-				{ 
-					Internal::MemCpy(a_Dst, &a_Palette[((*a_Src & 0xF0) >> 4) * bpp], bpp);
-				}
-				else
-				{
-					Internal::MemSet(a_Dst, 0, bpp);
-				}
-				a_Dst += bpp;
-
-				if (GETBIT(*a_AndMask, j - 1) == 0) 
-				{
-					Internal::MemCpy(a_Dst, &a_Palette[((*a_Src & 0x0F)     ) * bpp], bpp);
-				}
-				else
-				{
-					Internal::MemSet(a_Dst, 0, bpp);
-				}
-				a_Dst += bpp;
-
-				a_Src++;
-			}
-
-			a_AndMask++;
-		}
+		return (a_Frame < m_Images) ? m_Entries[a_Frame].bitspp : 0;
 	}
 
-	void ImageICO::WriteColumnPalette(uint8* a_Dst, uint8* a_Src, uint32 a_Width, uint8* a_Palette)
+	bool ImageICO::IsPNG(uint32 a_Frame /*= 0*/)
 	{
-		uint32 bpp = m_BPP;
-
-		for (uint32 i = 0; i < a_Width; i++)
-		{
-			Internal::MemCpy(a_Dst, &a_Palette[*a_Src * bpp], bpp);
-
-			a_Dst += bpp;
-			a_Src++;
-		}
+		return (a_Frame < m_Images) ? m_Entries[a_Frame].png : false;
 	}
 
 	void ImageICO::ColorFunc_A8R8G8B8(uint8* a_Dst, uint8* a_Src, uint32 a_Width, uint32 a_BPP)
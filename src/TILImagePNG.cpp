@@ -137,15 +137,15 @@ namespace til
 
 	typedef uint8 (*FilterFunc)(uint8*, uint8*, uint8*, int, int);
 
-	uint8 FilterFuncNone       (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncNone       (uint8* /*a_Cur*/, uint8* a_Target, uint8* /*a_Prior*/, int a_Index, int /*a_Size*/) 
 	{ 
 		return a_Target[a_Index]; 
 	}
-	uint8 FilterFuncSub        (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncSub        (uint8* a_Cur, uint8* a_Target, uint8* /*a_Prior*/, int a_Index, int a_Size) 
 	{ 
 		return a_Target[a_Index] + a_Cur[a_Index - a_Size]; 
 	}
-	uint8 FilterFuncUp         (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncUp         (uint8* /*a_Cur*/, uint8* a_Target, uint8* a_Prior, int a_Index, int /*a_Size*/) 
 	{ 
 		return a_Target[a_Index] + a_Prior[a_Index]; 
 	}
@@ -157,20 +157,20 @@ namespace til
 	{ 
 		return (uint8)(a_Target[a_Index] + paeth(a_Cur[a_Index - a_Size], a_Prior[a_Index], a_Prior[a_Index - a_Size]));
 	}
-	uint8 FilterFuncAvgFirst   (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncAvgFirst   (uint8* a_Cur, uint8* a_Target, uint8* /*a_Prior*/, int a_Index, int a_Size) 
 	{ 
 		return a_Target[a_Index] + (a_Cur[a_Index - a_Size] >> 1); 
 	}
-	uint8 FilterFuncAvgPixel   (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncAvgPixel   (uint8* /*a_Cur*/, uint8* a_Target, uint8* a_Prior, int a_Index, int /*a_Size*/) 
 	{ 
 		return a_Target[a_Index] + (a_Prior[a_Index] >> 1); 
 	}
-	uint8 FilterFuncPaethFirst (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncPaethFirst (uint8* a_Cur, uint8* a_Target, uint8* /*a_Prior*/, int a_Index, int a_Size) 
 	{ 
 		return (uint8)(a_Target[a_Index] + paeth(a_Cur[a_Index - a_Size], 0, 0)); 
 		//return (uint8)(a_Target[a_Index] + paeth_left(a_Cur[a_Index - a_Size])); 
 	}
-	uint8 FilterFuncPaethPixel (uint8* a_Cur, uint8* a_Target, uint8* a_Prior, int a_Index, int a_Size) 
+	uint8 FilterFuncPaethPixel (uint8* /*a_Cur*/, uint8* a_Target, uint8* a_Prior, int a_Index, int /*a_Size*/) 
 	{ 
 		return (uint8)(a_Target[a_Index] + paeth(0, a_Prior[a_Index], 0));
 		//return (uint8)(a_Target[a_Index] + paeth_middle(a_Prior[a_Index]));
@@ -418,16 +418,18 @@ namespace til
 		for (int i = 0; i <= 31; ++i) { default_distance[i] = 5; }
 
 		buffer = NULL;
-		bigger_data = NULL;
 		z_length = NULL;
 		z_distance = NULL;
+
+		fill = NULL;
+		flush = NULL;
+		user = NULL;
+		zout_flushed = NULL;
 	}
 
 	zbuf::~zbuf()
 	{
-		//delete buffer;
-		//if (buffer) { delete buffer; }
-		if (bigger_data) { delete bigger_data; }
+		if (buffer) { delete [] buffer; }
 		if (z_length) { delete z_length; }
 		if (z_distance) { delete z_distance; }
 
@@ -447,10 +449,24 @@ namespace til
 
 	int32 zbuf::GetByte()
 	{
-		if (zbuffer >= zbuffer_end) { return 0; }
+		if (zbuffer >= zbuffer_end && !Refill()) { return 0; }
 		return *zbuffer++;
 	}
 
+	bool zbuf::Refill()
+	{
+		if (!fill) { return false; }
+
+		uint8* data;
+		uint32 length;
+		if (!fill(user, &data, &length) || length == 0) { return false; }
+
+		zbuffer = data;
+		zbuffer_end = data + length;
+
+		return true;
+	}
+
 	uint32 zbuf::GetCode( uint32 a_Amount )
 	{
 		if (num_bits < a_Amount) 
@@ -522,7 +538,7 @@ namespace til
 		}
 		// code size is s, so:
 		b = (k >> (16 - s)) - a_Huffman->firstcode[s] + a_Huffman->firstsymbol[s];
-		if (a_Huffman->size[b] != s)
+		if (b < 0 || b >= 288 || a_Huffman->size[b] != s)
 		{
 			TIL_ERROR_EXPLAIN("Huffman size doesn't match code size.");
 			return -1;
@@ -535,6 +551,26 @@ namespace til
 
 	bool zbuf::Expand( int32 a_Amount )
 	{
+		if (flush)
+		{
+			// pass on what was written, but keep the window 
+			// that matches are allowed to refer back to
+
+			if (zout > zout_flushed && !flush(user, (byte*)zout_flushed, (uint32)(zout - zout_flushed)))
+			{
+				return false;
+			}
+
+			int keep = (int)(zout - zout_start);
+			if (keep > 32768) { keep = 32768; }
+
+			memmove(zout_start, zout - keep, keep);
+			zout = zout_start + keep;
+			zout_flushed = zout;
+
+			return true;
+		}
+
 		if (!z_expandable) 
 		{
 			TIL_ERROR_EXPLAIN("Could not expand ZLib buffer, reached limit.");
@@ -547,21 +583,23 @@ namespace til
 		// double until greater
 		while (cur + a_Amount > limit) { limit *= 2; }
 
-		bigger_data = new char[limit];
-		memcpy(bigger_data, zout_start, limit / 2);
-		delete zout_start;
+		char* bigger = new char[limit];
+		memcpy(bigger, zout_start, cur);
+		delete [] buffer;
+		buffer = bigger;
 
-		zout_start = bigger_data;
-		zout       = bigger_data + cur;
-		zout_end   = bigger_data + limit;
+		zout_start = bigger;
+		zout       = bigger + cur;
+		zout_end   = bigger + limit;
 
 		return true;
 	}
 
-	Huffman* zbuf::ZLibDecode(uint8* a_Data, uint32 a_Length)
+	bool zbuf::ZLibDecode(uint8* a_Data, uint32 a_Length)
 	{
 		const int32 initial_size = 16384;
 
+		if (buffer) { delete [] buffer; }
 		buffer = new char[initial_size];
 
 		zbuffer = (uint8*)a_Data;
@@ -572,33 +610,97 @@ namespace til
 		zout_end      = buffer + initial_size;
 		z_expandable  = 1;
 
-		// check header	
+		fill = NULL;
+		flush = NULL;
+
+		return (ParseHeader() && ParseBlocks());
+	}
+
+	bool zbuf::Stream(FillFunc a_Fill, FlushFunc a_Flush, void* a_User)
+	{
+		// room for the window and the longest uncompressed block
+		const int32 size = 32768 * 4;
+
+		if (buffer) { delete [] buffer; }
+		buffer = new char[size];
+
+		zbuffer = NULL;
+		zbuffer_end = NULL;
+
+		zout_start    = buffer;
+		zout          = buffer;
+		zout_end      = buffer + size;
+		zout_flushed  = buffer;
+		z_expandable  = 1;
+
+		fill = a_Fill;
+		flush = a_Flush;
+		user = a_User;
+
+		bool result = (ParseHeader() && ParseBlocks());
+		if (result && zout > zout_flushed)
+		{
+			result = flush(user, (byte*)zout_flushed, (uint32)(zout - zout_flushed));
+		}
+
+		fill = NULL;
+		flush = NULL;
+
+		return result;
+	}
 
+	bool zbuf::ParseHeader()
+	{
 		int cmf   = GetByte();
 		int cm    = cmf & 15;
 		int flg   = GetByte();
 		if ((cmf * 256 + flg) % 31 != 0) 
 		{
 			TIL_ERROR_EXPLAIN("Bad ZLib header.", 0);
-			return NULL;
+			return false;
 		}
 		if (flg & 32) 
 		{
 			TIL_ERROR_EXPLAIN("Preset dictionary not allowed.", 0);
-			return NULL;
+			return false;
 		}
 		if (cm != 8)
 		{
 			TIL_ERROR_EXPLAIN("Bad compression.", 0);
-			return NULL;
+			return false;
 		}
 
+		return true;
+	}
+
+	bool zbuf::Inflate(uint8* a_Data, uint32 a_Length, byte* a_Dst, uint32 a_DstLength)
+	{
+		zbuffer = a_Data;
+		zbuffer_end = a_Data + a_Length;
+
+		// the output can't grow, so data that decodes to more than 
+		// expected fails instead of writing past the end
+		zout_start    = (char*)a_Dst;
+		zout          = zout_start;
+		zout_end      = zout_start + a_DstLength;
+		z_expandable  = 0;
+
+		fill = NULL;
+		flush = NULL;
+
+		return (ParseBlocks() && zout == zout_end);
+	}
+
+	bool zbuf::ParseBlocks()
+	{
 		num_bits = 0;
 		code_buffer = 0;
 
 		int final = 0;
 
-		Huffman* result = NULL;
+		// the tables are reused for every block
+		if (!z_length) { z_length = new Huffman(); }
+		if (!z_distance) { z_distance = new Huffman(); }
 
 		do 
 		{
@@ -607,14 +709,13 @@ namespace til
 
 			if (type == 0) 
 			{
-				ParseUncompressedBlock();
-				return NULL;
+				if (!ParseUncompressedBlock()) { return false; }
 			} 
 			// indexed color
 			else if (type == 3) 
 			{
 				TIL_ERROR_EXPLAIN("TODO: Type == 3.", 0);
-				return NULL;
+				return false;
 			} 
 			else 
 			{
@@ -642,23 +743,23 @@ namespace til
 						codelength_sizes[length_dezigzag[i]] = (uint8)s;
 					}
 
-					result = new Huffman();
-					if (!result->Build(codelength_sizes, 19))
+					Huffman codelength;
+					if (!codelength.Build(codelength_sizes, 19))
 					{
 						TIL_ERROR_EXPLAIN("Failed to build Huffman thing.", 0);
-						return NULL;
+						return false;
 					}
 
 					int n = 0;
 					while (n < hlit + hdist) 
 					{
 						//int c = zhuffman_decode(a, &z_codelength);
-						int c = this->HuffmanDecode(result);
+						int c = HuffmanDecode(&codelength);
 						//assert(c >= 0 && c < 19);
 						if (c < 0 || c >= 19)
 						{
 							TIL_ERROR_EXPLAIN("Couldn't Huffman decode data.", 0);
-							return NULL;
+							return false;
 						}
 						if (c < 16)
 						{
@@ -666,6 +767,11 @@ namespace til
 						}
 						else if (c == 16) 
 						{
+							if (n == 0)
+							{
+								TIL_ERROR_EXPLAIN("Nothing to repeat.", 0);
+								return false;
+							}
 							c = GetCode(2) + 3;
 							memset(lencodes + n, lencodes[n - 1], c);
 							n += c;
@@ -681,7 +787,7 @@ namespace til
 							if (c != 18)
 							{
 								TIL_ERROR_EXPLAIN("C is too big.", 0);
-								return NULL;
+								return false;
 							}
 							c = GetCode(7) + 11;
 							memset(lencodes + n, 0, c);
@@ -692,16 +798,14 @@ namespace til
 					if (n != hlit + hdist) 
 					{
 						TIL_ERROR_EXPLAIN("Bad codelength.", 0);
-						return NULL;
+						return false;
 					}
 
-					z_length = new Huffman();
-					if (!z_length->Build(lencodes, hlit))
+					if (!z_length->Build(lencodes, hlit) || !z_distance->Build(lencodes + hlit, hdist))
 					{
 						TIL_ERROR_EXPLAIN("Could not build z_length.", 0);
+						return false;
 					}
-					z_distance = new Huffman();
-					z_distance->Build(lencodes + hlit, hdist);
 				}
 
 				// parse block
@@ -714,7 +818,7 @@ namespace til
 						if (z < 0) 
 						{
 							TIL_ERROR_EXPLAIN("Bad Huffman code. (%i)", z);
-							return NULL;
+							return false;
 						}
 
 						if (zout >= zout_end) 
@@ -722,8 +826,8 @@ namespace til
 							PNG_DEBUG("Expanding buffer.");
 							if (!Expand(1))
 							{
-								TIL_ERROR_EXPLAIN("Could not expand stuff.", 0);
-								return 0;
+								if (!flush) { TIL_ERROR_EXPLAIN("Could not expand stuff.", 0); }
+								return false;
 							}
 						}
 						*zout++ = (char)z;
@@ -747,7 +851,7 @@ namespace til
 						if (z < 0) 
 						{
 							TIL_ERROR_EXPLAIN("Bad Huffman code. (%i)", z);
-							return NULL;
+							return false;
 						}
 
 						int dist = dist_base[z];
@@ -758,14 +862,14 @@ namespace til
 						if (zout - zout_start < dist) 
 						{
 							TIL_ERROR_EXPLAIN("Bad distance. (%i)", dist);
-							return NULL;
+							return false;
 						}
 						if (zout + len > zout_end) 
 						{
 							if (!Expand(len)) 
 							{
-								TIL_ERROR_EXPLAIN("Could not expand stuff.", 0);
-								return NULL;
+								if (!flush) { TIL_ERROR_EXPLAIN("Could not expand stuff.", 0); }
+								return false;
 							}
 						}
 
@@ -780,10 +884,7 @@ namespace til
 		} 
 		while (!final);
 
-		//return result;
-		delete result;
-
-		return NULL;
+		return true;
 	}
 
 	bool zbuf::ParseUncompressedBlock()
@@ -815,11 +916,6 @@ namespace til
 			TIL_ERROR_EXPLAIN("Corrupt PNG: ZLib corrupt", 0);
 			return false;
 		}
-		if (zbuffer + len > zbuffer_end)
-		{
-			TIL_ERROR_EXPLAIN("Corrupt PNG: read past buffer", 0);
-			return false;
-		}
 		if (zout + len > zout_end)
 		{
 			if (!Expand(len)) 
@@ -828,9 +924,23 @@ namespace til
 			}
 		}
 
-		memcpy(zout, zbuffer, len);
-		zbuffer += len;
-		zout += len;
+		// streamed input can end in the middle of the block
+		while (len > 0)
+		{
+			if (zbuffer >= zbuffer_end && !Refill())
+			{
+				TIL_ERROR_EXPLAIN("Corrupt PNG: read past buffer", 0);
+				return false;
+			}
+
+			int copy = (int)(zbuffer_end - zbuffer);
+			if (copy > len) { copy = len; }
+
+			memcpy(zout, zbuffer, copy);
+			zbuffer += copy;
+			zout += copy;
+			len -= copy;
+		}
 
 		return true;
 	}
@@ -852,65 +962,136 @@ namespace til
 		uint32 pitch_dst = a_Pitch;
 		uint32 pitch_src = a_Width * 4;
 
-		// NOTE: Magic number 4
-		a_Dst += (pitch_dst * a_OffsetY) + (a_OffsetX * 4);
+		a_Dst += (pitch_dst * a_OffsetY) + (a_OffsetX * m_BPP);
 
 		for (uint32 j = 0; j < a_Height; ++j) 
 		{
-			byte* dst = a_Dst;
-			uint8* src = cur;
-			uint8* prior = cur - pitch_src;
-
-			int filter = *a_Src++;
-			if (filter > 4) 
+			if (!UnfilterRow(a_Src, cur, cur - pitch_src, a_Width, a_Depth, (j == 0)))
 			{
-				TIL_ERROR_EXPLAIN("Invalid filter (%i).", filter);
-				return false;								
+				delete [] out;
+				return false;
 			}
+			ConvertRow(a_Dst, cur, a_Width);
 
-			// if first row, use special filter that doesn't sample previous row
-			if (j == 0) 
-			{
-				filter = first_row_filter[filter];
-			}
+			a_Src += (a_Width * a_Depth) + 1;
+			cur += pitch_src;
+			a_Dst += pitch_dst;
+		}
+
+		delete [] out;
+
+		return true;
+	}
+
+	bool ImagePNG::UnfilterRow(byte* a_Src, uint8* a_Cur, uint8* a_Prior, uint32 a_Width, int a_Depth, bool a_First)
+	{
+		uint8* src = a_Cur;
+		uint8* prior = a_Prior;
 
-			// handle first pixel explicitly
+		int filter = *a_Src++;
+		if (filter > 4) 
+		{
+			TIL_ERROR_EXPLAIN("Invalid filter (%i).", filter);
+			return false;								
+		}
 
+		// if first row, use special filter that doesn't sample previous row
+		if (a_First) 
+		{
+			filter = first_row_filter[filter];
+		}
+
+		// handle first pixel explicitly
+
+		src[3] = 255;
+		for (int k = 0; k < a_Depth; ++k)
+		{
+			src[k] = g_FilterFirst[filter](src, a_Src, prior, k, a_Depth);
+		}
+
+		a_Src += a_Depth;
+		src   += 4;
+		prior += 4;
+
+		for (int i = a_Width - 1; i >= 1; --i)
+		{
 			src[3] = 255;
 			for (int k = 0; k < a_Depth; ++k)
 			{
-				src[k] = g_FilterFirst[filter](src, a_Src, prior, k, a_Depth);
+				src[k] = g_Filter[filter](src, a_Src, prior, k, 4);
 			}
 
-			(this->*m_ColorFunc)(dst, src);
-			dst += 4;
+			a_Src  += a_Depth;
+			src    += 4;
+			prior  += 4;
+		}
 
-			a_Src += a_Depth;
-			src   += 4;
-			prior += 4;
+		return true;
+	}
 
-			for (int i = a_Width - 1; i >= 1; --i)
+	void ImagePNG::ConvertRow(byte* a_Dst, uint8* a_Src, uint32 a_Count)
+	{
+		if (pal_img_n || has_trans || img_n < 3)
+		{
+			uint8 color[4];
+			for (uint32 i = 0; i < a_Count; i++)
 			{
-				src[3] = 255;
-				for (int k = 0; k < a_Depth; ++k)
-				{
-					src[k] = g_Filter[filter](src, a_Src, prior, k, 4);
-				}
-				(this->*m_ColorFunc)(dst, src);
-				dst += 4;
+				ExpandPixel(color, a_Src);
+				(this->*m_ColorFunc)(a_Dst, color);
 
-				a_Src  += a_Depth;
-				src    += 4;
-				prior  += 4;
+				a_Dst += m_BPP;
+				a_Src += 4;
 			}
 
-			cur += pitch_src;
-			a_Dst += pitch_dst;
+			return;
 		}
 
-		delete out;
+		for (uint32 i = 0; i < a_Count; i++)
+		{
+			(this->*m_ColorFunc)(a_Dst, a_Src);
 
-		return true;
+			a_Dst += m_BPP;
+			a_Src += 4;
+		}
+	}
+
+	void ImagePNG::ExpandPixel(uint8* a_Dst, uint8* a_Src)
+	{
+		if (pal_img_n)
+		{
+			uint8* entry = &palette[a_Src[0] * 4];
+			a_Dst[0] = entry[0];
+			a_Dst[1] = entry[1];
+			a_Dst[2] = entry[2];
+			a_Dst[3] = entry[3];
+
+			return;
+		}
+
+		if (img_n < 3)
+		{
+			a_Dst[0] = a_Src[0];
+			a_Dst[1] = a_Src[0];
+			a_Dst[2] = a_Src[0];
+			a_Dst[3] = (img_n == 2) ? a_Src[1] : 255;
+		}
+		else
+		{
+			a_Dst[0] = a_Src[0];
+			a_Dst[1] = a_Src[1];
+			a_Dst[2] = a_Src[2];
+			a_Dst[3] = a_Src[3];
+		}
+
+		// tRNS is only allowed for gray and RGB images
+		if (has_trans)
+		{
+			bool match = (img_n == 1) ? 
+				(a_Src[0] == tc[0]) : 
+				(a_Src[0] == tc[0] && a_Src[1] == tc[1] && a_Src[2] == tc[2]);
+
+			if (match) { a_Dst[3] = 0; }
+		}
 	}
 
 #endif
@@ -990,7 +1171,7 @@ namespace til
 				PNG_DEBUG("ZLib length: %i", len);
 				PNG_DEBUG("Size: (%i, %i) Offset: (%i, %i)", w, h, ox, oy);
 
-				instance->Decompile(a_Data[curr], final, w, h, pitchx * image_bpp, image_bpp, ox, oy);
+				instance->Decompile(a_Data[curr], final, w, h, pitchx * bpp, image_bpp, ox, oy);
 
 				if (dispose != APNG_DISPOSE_OP_PREVIOUS)
 				{
@@ -1038,6 +1219,28 @@ namespace til
 		byte dispose, blend;
 	};	
 
+	struct ImagePNG::RowState
+	{
+		ImagePNG* instance;
+
+		// IDAT data that hasn't been read yet
+		uint32 left;
+		bool done;
+		uint8* input;
+		uint32 input_size;
+
+		// a filtered row as it is stored
+		byte* raw;
+		uint32 raw_pitch, raw_used;
+
+		// the unfiltered row and the one before it
+		uint8* cur;
+		uint8* prior;
+
+		byte* pixels;
+		uint32 row;
+	};
+
 #endif
 
 	// =========================================
@@ -1048,6 +1251,7 @@ namespace til
 	{
 		m_Ani = NULL;
 		m_Pixels = NULL;
+		m_Target = NULL;
 		m_Huffman = NULL;
 		m_Chunk = new chunk;
 
@@ -1065,10 +1269,27 @@ namespace til
 		if (out) { delete out; }
 
 		if (m_Ani) { delete m_Ani; }
-		if (m_Pixels) { delete [] m_Pixels; }
+		if (m_Pixels)
+		{
+			// the target belongs to the caller
+			for (uint32 i = 0; i < m_Frames; i++)
+			{
+				if (m_Pixels[i] != m_Target) { delete [] m_Pixels[i]; }
+			}
+			delete [] m_Pixels;
+		}
 		if (m_Huffman) { delete m_Huffman; }
 	}
 
+	void ImagePNG::SetTarget(byte* a_Pixels, uint32 a_Width, uint32 a_Height, uint32 a_PitchX, uint32 a_PitchY)
+	{
+		m_Target = a_Pixels;
+		m_TargetWidth = a_Width;
+		m_TargetHeight = a_Height;
+		m_PitchX = a_PitchX;
+		m_PitchY = a_PitchY;
+	}
+
 	byte ImagePNG::GetByte()
 	{
 		byte temp;
@@ -1131,10 +1352,9 @@ namespace til
 			return false;
 		}
 
-		uint8 palette[1024];
 		pal_img_n = 0;
 		has_trans = 0;
-		uint8 tc[3];
+		memset(palette, 0, sizeof(palette));
 		ioff = 0;
 		uint32 idata_limit = 0;
 		uint32 i;
@@ -1191,7 +1411,7 @@ namespace til
 
 		default:
 			TIL_ERROR_EXPLAIN("Unhandled color format: %i", m_BPPIdent);
-			break;
+			return false;
 
 		}
 
@@ -1260,6 +1480,12 @@ namespace til
 					PNG_DEBUG("Width: %i", m_Width);
 					PNG_DEBUG("Height: %i", m_Height);
 
+					if (m_Target && (m_Width != m_TargetWidth || m_Height != m_TargetHeight))
+					{
+						TIL_ERROR_EXPLAIN("Image is (%i, %i), expected (%i, %i).", m_Width, m_Height, m_TargetWidth, m_TargetHeight);
+						return NULL;
+					}
+
 					//Internal::SetPitch(a_Options, m_Width, m_Height, m_PitchX, m_PitchY);
 
 					depth = GetByte(); 
@@ -1342,7 +1568,7 @@ namespace til
 					if (!pal_img_n) 
 					{
 						img_n = (color & 2 ? 3 : 1) + (color & 4 ? 1 : 0);
-						if ((1 << 30) / (m_Width * img_n) < m_Height) 
+						if (!m_RowFunc && (1 << 30) / (m_Width * img_n) < m_Height) 
 						{
 							TIL_ERROR_EXPLAIN("Image too large to decode.", 0);
 							return NULL;
@@ -1353,7 +1579,7 @@ namespace til
 						// if paletted, then pal_n is our final components, and
 						// img_n is # components to decompress/filter.
 						img_n = 1;
-						if ((1 << 30) / m_Width / 4 < m_Height) 
+						if (!m_RowFunc && (1 << 30) / m_Width / 4 < m_Height) 
 						{
 							TIL_ERROR_EXPLAIN("Too much data.", 0);
 							return NULL;
@@ -1370,6 +1596,13 @@ namespace til
 
 					PNG_DEBUG("Found chunk 'acTL' indicating APNG animation.", 0);			
 
+					// only the default image is passed on row by row
+					if (m_RowFunc)
+					{
+						Skip(m_Chunk->length);
+						break;
+					}
+
 					m_Frames = (uint32)GetDWord();
 
 					PNG_DEBUG("Frames: %i", m_Frames);
@@ -1397,7 +1630,7 @@ namespace til
 					}
 
 					pal_len = m_Chunk->length / 3;
-					if (pal_len * 3 != m_Chunk->length) 
+					if (pal_len * 3 != m_Chunk->length || pal_len > 256) 
 					{
 						TIL_ERROR_EXPLAIN("Invalid PLTE.", 0);
 						return NULL;
@@ -1481,6 +1714,13 @@ namespace til
 						return NULL;
 					}
 
+					// the image is passed on while it's decompressed, 
+					// so the whole of it is never in memory
+					if (m_RowFunc)
+					{
+						return DecodeRows();
+					}
+
 					if (ioff + m_Chunk->length > idata_limit) 
 					{
 						if (idata_limit == 0) 
@@ -1517,6 +1757,12 @@ namespace til
 
 					PNG_DEBUG("Found chunk 'fcTL'", 0);
 
+					if (m_RowFunc)
+					{
+						Skip(m_Chunk->length);
+						break;
+					}
+
 					if (!m_Ani)
 					{
 						TIL_ERROR_EXPLAIN("'fcTL' chunk before 'acTL' chunk.", 0);
@@ -1544,8 +1790,7 @@ namespace til
 					{
 						if (!m_Pixels)
 						{
-							m_Pixels = new byte*[m_Frames];
-							m_Pixels[0] = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+							CreateFrames();
 						}
 
 						if (m_Ani->index == 2 && m_Ani->chunk_idat)
@@ -1564,8 +1809,7 @@ namespace til
 							if (!m_Pixels)
 							{
 								m_Frames++;
-								m_Pixels = new byte*[m_Frames];
-								m_Pixels[0] = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+								CreateFrames();
 							}
 
 							Compose();
@@ -1694,8 +1938,7 @@ namespace til
 
 					if (!m_Pixels)
 					{
-						m_Pixels = new byte*[m_Frames];
-						m_Pixels[0] = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+						CreateFrames();
 
 						Compose();
 					}
@@ -1744,16 +1987,8 @@ namespace til
 		m_RawLength = (uint32)(m_ZBuffer.zout - m_ZBuffer.zout_start);
 		unsigned char* target = (unsigned char*)m_ZBuffer.zout_start;
 
-		img_out_n = 4;
-
 		// create png image
 
-		if (img_out_n != img_n && img_out_n != img_n + 1)
-		{
-			TIL_ERROR_EXPLAIN("Wrong bitdepth.", 0);
-			return false;
-		}
-
 		if (m_RawLength != (img_n * m_Width + 1) * m_Height) 
 		{
 			TIL_ERROR_EXPLAIN("Not enough pixels. (%i vs %i)", m_RawLength, (img_n * m_Width + 1) * m_Height);
@@ -1763,46 +1998,156 @@ namespace til
 		byte* write = m_Pixels[0]; // first is default image
 		//byte* write = m_Data[0]->GetData();
 
-		m_Pitch = m_PitchX * 4;
-		Decompile(write, target, m_Width, m_Height, m_Pitch, img_n);
+		m_Pitch = m_PitchX * m_BPP;
+		// the palette and transparent color are applied while converting the rows
+		return Decompile(write, target, m_Width, m_Height, m_Pitch, img_n);
+	}
 
-		if (has_trans)
+	bool ImagePNG::DecodeRows()
+	{
+		if (!CheckRegion(m_Width, m_Height)) { return false; }
+
+		RowState state;
+		state.instance = this;
+
+		state.left = m_Chunk->length;
+		state.done = false;
+		state.input_size = 65536;
+		state.input = new uint8[state.input_size];
+
+		state.raw_pitch = (img_n * m_Width) + 1;
+		state.raw_used = 0;
+		state.raw = new byte[state.raw_pitch];
+
+		state.cur = new uint8[m_Width * 4];
+		state.prior = new uint8[m_Width * 4];
+		memset(state.cur, 0, m_Width * 4);
+		memset(state.prior, 0, m_Width * 4);
+
+		state.pixels = new byte[m_Width * m_BPP];
+		state.row = 0;
+
+		zbuf decompress;
+		bool result = decompress.Stream(&ImagePNG::FillRows, &ImagePNG::FlushRows, &state);
+		if (result && state.row != m_Height)
 		{
-			TIL_ERROR_EXPLAIN("TODO: Compute transparancy.", 0);
+			TIL_ERROR_EXPLAIN("Not enough pixels. (%i vs %i rows)", state.row, m_Height);
+			result = false;
+		}
+
+		delete [] state.input;
+		delete [] state.raw;
+		delete [] state.cur;
+		delete [] state.prior;
+		delete [] state.pixels;
 
-			/*if (!compute_transparency(z, tc, s->img_out_n)) 
+		return result;
+	}
+
+	bool ImagePNG::FillRows(void* a_User, uint8** a_Data, uint32* a_Length)
+	{
+		RowState* state = (RowState*)a_User;
+		ImagePNG* png = state->instance;
+
+		// the image data can be split over multiple IDAT chunks
+		while (state->left == 0)
+		{
+			if (state->done) { return false; }
+
+			png->GetDWord(); // CRC
+			png->GetChunkHeader();
+			if (png->m_Chunk->type != PNG_TYPE('I','D','A','T'))
 			{
-				return 0;
-			}*/
+				state->done = true;
+				return false;
+			}
+
+			state->left = png->m_Chunk->length;
+		}
 
+		uint32 read = (state->left < state->input_size) ? state->left : state->input_size;
+		if (!png->m_Stream->ReadByte(state->input, read))
+		{
+			TIL_ERROR_EXPLAIN("Not enough data.", 0);
+			state->done = true;
 			return false;
 		}
+		state->left -= read;
+
+		*a_Data = state->input;
+		*a_Length = read;
 
-		if (pal_img_n) 
+		return true;
+	}
+
+	bool ImagePNG::FlushRows(void* a_User, byte* a_Data, uint32 a_Length)
+	{
+		RowState* state = (RowState*)a_User;
+		ImagePNG* png = state->instance;
+
+		while (a_Length > 0)
 		{
-			// pal_img_n == 3 or 4
-			img_n = pal_img_n; // record the actual colors we had
-			img_out_n = pal_img_n;
-			if (req_comp >= 3) 
+			if (state->row >= png->m_Height)
 			{
-				img_out_n = req_comp;
+				TIL_ERROR_EXPLAIN("Too many pixels.", 0);
+				return false;
 			}
 
-			TIL_ERROR_EXPLAIN("TODO: Expand palette.", 0);
+			uint32 copy = state->raw_pitch - state->raw_used;
+			if (copy > a_Length) { copy = a_Length; }
 
-			return false;
+			memcpy(state->raw + state->raw_used, a_Data, copy);
+			state->raw_used += copy;
+			a_Data += copy;
+			a_Length -= copy;
+
+			if (state->raw_used < state->raw_pitch) { break; }
+
+			// the previous row becomes the prior one
+			uint8* swap = state->prior;
+			state->prior = state->cur;
+			state->cur = swap;
+
+			// columns to the right of the region are never needed, 
+			// not even by the rows below it
+
+			uint32 left = png->m_RegionX;
+			if (!png->UnfilterRow(state->raw, state->cur, state->prior, left + png->m_RegionWidth, png->img_n, (state->row == 0)))
+			{
+				return false;
+			}
 
-			/*if (!expand_palette(z, palette, pal_len, img_out_n))
+			if (state->row >= png->m_RegionY)
 			{
-				return 0;
-			}*/
+				png->ConvertRow(state->pixels + (left * png->m_BPP), state->cur + (left * 4), png->m_RegionWidth);
+				if (!png->PushRows(state->pixels, state->row, 1, png->m_Width, png->m_Height, png->m_Width * png->m_BPP))
+				{
+					return false;
+				}
+			}
+
+			state->row++;
+			state->raw_used = 0;
 		}
-					
-		//delete out;
 
 		return true;
 	}
 
+	void ImagePNG::CreateFrames()
+	{
+		m_Pixels = new byte*[m_Frames];
+		memset(m_Pixels, 0, m_Frames * sizeof(byte*));
+
+		if (m_Target)
+		{
+			m_Pixels[0] = m_Target;
+		}
+		else
+		{
+			m_Pixels[0] = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		}
+	}
+
 	uint32 ImagePNG::GetFrameCount()
 	{
 		return m_Frames;
@@ -0,0 +1,237 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+
+/*!
+	\file TILImageRegion.cpp
+*/
+
+#include "TILImageRegion.h"
+#include "TILInternal.h"
+
+#include <string.h>
+
+namespace til
+{
+
+	ImageRegion::ImageRegion() : Image()
+	{
+		m_Pixels = NULL;
+		m_Width = m_Height = 0;
+		m_PitchX = m_PitchY = 0;
+		m_BottomUp = false;
+		m_Size = m_Shift = 0;
+		m_SourceWidth = m_SourceHeight = 0;
+		m_Sums = NULL;
+	}
+
+	ImageRegion::~ImageRegion()
+	{
+		if (m_Pixels) { delete [] m_Pixels; }
+		if (m_Sums) { delete [] m_Sums; }
+	}
+
+	bool ImageRegion::Parse(uint32 /*a_Options*/)
+	{
+		return true;
+	}
+
+	bool ImageRegion::Crop(Image* a_Image, uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height)
+	{
+		if (!SetBPP(a_Options & TIL_DEPTH_MASK) || m_BPP == 0)
+		{
+			TIL_ERROR_EXPLAIN("Regions can't be decoded with this bit-depth: %i.", a_Options & TIL_DEPTH_MASK);
+			return false;
+		}
+
+		m_BottomUp = ((a_Options & TIL_LOAD_BOTTOMUP) != 0);
+
+		// formats stored at several sizes pick the size themselves
+		m_Size = a_Image->HasSizes() ? 0 : TIL_LOAD_GETSIZE(a_Options);
+
+		if (!a_Image->DecodeRegion(a_Options, a_X, a_Y, a_Width, a_Height, &ImageRegion::CopyRows, this)) 
+		{ 
+			return false; 
+		}
+
+		return (m_Pixels != NULL);
+	}
+
+	bool ImageRegion::CopyRows(RowData* a_Data)
+	{
+		ImageRegion* region = (ImageRegion*)a_Data->user;
+
+		// the size of the region is only known once the image was parsed
+		if (!region->m_Pixels && !region->CreateFrame(a_Data->width, a_Data->height)) { return false; }
+
+		uint32 size = a_Data->width * region->m_BPP;
+
+		byte* src = a_Data->pixels;
+		for (uint32 i = 0; i < a_Data->count; i++)
+		{
+			if (region->m_Shift > 0)
+			{
+				region->AddRow(a_Data->row + i, src);
+			}
+			else
+			{
+				memcpy(region->GetRow(a_Data->row + i), src, size);
+			}
+			src += a_Data->pitch;
+		}
+
+		return true;
+	}
+
+	bool ImageRegion::CreateFrame(uint32 a_Width, uint32 a_Height)
+	{
+		m_SourceWidth = a_Width;
+		m_SourceHeight = a_Height;
+
+		// the largest power of two that keeps the longest side at 
+		// least as large as the size hint, while the sums of a block 
+		// still fit in 32 bits
+
+		uint32 longest = (a_Width > a_Height) ? a_Width : a_Height;
+		m_Shift = 0;
+		if (m_Size > 0)
+		{
+			while (m_Shift < 12 && ((longest - 1) >> (m_Shift + 1)) + 1 >= m_Size) { m_Shift++; }
+		}
+
+		m_Width = ((a_Width - 1) >> m_Shift) + 1;
+		m_Height = ((a_Height - 1) >> m_Shift) + 1;
+
+		TIL_PRINT_DEBUG("Scaling (%i, %i) down to (%i, %i)", a_Width, a_Height, m_Width, m_Height);
+
+		m_Pixels = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		if (!m_Pixels) { return false; }
+
+		if (m_Shift > 0)
+		{
+			m_Sums = new uint32[m_Width * 4];
+			memset(m_Sums, 0, m_Width * 4 * sizeof(uint32));
+		}
+
+		return true;
+	}
+
+	byte* ImageRegion::GetRow(uint32 a_Row)
+	{
+		uint32 line = m_BottomUp ? (m_Height - 1 - a_Row) : a_Row;
+		return m_Pixels + (line * m_PitchX * m_BPP);
+	}
+
+	void ImageRegion::AddRow(uint32 a_Row, byte* a_Src)
+	{
+		if (m_BPP == 4)
+		{
+			for (uint32 x = 0; x < m_SourceWidth; x++)
+			{
+				uint32* sum = &m_Sums[(x >> m_Shift) << 2];
+				sum[0] += a_Src[0];
+				sum[1] += a_Src[1];
+				sum[2] += a_Src[2];
+				sum[3] += a_Src[3];
+				a_Src += 4;
+			}
+		}
+		else
+		{
+			// both 16-bit depths store their channels as 5, 6 and 5 bits
+			color_16b* src = (color_16b*)a_Src;
+			for (uint32 x = 0; x < m_SourceWidth; x++)
+			{
+				uint32* sum = &m_Sums[(x >> m_Shift) << 2];
+				sum[0] += (src[x] >> 11) & 0x1F;
+				sum[1] += (src[x] >> 5) & 0x3F;
+				sum[2] += src[x] & 0x1F;
+			}
+		}
+
+		// a block is done after its last row or the bottom of the image
+
+		uint32 block = 1 << m_Shift;
+		uint32 next = a_Row + 1;
+		if ((next & (block - 1)) != 0 && next != m_SourceHeight) { return; }
+
+		uint32 rows = next - ((a_Row >> m_Shift) << m_Shift);
+
+		byte* dst = GetRow(a_Row >> m_Shift);
+		for (uint32 x = 0; x < m_Width; x++)
+		{
+			// the blocks on the right and bottom edges can be smaller
+			uint32 left = x << m_Shift;
+			uint32 columns = (m_SourceWidth - left < block) ? (m_SourceWidth - left) : block;
+			uint32 count = rows * columns;
+			uint32 half = count >> 1;
+
+			uint32* sum = &m_Sums[x << 2];
+			if (m_BPP == 4)
+			{
+				dst[0] = (byte)((sum[0] + half) / count);
+				dst[1] = (byte)((sum[1] + half) / count);
+				dst[2] = (byte)((sum[2] + half) / count);
+				dst[3] = (byte)((sum[3] + half) / count);
+				dst += 4;
+			}
+			else
+			{
+				((color_16b*)dst)[x] = (color_16b)(
+					(((sum[0] + half) / count) << 11) | 
+					(((sum[1] + half) / count) << 5) | 
+					((sum[2] + half) / count)
+				);
+			}
+		}
+
+		memset(m_Sums, 0, m_Width * 4 * sizeof(uint32));
+	}
+
+	byte* ImageRegion::GetPixels(uint32 a_Frame /*= 0*/)
+	{
+		return m_Pixels;
+	}
+
+	uint32 ImageRegion::GetWidth(uint32 a_Frame /*= 0*/)
+	{
+		return m_Width;
+	}
+
+	uint32 ImageRegion::GetHeight(uint32 a_Frame /*= 0*/)
+	{
+		return m_Height;
+	}
+
+	uint32 ImageRegion::GetPitchX(uint32 a_Frame /*= 0*/)
+	{
+		return m_PitchX;
+	}
+
+	uint32 ImageRegion::GetPitchY(uint32 a_Frame /*= 0*/)
+	{
+		return m_PitchY;
+	}
+
+}; // namespace til
\ No newline at end of file
@@ -0,0 +1,550 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+/*!
+	\file TILImageResized.cpp
+*/
+
+#include "TILImageResized.h"
+#include "TILInternal.h"
+#include "TILThreads.h"
+
+#include <string.h>
+#include <math.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	#define RESIZE_BAND_HEIGHT           32
+	#define RESIZE_WEIGHT_BITS           14
+	#define RESIZE_ROW_BITS              6
+#endif
+
+namespace til
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+	static float FilterBox(float a_X)
+	{
+		return (a_X >= -0.5f && a_X < 0.5f) ? 1.0f : 0.0f;
+	}
+
+	static float FilterBilinear(float a_X)
+	{
+		if (a_X < 0.0f) { a_X = -a_X; }
+		return (a_X < 1.0f) ? (1.0f - a_X) : 0.0f;
+	}
+
+	static float FilterMitchell(float a_X)
+	{
+		// B = C = 1/3
+
+		if (a_X < 0.0f) { a_X = -a_X; }
+
+		float x2 = a_X * a_X;
+		float x3 = x2 * a_X;
+
+		if (a_X < 1.0f) 
+		{ 
+			return ((7.0f * x3) - (12.0f * x2) + (16.0f / 3.0f)) / 6.0f; 
+		}
+		else if (a_X < 2.0f) 
+		{ 
+			return ((-7.0f / 3.0f * x3) + (12.0f * x2) - (20.0f * a_X) + (32.0f / 3.0f)) / 6.0f; 
+		}
+
+		return 0.0f;
+	}
+
+	static float Sinc(float a_X)
+	{
+		if (a_X == 0.0f) { return 1.0f; }
+
+		float x = a_X * 3.14159265f;
+		return (float)sin(x) / x;
+	}
+
+	static float FilterLanczos(float a_X)
+	{
+		// three lobes
+		if (a_X <= -3.0f || a_X >= 3.0f) { return 0.0f; }
+		return Sinc(a_X) * Sinc(a_X / 3.0f);
+	}
+
+	struct Filter
+	{
+		float (*func)(float);
+		float support;
+	};
+
+	static const Filter g_Filters[] = 
+	{
+		{ FilterBox,       0.5f },
+		{ FilterBilinear,  1.0f },
+		{ FilterMitchell,  2.0f },
+		{ FilterLanczos,   3.0f },
+	};
+
+#endif
+
+	ImageResized::ImageResized() : Image()
+	{
+		m_Levels = NULL;
+		m_LevelTotal = 0;
+	}
+
+	ImageResized::~ImageResized()
+	{
+		if (m_Levels)
+		{
+			for (uint32 i = 0; i < m_LevelTotal; i++)
+			{
+				if (m_Levels[i].pixels) { delete [] m_Levels[i].pixels; }
+			}
+			delete [] m_Levels;
+		}
+	}
+
+	bool ImageResized::Parse(uint32 /*a_Options*/)
+	{
+		return true;
+	}
+
+	bool ImageResized::Resize(Image* a_Image, uint32 a_Frame, uint32 a_Width, uint32 a_Height, uint32 a_Filter)
+	{
+		if (!SetDepth(a_Image)) { return false; }
+
+		byte* src = a_Image->GetPixels(a_Frame);
+		if (!src)
+		{
+			TIL_ERROR_EXPLAIN("Frame %i has no pixels.", a_Frame);
+			return false;
+		}
+
+		m_LevelTotal = 1;
+		m_Levels = new Level[m_LevelTotal];
+		m_Levels[0].pixels = NULL;
+
+		if (!CreateLevel(0, a_Width, a_Height)) { return false; }
+
+		Level* dst = &m_Levels[0];
+		return Resample(
+			dst->pixels, dst->width, dst->height, dst->pitchx * m_BPP, 
+			src, a_Image->GetWidth(a_Frame), a_Image->GetHeight(a_Frame), a_Image->GetPitchX(a_Frame) * m_BPP, 
+			m_BPPIdent << 16, a_Filter
+		);
+	}
+
+	bool ImageResized::CreateMipMaps(Image* a_Image, uint32 a_Frame, uint32 a_Filter)
+	{
+		if (!SetDepth(a_Image)) { return false; }
+
+		byte* src = a_Image->GetPixels(a_Frame);
+		if (!src)
+		{
+			TIL_ERROR_EXPLAIN("Frame %i has no pixels.", a_Frame);
+			return false;
+		}
+
+		uint32 width = a_Image->GetWidth(a_Frame);
+		uint32 height = a_Image->GetHeight(a_Frame);
+
+		// a level for every time the longest side can be halved
+		m_LevelTotal = 1;
+		for (uint32 longest = (width > height) ? width : height; longest > 1; longest >>= 1) { m_LevelTotal++; }
+
+		m_Levels = new Level[m_LevelTotal];
+		for (uint32 i = 0; i < m_LevelTotal; i++) { m_Levels[i].pixels = NULL; }
+
+		if (!CreateLevel(0, width, height)) { return false; }
+
+		uint32 pitch = a_Image->GetPitchX(a_Frame) * m_BPP;
+		for (uint32 y = 0; y < height; y++)
+		{
+			memcpy(m_Levels[0].pixels + (y * m_Levels[0].pitchx * m_BPP), src + (y * pitch), width * m_BPP);
+		}
+
+		for (uint32 i = 1; i < m_LevelTotal; i++)
+		{
+			Level* prev = &m_Levels[i - 1];
+
+			uint32 w = (prev->width > 1) ? (prev->width >> 1) : 1;
+			uint32 h = (prev->height > 1) ? (prev->height >> 1) : 1;
+			if (!CreateLevel(i, w, h)) { return false; }
+
+			Level* curr = &m_Levels[i];
+			if (!Resample(
+				curr->pixels, curr->width, curr->height, curr->pitchx * m_BPP, 
+				prev->pixels, prev->width, prev->height, prev->pitchx * m_BPP, 
+				m_BPPIdent << 16, a_Filter
+			))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ImageResized::Resample(
+		byte* a_Dst, uint32 a_DstWidth, uint32 a_DstHeight, uint32 a_DstPitch, 
+		byte* a_Src, uint32 a_SrcWidth, uint32 a_SrcHeight, uint32 a_SrcPitch, 
+		uint32 a_Depth, uint32 a_Filter
+	)
+	{
+		if (a_Filter < TIL_FILTER_BOX || a_Filter > TIL_FILTER_LANCZOS)
+		{
+			TIL_ERROR_EXPLAIN("Unknown filter: %i.", a_Filter);
+			return false;
+		}
+
+		uint32 bpp = 0;
+		switch (a_Depth)
+		{
+
+		case TIL_DEPTH_A8R8G8B8:
+		case TIL_DEPTH_A8B8G8R8:
+		case TIL_DEPTH_R8G8B8A8:
+		case TIL_DEPTH_B8G8R8A8:
+		case TIL_DEPTH_R8G8B8:
+		case TIL_DEPTH_B8G8R8:
+			{
+				bpp = 4;
+				break;
+			}
+
+		case TIL_DEPTH_R5G6B5:
+		case TIL_DEPTH_B5G6R5:
+			{
+				bpp = 2;
+				break;
+			}
+
+		default:
+			{
+				TIL_ERROR_EXPLAIN("Pixels can't be resized with this bit-depth: %i.", a_Depth);
+				return false;
+			}
+
+		}
+
+		if (!a_Dst || !a_Src || a_DstWidth == 0 || a_DstHeight == 0 || a_SrcWidth == 0 || a_SrcHeight == 0)
+		{
+			TIL_ERROR_EXPLAIN("Can't resize (%i, %i) to (%i, %i).", a_SrcWidth, a_SrcHeight, a_DstWidth, a_DstHeight);
+			return false;
+		}
+
+		TIL_PRINT_DEBUG("Resizing (%i, %i) to (%i, %i)", a_SrcWidth, a_SrcHeight, a_DstWidth, a_DstHeight);
+
+		Axis horizontal, vertical;
+		CreateAxis(&horizontal, a_SrcWidth, a_DstWidth, a_Filter);
+		CreateAxis(&vertical, a_SrcHeight, a_DstHeight, a_Filter);
+
+		ResampleJob job;
+		job.dst = a_Dst;
+		job.dst_width = a_DstWidth;
+		job.dst_height = a_DstHeight;
+		job.dst_pitch = a_DstPitch;
+		job.src = a_Src;
+		job.src_width = a_SrcWidth;
+		job.src_height = a_SrcHeight;
+		job.src_pitch = a_SrcPitch;
+		job.bpp = bpp;
+		job.horizontal = &horizontal;
+		job.vertical = &vertical;
+
+		Internal::ParallelFor(&ImageResized::ResampleBand, &job, (a_DstHeight + RESIZE_BAND_HEIGHT - 1) / RESIZE_BAND_HEIGHT);
+
+		DeleteAxis(&horizontal);
+		DeleteAxis(&vertical);
+
+		return true;
+	}
+
+	bool ImageResized::SetDepth(Image* a_Image)
+	{
+		if (!a_Image || !SetBPP(a_Image->GetBitDepth() << 16) || m_BPP == 0)
+		{
+			TIL_ERROR_EXPLAIN("Images can't be resized with this bit-depth.");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ImageResized::CreateLevel(uint32 a_Index, uint32 a_Width, uint32 a_Height)
+	{
+		Level* level = &m_Levels[a_Index];
+		level->width = a_Width;
+		level->height = a_Height;
+		level->pixels = Internal::CreatePixels(a_Width, a_Height, m_BPP, level->pitchx, level->pitchy);
+
+		return (level->pixels != NULL);
+	}
+
+	void ImageResized::CreateAxis(Axis* a_Axis, uint32 a_Source, uint32 a_Target, uint32 a_Filter)
+	{
+		const Filter* filter = &g_Filters[a_Filter - TIL_FILTER_BOX];
+
+		// when making the image smaller, the filter 
+		// is stretched to cover every source pixel
+
+		float scale = (float)a_Source / (float)a_Target;
+		float stretch = (scale > 1.0f) ? scale : 1.0f;
+		float radius = filter->support * stretch;
+
+		uint32 window = (uint32)ceil(radius * 2.0f) + 1;
+		float* values = new float[window];
+
+		a_Axis->window = (window < a_Source) ? window : a_Source;
+		a_Axis->first = new uint32[a_Target];
+		a_Axis->count = new uint32[a_Target];
+		a_Axis->weights = new int32[a_Target * a_Axis->window];
+
+		const int32 one = 1 << RESIZE_WEIGHT_BITS;
+
+		for (uint32 i = 0; i < a_Target; i++)
+		{
+			float center = ((float)i + 0.5f) * scale;
+			int32 left = (int32)floor(center - radius);
+
+			// pixels outside of the image take the value of the nearest edge
+
+			int32 first = (left > 0) ? left : 0;
+			int32 last = left + (int32)window - 1;
+			if (last > (int32)a_Source - 1) { last = (int32)a_Source - 1; }
+			if (last < first) { last = first; }
+
+			uint32 count = (uint32)(last - first + 1);
+			for (uint32 k = 0; k < count; k++) { values[k] = 0.0f; }
+
+			float total = 0.0f;
+			for (uint32 k = 0; k < window; k++)
+			{
+				int32 x = left + (int32)k;
+				float value = filter->func(((float)x + 0.5f - center) / stretch);
+
+				int32 index = (x < first) ? first : ((x > last) ? last : x);
+				values[index - first] += value;
+				total += value;
+			}
+
+			// zeroes at the end don't have to be added up
+			while (count > 1 && values[count - 1] == 0.0f) { count--; }
+
+			int32* weights = &a_Axis->weights[i * a_Axis->window];
+			for (uint32 k = 0; k < a_Axis->window; k++) { weights[k] = 0; }
+
+			if (total == 0.0f)
+			{
+				weights[0] = one;
+				count = 1;
+			}
+			else
+			{
+				// the rounding error goes to the largest weight,
+				// so the weights always add up to one
+
+				int32 sum = 0;
+				uint32 largest = 0;
+				float magnitude = 0.0f;
+				for (uint32 k = 0; k < count; k++)
+				{
+					weights[k] = (int32)floor((values[k] / total * (float)one) + 0.5f);
+					sum += weights[k];
+
+					float current = (values[k] < 0.0f) ? -values[k] : values[k];
+					if (current > magnitude) 
+					{ 
+						largest = k; 
+						magnitude = current;
+					}
+				}
+				weights[largest] += one - sum;
+			}
+
+			a_Axis->first[i] = (uint32)first;
+			a_Axis->count[i] = count;
+		}
+
+		delete [] values;
+	}
+
+	void ImageResized::DeleteAxis(Axis* a_Axis)
+	{
+		delete [] a_Axis->first;
+		delete [] a_Axis->count;
+		delete [] a_Axis->weights;
+	}
+
+	void ImageResized::FilterRow(int32* a_Dst, byte* a_Src, Axis* a_Axis, uint32 a_Width)
+	{
+		const int32 shift = RESIZE_WEIGHT_BITS - RESIZE_ROW_BITS;
+		const int32 half = 1 << (shift - 1);
+
+		for (uint32 x = 0; x < a_Width; x++)
+		{
+			byte* src = a_Src + (a_Axis->first[x] * 4);
+			int32* weights = &a_Axis->weights[x * a_Axis->window];
+
+			int32 c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+			for (uint32 k = 0; k < a_Axis->count[x]; k++)
+			{
+				c0 += weights[k] * src[0];
+				c1 += weights[k] * src[1];
+				c2 += weights[k] * src[2];
+				c3 += weights[k] * src[3];
+				src += 4;
+			}
+
+			a_Dst[0] = (c0 + half) >> shift;
+			a_Dst[1] = (c1 + half) >> shift;
+			a_Dst[2] = (c2 + half) >> shift;
+			a_Dst[3] = (c3 + half) >> shift;
+			a_Dst += 4;
+		}
+	}
+
+	void ImageResized::ResampleBand(void* a_Data, uint32 a_Index)
+	{
+		ResampleJob* job = (ResampleJob*)a_Data;
+		Axis* vertical = job->vertical;
+
+		uint32 top = a_Index * RESIZE_BAND_HEIGHT;
+		uint32 bottom = (job->dst_height - top > RESIZE_BAND_HEIGHT) ? (top + RESIZE_BAND_HEIGHT) : job->dst_height;
+
+		// the rows that were filtered horizontally are kept 
+		// until the vertical filter has moved past them
+
+		uint32 size = job->dst_width * 4;
+		uint32 window = vertical->window;
+
+		int32* rows = new int32[window * size];
+		int32* sums = new int32[size];
+		byte* unpacked = (job->bpp == 2) ? new byte[job->src_width * 4] : NULL;
+
+		const int32 shift = RESIZE_WEIGHT_BITS + RESIZE_ROW_BITS;
+		const int32 half = 1 << (shift - 1);
+
+		uint32 next = vertical->first[top];
+		for (uint32 y = top; y < bottom; y++)
+		{
+			uint32 first = vertical->first[y];
+			uint32 count = vertical->count[y];
+			if (next < first) { next = first; }
+
+			for (; next < first + count; next++)
+			{
+				byte* src = job->src + (next * job->src_pitch);
+
+				if (unpacked)
+				{
+					// both 16-bit depths store their channels as 5, 6 and 5 bits
+					color_16b* pixel = (color_16b*)src;
+					for (uint32 x = 0; x < job->src_width; x++)
+					{
+						unpacked[(x * 4) + 0] = (pixel[x] >> 11) & 0x1F;
+						unpacked[(x * 4) + 1] = (pixel[x] >> 5) & 0x3F;
+						unpacked[(x * 4) + 2] = pixel[x] & 0x1F;
+						unpacked[(x * 4) + 3] = 0;
+					}
+					src = unpacked;
+				}
+
+				FilterRow(rows + ((next % window) * size), src, job->horizontal, job->dst_width);
+			}
+
+			memset(sums, 0, size * sizeof(int32));
+
+			int32* weights = &vertical->weights[y * window];
+			for (uint32 k = 0; k < count; k++)
+			{
+				int32* row = rows + (((first + k) % window) * size);
+				int32 weight = weights[k];
+				for (uint32 i = 0; i < size; i++) { sums[i] += weight * row[i]; }
+			}
+
+			byte* dst = job->dst + (y * job->dst_pitch);
+
+			if (job->bpp == 4)
+			{
+				for (uint32 i = 0; i < size; i++)
+				{
+					int32 value = (sums[i] + half) >> shift;
+					dst[i] = (byte)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+				}
+			}
+			else
+			{
+				color_16b* pixel = (color_16b*)dst;
+				for (uint32 x = 0; x < job->dst_width; x++)
+				{
+					int32 r = (sums[(x * 4) + 0] + half) >> shift;
+					int32 g = (sums[(x * 4) + 1] + half) >> shift;
+					int32 b = (sums[(x * 4) + 2] + half) >> shift;
+
+					r = (r < 0) ? 0 : ((r > 0x1F) ? 0x1F : r);
+					g = (g < 0) ? 0 : ((g > 0x3F) ? 0x3F : g);
+					b = (b < 0) ? 0 : ((b > 0x1F) ? 0x1F : b);
+
+					pixel[x] = (color_16b)((r << 11) | (g << 5) | b);
+				}
+			}
+		}
+
+		delete [] rows;
+		delete [] sums;
+		if (unpacked) { delete [] unpacked; }
+	}
+
+	uint32 ImageResized::GetFrameCount()
+	{
+		return m_LevelTotal;
+	}
+
+	byte* ImageResized::GetPixels(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].pixels : NULL;
+	}
+
+	uint32 ImageResized::GetWidth(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].width : 0;
+	}
+
+	uint32 ImageResized::GetHeight(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].height : 0;
+	}
+
+	uint32 ImageResized::GetPitchX(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].pitchx : 0;
+	}
+
+	uint32 ImageResized::GetPitchY(uint32 a_Frame /*= 0*/)
+	{
+		return (a_Frame < m_LevelTotal) ? m_Levels[a_Frame].pitchy : 0;
+	}
+
+}; // namespace til
\ No newline at end of file
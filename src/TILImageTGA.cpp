@@ -38,7 +38,10 @@ namespace til
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
-	static int g_Depth;
+	// bytes read from the stream at a time
+	#define TGA_READ_SIZE              (32 * 1024)
+	// a packet header followed by 128 pixels of 4 bytes
+	#define TGA_PACKET_MAX             (1 + 128 * 4)
 
 #endif
 
@@ -52,20 +55,18 @@ namespace til
 		{
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = AlphaBlend_32b_A8R8G8B8(a_Src[2], a_Src[1], a_Src[0], (g_Depth > 3) ? a_Src[3] : 255);
+				color_32b comp = AlphaBlend_32b_A8R8G8B8(a_Src[2], a_Src[1], a_Src[0], (a_BPP > 3) ? a_Src[3] : 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_A8R8G8B8(*src);
+				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_A8R8G8B8(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		return (uint8*)dst;
@@ -79,20 +80,18 @@ namespace til
 		{
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = AlphaBlend_32b_A8B8G8R8(a_Src[2], a_Src[1], a_Src[0], (g_Depth > 3) ? a_Src[3] : 255);
+				color_32b comp = AlphaBlend_32b_A8B8G8R8(a_Src[2], a_Src[1], a_Src[0], (a_BPP > 3) ? a_Src[3] : 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_A8B8G8R8(*src);
+				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_A8B8G8R8(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
@@ -107,20 +106,18 @@ namespace til
 		{
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = AlphaBlend_32b_R8G8B8A8(a_Src[2], a_Src[1], a_Src[0], (g_Depth > 3) ? a_Src[3] : 255);
+				color_32b comp = AlphaBlend_32b_R8G8B8A8(a_Src[2], a_Src[1], a_Src[0], (a_BPP > 3) ? a_Src[3] : 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_R8G8B8A8(*src);
+				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_R8G8B8A8(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
@@ -135,20 +132,18 @@ namespace til
 		{
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = AlphaBlend_32b_B8G8R8A8(a_Src[2], a_Src[1], a_Src[0], (g_Depth > 3) ? a_Src[3] : 255);
+				color_32b comp = AlphaBlend_32b_B8G8R8A8(a_Src[2], a_Src[1], a_Src[0], (a_BPP > 3) ? a_Src[3] : 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_B8G8R8A8(*src);
+				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_B8G8R8A8(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
@@ -165,18 +160,16 @@ namespace til
 			{
 				color_32b comp = AlphaBlend_32b_R8G8B8(a_Src[2], a_Src[1], a_Src[0], 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_R8G8B8(*src);
+				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_R8G8B8(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
@@ -193,18 +186,16 @@ namespace til
 			{
 				color_32b comp = AlphaBlend_32b_B8G8R8(a_Src[2], a_Src[1], a_Src[0], 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_B8G8R8(*src);
+				color_32b comp = Convert_From_16b_B5G5R5A1_To_32b_B8G8R8(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
@@ -219,20 +210,18 @@ namespace til
 		{
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_16b comp = AlphaBlend_16b_R5G6B5(a_Src[2], a_Src[1], a_Src[0], (g_Depth > 3) ? a_Src[3] : 255);
+				color_16b comp = AlphaBlend_16b_R5G6B5(a_Src[2], a_Src[1], a_Src[0], (a_BPP > 3) ? a_Src[3] : 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_16b comp = Convert_From_16b_B5G5R5A1_To_16b_R5G6B5(*src);
+				color_16b comp = Convert_From_16b_B5G5R5A1_To_16b_R5G6B5(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
@@ -247,111 +236,306 @@ namespace til
 		{
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_16b comp = AlphaBlend_16b_B5G6R5(a_Src[2], a_Src[1], a_Src[0], (g_Depth > 3) ? a_Src[3] : 255);
+				color_16b comp = AlphaBlend_16b_B5G6R5(a_Src[2], a_Src[1], a_Src[0], (a_BPP > 3) ? a_Src[3] : 255);
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				a_Src += g_Depth;
+				a_Src += a_BPP;
 			}
 		}
 		else
 		{
-			color_16b* src = (color_16b*)a_Src;
-
 			for (int j = 0; j < a_Unique; j++)
 			{
-				color_16b comp = Convert_From_16b_B5G5R5A1_To_16b_B5G6R5(*src);
+				color_16b comp = Convert_From_16b_B5G5R5A1_To_16b_B5G6R5(a_Src[0] | (a_Src[1] << 8));
 				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
-				src++;
+				a_Src += 2;
 			}
 		}
 		
 		return (uint8*)dst;
 	}
 
+	uint8* ImageTGA::ColorFunc_Palette(uint8* a_Dst, uint8* a_Src, uint32 a_BPP, int a_Repeat, int a_Unique)
+	{
+		// the palette was converted when parsing, so only the index needs to be looked up
+
+		if (m_BPP == 4)
+		{
+			color_32b* dst = (color_32b*)a_Dst;
+			color_32b* palette = (color_32b*)m_Palette;
+
+			for (int j = 0; j < a_Unique; j++)
+			{
+				color_32b comp = palette[(a_BPP > 1) ? (a_Src[0] | (a_Src[1] << 8)) : a_Src[0]];
+				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
+				a_Src += a_BPP;
+			}
+
+			return (uint8*)dst;
+		}
+		else
+		{
+			color_16b* dst = (color_16b*)a_Dst;
+			color_16b* palette = (color_16b*)m_Palette;
+
+			for (int j = 0; j < a_Unique; j++)
+			{
+				color_16b comp = palette[(a_BPP > 1) ? (a_Src[0] | (a_Src[1] << 8)) : a_Src[0]];
+				for (int i = 0; i < a_Repeat; i++) { *dst++ = comp; }
+				a_Src += a_BPP;
+			}
+
+			return (uint8*)dst;
+		}
+	}
+
+	uint8* ImageTGA::ColorFunc_GrayAlpha(uint8* a_Dst, uint8* a_Src, uint32 /*a_BPP*/, int a_Repeat, int a_Unique)
+	{
+		byte color[4];
+
+		for (int j = 0; j < a_Unique; j++)
+		{
+			color[0] = color[1] = color[2] = a_Src[0];
+			color[3] = a_Src[1];
+
+			a_Dst = (this->*m_ConvertFunc)(a_Dst, color, 4, a_Repeat, 1);
+			a_Src += 2;
+		}
+
+		return a_Dst;
+	}
+
 #endif
 
 	ImageTGA::ImageTGA()
 	{
-
+		m_Data = NULL;
+		m_Palette = NULL;
+		m_Rows = false;
+		m_Row = 0;
+		m_Offset = 0;
 	}
 
 	ImageTGA::~ImageTGA()
 	{
 		if (m_Data) { delete m_Data; }
+		if (m_Palette) { delete [] m_Palette; }
+	}
+
+	bool ImageTGA::NextRow()
+	{
+		if (!m_Rows)
+		{
+			m_Target += m_Step;
+			return true;
+		}
+
+		return PushRows(m_Target, m_Row++, 1, m_Width, m_Height, m_Pitch);
 	}
 
 	bool ImageTGA::CompileUncompressed()
 	{
-		// silly TGA, why do you store your pixels in reverse y?
-		// now i can't just memcpy it :(
 
 		uint8* src = new uint8[m_Width * m_Depth];
 
-		for (uint32 y = 0; y < m_Height; y++)
+		// when decoding row by row, only the region is read
+
+		uint32 top = 0;
+		uint32 bottom = m_Height;
+		uint32 left = 0;
+		uint32 count = m_Width;
+		bool seek = false;
+
+		if (m_Rows)
 		{
-			byte* dst = m_Target;
+			if (!CheckRegion(m_Width, m_Height))
+			{
+				delete [] src;
+				return false;
+			}
+
+			top = m_RegionY;
+			bottom = m_RegionY + m_RegionHeight;
+			left = m_RegionX;
+			count = m_RegionWidth;
+			seek = (m_Step < 0 || count < m_Width);
+			m_Row = top;
+		}
+
+		for (uint32 y = top; y < bottom; y++)
+		{
+			byte* dst = m_Target + (left * m_BPP);
+
+			// rows stored from the bottom up are read from the end
+			if (seek || (m_Rows && y == top))
+			{
+				uint32 stored = (m_Step < 0) ? (m_Height - 1 - y) : y;
+				m_Stream->Seek(m_Offset + (((stored * m_Width) + left) * m_Depth), TIL_FILE_SEEK_START);
+			}
 			
-			m_Stream->Read(src, m_Width, m_Depth);
+			m_Stream->Read(src, count, m_Depth);
 
 			uint8* src_copy = src;
-			dst = (this->*m_ColorFunc)(dst, src_copy, m_Depth, 1, m_Width);
+			dst = (this->*m_ColorFunc)(dst, src_copy, m_Depth, 1, count);
 
-			m_Target -= m_Pitch;
+			if (!NextRow())
+			{
+				delete [] src;
+				return false;
+			}
 		}
 
-		delete src;
+		delete [] src;
 
-		return false;
+		return true;
 	}
 
 	bool ImageTGA::CompileRunLengthEncoded()
 	{
-		byte buffer[128 * 4];
-		byte src_buffer[4];
-		byte* src_color;
+		// the packets are read in bulk, with room after the buffer
+		// so a packet never has to be split over two reads
+
+		byte* buffer = new byte[TGA_READ_SIZE + TGA_PACKET_MAX];
+		memset(buffer + TGA_READ_SIZE, 0, TGA_PACKET_MAX);
+
+		byte* read = buffer;
+		byte* end = buffer;
+		bool eof = false;
 
-		uint32 total = m_Width * m_Height;
+		uint8* dst = m_Target;
+		uint32 x = 0;
+		uint32 y = 0;
 
-		for (uint32 y = 0; y < m_Height; y++)
+		while (y < m_Height)
 		{
-			uint8* dst = m_Target;
+			if (end - read < TGA_PACKET_MAX && !eof)
+			{
+				uint32 left = (uint32)(end - read);
+				memmove(buffer, read, left);
+
+				// the file can end before the buffer is full
+				memset(buffer + left, 0, TGA_READ_SIZE - left);
+				eof = !m_Stream->ReadByte(buffer + left, TGA_READ_SIZE - left);
 
-			for (uint32 x = 0; x < m_Width;)
+				read = buffer;
+				end = buffer + TGA_READ_SIZE;
+			}
+
+			if (read >= end)
 			{
-				byte packet;
-				m_Stream->ReadByte(&packet);
+				TIL_ERROR_EXPLAIN("Unexpected end of run-length encoded data.");
+				break;
+			}
 
-				uint8 count = (packet & 0x7F) + 1;
-				int repeat = 1;
-				int unique = 1;
+			byte packet = *read++;
+			uint32 count = (packet & 0x7F) + 1;
 
-				// run length packet
-				if (packet & 0x80)
-				{
-					m_Stream->ReadByte(src_buffer, m_Depth);
-					src_color = src_buffer;
+			// packets can continue on the next scanline
 
-					repeat = count;
-				}
-				// raw packet
-				else
+			// run length packet
+			if (packet & 0x80)
+			{
+				while (count > 0 && y < m_Height)
 				{
-					m_Stream->ReadByte(buffer, count * m_Depth);
-					src_color = buffer;
-
-					unique = count;
+					uint32 span = (m_Width - x < count) ? m_Width - x : count;
+					dst = (this->*m_ColorFunc)(dst, read, m_Depth, span, 1);
+
+					x += span;
+					count -= span;
+
+					if (x == m_Width)
+					{
+						x = 0;
+						y++;
+						if (!NextRow())
+						{
+							delete [] buffer;
+							return false;
+						}
+						dst = m_Target;
+					}
 				}
 
-				dst = (this->*m_ColorFunc)(dst, src_color, m_BPP, repeat, unique);
+				read += m_Depth;
+			}
+			// raw packet
+			else
+			{
+				while (count > 0 && y < m_Height)
+				{
+					uint32 span = (m_Width - x < count) ? m_Width - x : count;
+					dst = (this->*m_ColorFunc)(dst, read, m_Depth, 1, span);
+
+					read += span * m_Depth;
+					x += span;
+					count -= span;
+
+					if (x == m_Width)
+					{
+						x = 0;
+						y++;
+						if (!NextRow())
+						{
+							delete [] buffer;
+							return false;
+						}
+						dst = m_Target;
+					}
+				}
 
-				x += count;
+				read += count * m_Depth;
 			}
+		}
 
-			m_Target -= m_Pitch;
+		delete [] buffer;
+
+		return true;
+	}
+
+	bool ImageTGA::CompileColorMap(uint32 a_Offset, uint32 a_Length, uint32 a_Bits)
+	{
+		uint32 depth = (a_Bits + 7) >> 3;
+		if (depth < 2 || depth > 4)
+		{
+			TIL_ERROR_EXPLAIN("Unsupported color map depth: %i", a_Bits);
+			return false;
 		}
 
+		// every possible index gets an entry, so indices outside 
+		// of the color map can't read past the palette
+
+		uint32 entries = (m_Depth == 1) ? 256 : 65536;
+		m_Palette = new byte[entries * m_BPP];
+		memset(m_Palette, 0, entries * m_BPP);
+
+		byte* colors = new byte[a_Length * depth];
+		m_Stream->ReadByte(colors, a_Length * depth);
+
+		// convert the colors to the target depth once, instead of for every pixel
+
+		byte* src = colors;
+		for (uint32 i = a_Offset; i < a_Offset + a_Length; i++)
+		{
+			if (i < entries) { (this->*m_ConvertFunc)(m_Palette + (i * m_BPP), src, depth, 1, 1); }
+			src += depth;
+		}
+
+		delete [] colors;
+
 		return true;
 	}
 
+	void ImageTGA::CompileGrayscale()
+	{
+		m_Palette = new byte[256 * m_BPP];
+
+		byte color[3];
+		for (uint32 i = 0; i < 256; i++)
+		{
+			color[0] = color[1] = color[2] = (byte)i;
+			(this->*m_ConvertFunc)(m_Palette + (i * m_BPP), color, 3, 1, 1);
+		}
+	}
+
 	bool ImageTGA::Parse(uint32 a_Options)
 	{
 		byte id;              m_Stream->ReadByte(&id);
@@ -416,10 +600,9 @@ namespace til
 		word width;           m_Stream->ReadWord(&width);
 		word height;          m_Stream->ReadWord(&height);
 
-		m_Stream->ReadByte(&m_Depth);
-		m_Depth >>= 3;
-
-		g_Depth = m_Depth;
+		// 15-bit images are stored in two bytes
+		byte bits;            m_Stream->ReadByte(&bits);
+		m_Depth = (bits + 7) >> 3;
 
 		TGA_DEBUG("Depth: %i", m_Depth);
 
@@ -427,77 +610,168 @@ namespace til
 
 		if (id > 0)
 		{
-			TGA_DEBUG("Hey maybe I should do something with the id field.");
-			return false;
+			TGA_DEBUG("Skipping %i bytes of image id.", id);
+			m_Stream->Seek(id, TIL_FILE_SEEK_CURR);
 		}
 
-		if (colormap > 0)
+		if (m_Type == COLOR_MAPPED)
+		{
+			if (m_Depth != 1 && m_Depth != 2)
+			{
+				TIL_ERROR_EXPLAIN("Unsupported color map index depth: %i", bits);
+				return false;
+			}
+			if (colormap == 0)
+			{
+				TIL_ERROR_EXPLAIN("Color mapped image doesn't have a color map.");
+				return false;
+			}
+		}
+		else if (m_Type == COLOR_BLACKANDWHITE)
+		{
+			if (m_Depth != 1 && m_Depth != 2)
+			{
+				TIL_ERROR_EXPLAIN("Unsupported grayscale depth: %i", bits);
+				return false;
+			}
+		}
+		else if (m_Depth < 2 || m_Depth > 4)
 		{
-			TGA_DEBUG("Hey maybe I should do something with the colormap field.");
+			TIL_ERROR_EXPLAIN("Unsupported true color depth: %i", bits);
 			return false;
 		}
 
 		m_Width = (uint32)width;
 		m_Height = (uint32)height;
 
-		m_Data = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+		if (m_RowFunc && !CheckRegion(m_Width, m_Height)) { return false; }
+
+		bool top = ((img_descriptor & 0x20) != 0);
+		bool bottomup = ((a_Options & TIL_LOAD_BOTTOMUP) != 0);
+
+		TGA_DEBUG("Origin: %s", top ? "top" : "bottom");
+
+		if (img_descriptor & 0x10)
+		{
+			TGA_DEBUG("Right-to-left images are loaded mirrored.");
+		}
+
+		// rows can be passed on one at a time, unless they are 
+		// run-length encoded from the bottom up
+
+		m_Rows = (m_RowFunc && (top || m_Comp == COMP_NONE));
+		m_Row = 0;
+
+		if (m_Rows)
+		{
+			m_PitchX = m_Width;
+			m_PitchY = 1;
+			m_Data = new byte[m_Width * m_BPP];
+		}
+		else
+		{
+			m_Data = Internal::CreatePixels(m_Width, m_Height, m_BPP, m_PitchX, m_PitchY);
+			if (!m_Data) { return false; }
+		}
 		m_Pitch = m_PitchX * m_BPP;
 
-		//m_Pixels = new byte[m_PitchX * m_PitchY * m_BPP];
-		//m_Pitch = m_PitchX * m_BPP;
-		m_Target = m_Data + ((m_Height - 1) * m_Pitch);
-		//m_Target = m_Data->GetData() + ((m_Height - 1) * m_Data->GetSizeHor());
+		// rows are written in the order they are stored, 
+		// from the top or the bottom of the buffer
+
+		if (top != bottomup)
+		{
+			m_Target = m_Data;
+			m_Step = (int32)m_Pitch;
+		}
+		else
+		{
+			m_Target = m_Data + ((m_Height - 1) * m_Pitch);
+			m_Step = -(int32)m_Pitch;
+		}
+
+		// every row is written to the same buffer
+		if (m_Rows) { m_Target = m_Data; }
 
 		switch (m_BPPIdent)
 		{
 		
 		case BPP_32B_A8R8G8B8: 
-			m_ColorFunc = &ImageTGA::ColorFunc_A8R8G8B8; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_A8R8G8B8; 
 			break;
 
 		case BPP_32B_A8B8G8R8:
-			m_ColorFunc = &ImageTGA::ColorFunc_A8B8G8R8;
+			m_ConvertFunc = &ImageTGA::ColorFunc_A8B8G8R8;
 			break;
 
 		case BPP_32B_R8G8B8A8: 
-			m_ColorFunc = &ImageTGA::ColorFunc_R8G8B8A8; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_R8G8B8A8; 
 			break;
 
 		case BPP_32B_B8G8R8A8: 
-			m_ColorFunc = &ImageTGA::ColorFunc_B8G8R8A8; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_B8G8R8A8; 
 			break;
 
 		case BPP_32B_R8G8B8: 
-			m_ColorFunc = &ImageTGA::ColorFunc_R8G8B8; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_R8G8B8; 
 			break;
 
 		case BPP_32B_B8G8R8: 
-			m_ColorFunc = &ImageTGA::ColorFunc_B8G8R8; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_B8G8R8; 
 			break;
 
 		case BPP_16B_R5G6B5: 
-			m_ColorFunc = &ImageTGA::ColorFunc_R5G6B5; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_R5G6B5; 
 			break;
 
 		case BPP_16B_B5G6R5: 
-			m_ColorFunc = &ImageTGA::ColorFunc_B5G6R5; 
+			m_ConvertFunc = &ImageTGA::ColorFunc_B5G6R5; 
 			break;
 
 		default:
 			TIL_ERROR_EXPLAIN("Unhandled color format: %i", m_BPPIdent);
-			break;
+			return false;
+		}
+
+		m_ColorFunc = m_ConvertFunc;
+
+		m_Offset = 18 + id;
+		if (colormap > 0) { m_Offset += colormap_length * ((colormap_bpp + 7) >> 3); }
+
+		if (m_Type == COLOR_MAPPED)
+		{
+			if (!CompileColorMap(colormap_offset, colormap_length, colormap_bpp)) { return false; }
+			m_ColorFunc = &ImageTGA::ColorFunc_Palette;
+		}
+		else 
+		{
+			if (colormap > 0)
+			{
+				// true color images are allowed to have a color map, but don't use it
+				m_Stream->Seek(colormap_length * ((colormap_bpp + 7) >> 3), TIL_FILE_SEEK_CURR);
+			}
+
+			if (m_Type == COLOR_BLACKANDWHITE)
+			{
+				if (m_Depth == 1)
+				{
+					CompileGrayscale();
+					m_ColorFunc = &ImageTGA::ColorFunc_Palette;
+				}
+				else
+				{
+					m_ColorFunc = &ImageTGA::ColorFunc_GrayAlpha;
+				}
+			}
 		}
 
 		if (m_Comp == COMP_RLE)
 		{
-			CompileRunLengthEncoded();	
+			return CompileRunLengthEncoded();	
 		}
 		else
 		{
-			CompileUncompressed();
+			return CompileUncompressed();
 		}
-	
-		return true;
 	}
 
 	uint32 ImageTGA::GetFrameCount()
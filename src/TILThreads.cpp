@@ -0,0 +1,444 @@
+/*
+	TinyImageLoader - load images, just like that
+
+	Copyright (C) 2010 - 2011 by Quinten Lansu
+	
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+	
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+	
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+
+
+/*!
+	\file TILThreads.h
+*/
+
+#include "TILThreads.h"
+#include "TILInternal.h"
+
+#if (TIL_THREADS)
+	#if (TIL_PLATFORM == TIL_PLATFORM_WINDOWS || TIL_PLATFORM == TIL_PLATFORM_WINMO)
+		#define TIL_THREADS_WINDOWS
+	#else
+		#define TIL_THREADS_POSIX
+		#include <pthread.h>
+		#include <unistd.h>
+	#endif
+#endif
+
+namespace til
+{
+
+	namespace Internal
+	{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+		// =========================================
+		// Primitives
+		// =========================================
+
+#if defined(TIL_THREADS_WINDOWS)
+
+		class MutexData
+		{
+
+		public:
+
+			CRITICAL_SECTION section;
+
+		};
+
+		class SemaphoreData
+		{
+
+		public:
+
+			HANDLE handle;
+
+		};
+
+		typedef HANDLE ThreadHandle;
+
+#elif defined(TIL_THREADS_POSIX)
+
+		class MutexData
+		{
+
+		public:
+
+			pthread_mutex_t mutex;
+
+		};
+
+		class SemaphoreData
+		{
+
+		public:
+
+			pthread_mutex_t mutex;
+			pthread_cond_t cond;
+			uint32 count;
+
+		};
+
+		typedef pthread_t ThreadHandle;
+
+#else
+
+		class MutexData { };
+		class SemaphoreData { };
+
+		typedef int ThreadHandle;
+
+#endif
+
+		Mutex::Mutex()
+		{
+			m_Data = new MutexData;
+#if defined(TIL_THREADS_WINDOWS)
+			InitializeCriticalSection(&m_Data->section);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_init(&m_Data->mutex, NULL);
+#endif
+		}
+
+		Mutex::~Mutex()
+		{
+#if defined(TIL_THREADS_WINDOWS)
+			DeleteCriticalSection(&m_Data->section);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_destroy(&m_Data->mutex);
+#endif
+			delete m_Data;
+		}
+
+		void Mutex::Lock()
+		{
+#if defined(TIL_THREADS_WINDOWS)
+			EnterCriticalSection(&m_Data->section);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_lock(&m_Data->mutex);
+#endif
+		}
+
+		void Mutex::Unlock()
+		{
+#if defined(TIL_THREADS_WINDOWS)
+			LeaveCriticalSection(&m_Data->section);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_unlock(&m_Data->mutex);
+#endif
+		}
+
+		Semaphore::Semaphore()
+		{
+			m_Data = new SemaphoreData;
+#if defined(TIL_THREADS_WINDOWS)
+			m_Data->handle = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_init(&m_Data->mutex, NULL);
+			pthread_cond_init(&m_Data->cond, NULL);
+			m_Data->count = 0;
+#endif
+		}
+
+		Semaphore::~Semaphore()
+		{
+#if defined(TIL_THREADS_WINDOWS)
+			CloseHandle(m_Data->handle);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_cond_destroy(&m_Data->cond);
+			pthread_mutex_destroy(&m_Data->mutex);
+#endif
+			delete m_Data;
+		}
+
+		void Semaphore::Post(uint32 a_Count)
+		{
+#if defined(TIL_THREADS_WINDOWS)
+			ReleaseSemaphore(m_Data->handle, (LONG)a_Count, NULL);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_lock(&m_Data->mutex);
+			m_Data->count += a_Count;
+			pthread_cond_broadcast(&m_Data->cond);
+			pthread_mutex_unlock(&m_Data->mutex);
+#endif
+		}
+
+		void Semaphore::Wait()
+		{
+#if defined(TIL_THREADS_WINDOWS)
+			WaitForSingleObject(m_Data->handle, INFINITE);
+#elif defined(TIL_THREADS_POSIX)
+			pthread_mutex_lock(&m_Data->mutex);
+			while (m_Data->count == 0) { pthread_cond_wait(&m_Data->cond, &m_Data->mutex); }
+			m_Data->count--;
+			pthread_mutex_unlock(&m_Data->mutex);
+#endif
+		}
+
+		// =========================================
+		// Thread pool
+		// =========================================
+
+		static const uint32 g_ThreadMax = 32;
+
+		static uint32 g_ThreadCount = 0;
+
+		// the semaphores are created with the threads, so they are never destroyed
+		// while a worker is still waiting on them
+		static Mutex g_PoolLock;
+		static Semaphore* g_PoolStart = NULL;
+		static Semaphore* g_PoolDone = NULL;
+
+		static ThreadHandle g_PoolThreads[g_ThreadMax];
+		static uint32 g_PoolThreadsTotal = 0;
+		static bool g_PoolQuit = false;
+		static bool g_PoolBusy = false;
+
+		static JobFunc g_JobFunc = NULL;
+		static void* g_JobData = NULL;
+		static uint32 g_JobCount = 0;
+		static uint32 g_JobNext = 0;
+		static uint32 g_JobFinished = 0;
+
+		uint32 GetProcessorCount()
+		{
+			uint32 result = 1;
+
+#if defined(TIL_THREADS_WINDOWS)
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			result = (uint32)info.dwNumberOfProcessors;
+#elif defined(TIL_THREADS_POSIX)
+			long online = sysconf(_SC_NPROCESSORS_ONLN);
+			if (online > 0) { result = (uint32)online; }
+#endif
+
+			if (result < 1) { result = 1; }
+			if (result > g_ThreadMax) { result = g_ThreadMax; }
+
+			return result;
+		}
+
+		// takes jobs until there are none left, returns when they have all been handed out
+		void RunJobs()
+		{
+			while (1)
+			{
+				g_PoolLock.Lock();
+				if (g_JobNext >= g_JobCount)
+				{
+					g_PoolLock.Unlock();
+					break;
+				}
+				JobFunc func = g_JobFunc;
+				void* data = g_JobData;
+				uint32 index = g_JobNext++;
+				g_PoolLock.Unlock();
+
+				func(data, index);
+
+				g_PoolLock.Lock();
+				if (++g_JobFinished == g_JobCount) { g_PoolDone->Post(); }
+				g_PoolLock.Unlock();
+			}
+		}
+
+		void WorkerLoop()
+		{
+			while (1)
+			{
+				g_PoolStart->Wait();
+
+				g_PoolLock.Lock();
+				bool quit = g_PoolQuit;
+				g_PoolLock.Unlock();
+				if (quit) { break; }
+
+				RunJobs();
+			}
+		}
+
+#if defined(TIL_THREADS_WINDOWS)
+
+		DWORD WINAPI WorkerEntry(LPVOID /*a_Data*/)
+		{
+			WorkerLoop();
+			return 0;
+		}
+
+#elif defined(TIL_THREADS_POSIX)
+
+		void* WorkerEntry(void* /*a_Data*/)
+		{
+			WorkerLoop();
+			return NULL;
+		}
+
+#endif
+
+		// the calling thread is one of the threads, so one less worker is started
+		void StartThreads()
+		{
+			if (g_ThreadCount == 0) { g_ThreadCount = GetProcessorCount(); }
+
+			g_PoolQuit = false;
+			g_PoolThreadsTotal = 0;
+
+			if (g_ThreadCount < 2) { return; }
+
+			g_PoolStart = new Semaphore;
+			g_PoolDone = new Semaphore;
+
+			for (uint32 i = 1; i < g_ThreadCount; i++)
+			{
+#if defined(TIL_THREADS_WINDOWS)
+				ThreadHandle handle = CreateThread(NULL, 0, WorkerEntry, NULL, 0, NULL);
+				if (!handle) { break; }
+#elif defined(TIL_THREADS_POSIX)
+				ThreadHandle handle;
+				if (pthread_create(&handle, NULL, WorkerEntry, NULL) != 0) { break; }
+#else
+				break;
+#endif
+				g_PoolThreads[g_PoolThreadsTotal++] = handle;
+			}
+		}
+
+#endif
+
+		void ParallelFor(JobFunc a_Func, void* a_Data, uint32 a_Count)
+		{
+#if (TIL_THREADS)
+
+			if (a_Count > 1)
+			{
+				g_PoolLock.Lock();
+
+				if (!g_PoolBusy)
+				{
+					if (g_ThreadCount == 0 || (g_PoolThreadsTotal == 0 && g_ThreadCount > 1)) { StartThreads(); }
+
+					if (g_PoolThreadsTotal > 0)
+					{
+						g_PoolBusy = true;
+
+						g_JobFunc = a_Func;
+						g_JobData = a_Data;
+						g_JobCount = a_Count;
+						g_JobNext = 0;
+						g_JobFinished = 0;
+
+						g_PoolLock.Unlock();
+
+						uint32 wake = a_Count - 1;
+						if (wake > g_PoolThreadsTotal) { wake = g_PoolThreadsTotal; }
+						g_PoolStart->Post(wake);
+
+						RunJobs();
+						g_PoolDone->Wait();
+
+						g_PoolLock.Lock();
+						g_JobFunc = NULL;
+						g_JobData = NULL;
+						g_JobCount = 0;
+						g_JobNext = 0;
+						g_PoolBusy = false;
+						g_PoolLock.Unlock();
+
+						return;
+					}
+				}
+
+				g_PoolLock.Unlock();
+			}
+
+#endif
+
+			for (uint32 i = 0; i < a_Count; i++) { a_Func(a_Data, i); }
+		}
+
+		void ShutDownThreads()
+		{
+#if (TIL_THREADS)
+
+			g_PoolLock.Lock();
+			g_PoolQuit = true;
+			uint32 total = g_PoolThreadsTotal;
+			g_PoolLock.Unlock();
+
+			if (g_PoolStart) { g_PoolStart->Post(total); }
+
+			for (uint32 i = 0; i < total; i++)
+			{
+#if defined(TIL_THREADS_WINDOWS)
+				WaitForSingleObject(g_PoolThreads[i], INFINITE);
+				CloseHandle(g_PoolThreads[i]);
+#elif defined(TIL_THREADS_POSIX)
+				pthread_join(g_PoolThreads[i], NULL);
+#endif
+			}
+
+			g_PoolLock.Lock();
+			delete g_PoolStart;
+			g_PoolStart = NULL;
+			delete g_PoolDone;
+			g_PoolDone = NULL;
+			g_PoolThreadsTotal = 0;
+			g_PoolQuit = false;
+			g_PoolLock.Unlock();
+
+#endif
+		}
+
+		void SetThreadCount(uint32 a_Count)
+		{
+#if (TIL_THREADS)
+
+			ShutDownThreads();
+
+			g_PoolLock.Lock();
+			g_ThreadCount = (a_Count == 0) ? GetProcessorCount() : a_Count;
+			if (g_ThreadCount > g_ThreadMax) { g_ThreadCount = g_ThreadMax; }
+			g_PoolLock.Unlock();
+
+#endif
+		}
+
+		uint32 GetThreadCount()
+		{
+#if (TIL_THREADS)
+
+			g_PoolLock.Lock();
+			if (g_ThreadCount == 0) { g_ThreadCount = GetProcessorCount(); }
+			uint32 result = g_ThreadCount;
+			g_PoolLock.Unlock();
+
+			return result;
+
+#else
+
+			return 1;
+
+#endif
+		}
+
+	}; // namespace Internal
+
+}; // namespace til
\ No newline at end of file
@@ -49,7 +49,11 @@
 	#include "TILImageDDS.h"
 #endif
 
+#include "TILImageRegion.h"
+#include "TILImageResized.h"
+#include "TILImageCompressed.h"
 #include "TILFileStreamStd.h"
+#include "TILThreads.h"
 
 namespace til
 {
@@ -80,6 +84,9 @@ namespace til
 
 	static MessageData g_Msg;
 
+	// messages can be posted by more threads at the same time
+	static Internal::Mutex g_MsgLock;
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 	void InitLineFeed()
@@ -182,6 +189,8 @@ namespace til
 
 		delete g_LineFeed;
 		g_LineFeed = NULL;
+
+		Internal::ShutDownThreads();
 	}
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -313,15 +322,10 @@ namespace til
 		sprintf(a_Target, "%i.%i.%i", TIL_VERSION_MAJOR, TIL_VERSION_MINOR, TIL_VERSION_BUGFIX);
 	}
 
-	Image* TIL_Load(FileStream* a_Stream, uint32 a_Options)
-	{
-		// i don't know the path at this point
-		// oh well, good luck, have fun
-		if (!a_Stream)
-		{
-			return NULL;
-		}
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
 
+	Image* Internal::CreateImage(FileStream* a_Stream)
+	{
 		const char* filepath = a_Stream->GetFilePath();
 
 		size_t end = strlen(filepath) - 4;
@@ -383,6 +387,25 @@ namespace til
 		{
 			TIL_PRINT_DEBUG("Filename: '%s' (end: '%s')", filepath, filepath + end);
 			TIL_ERROR_EXPLAIN("Can't parse file: unknown format.");
+		}
+
+		return result;
+	}
+
+#endif
+
+	Image* TIL_Load(FileStream* a_Stream, uint32 a_Options)
+	{
+		// i don't know the path at this point
+		// oh well, good luck, have fun
+		if (!a_Stream)
+		{
+			return NULL;
+		}
+
+		Image* result = Internal::CreateImage(a_Stream);
+		if (!result)
+		{
 			a_Stream->Close();
 			delete a_Stream;
 			return NULL;
@@ -397,7 +420,25 @@ namespace til
 			result = NULL;
 		}
 
-		if (result && !result->Parse(a_Options & (TIL_DEPTH_MASK)))
+		// images stored at a single size are scaled down while they are decoded,
+		// so the full size image is only kept in memory by loaders that can't 
+		// pass it on a row at a time
+
+		if (result && TIL_LOAD_GETSIZE(a_Options) > 0 && !result->HasSizes())
+		{
+			uint32 options = a_Options & (TIL_DEPTH_MASK | TIL_LOAD_MASK);
+
+			ImageRegion* scaled = new ImageRegion();
+			if (!scaled->Crop(result, options, 0, 0, 0, 0))
+			{
+				delete scaled;
+				scaled = NULL;
+			}
+
+			delete result;
+			result = scaled;
+		}
+		else if (result && !result->Parse(a_Options & (TIL_DEPTH_MASK | TIL_LOAD_MASK)))
 		{
 			TIL_ERROR_EXPLAIN("Could not parse file.");
 			delete result;
@@ -426,6 +467,220 @@ namespace til
 		return TIL_Load(load, a_Options);
 	}
 
+	bool TIL_Decode(FileStream* a_Stream, uint32 a_Options, RowFunc a_Func, void* a_User)
+	{
+		if (!a_Stream || !a_Func)
+		{
+			return false;
+		}
+
+		Image* image = Internal::CreateImage(a_Stream);
+		if (!image)
+		{
+			a_Stream->Close();
+			delete a_Stream;
+			return false;
+		}
+
+		image->Load(a_Stream);
+
+		bool result = false;
+		if (!image->SetBPP(a_Options & TIL_DEPTH_MASK))
+		{
+			TIL_ERROR_EXPLAIN("Invalid bit-depth option: %i.", a_Options & TIL_DEPTH_MASK);
+		}
+		else
+		{
+			result = image->Decode(a_Options & (TIL_DEPTH_MASK | TIL_LOAD_MASK), a_Func, a_User);
+		}
+
+		delete image;
+
+		a_Stream->Close();
+		if (!a_Stream->IsReusable())
+		{
+			delete a_Stream;
+		}
+
+		return result;
+	}
+
+	bool TIL_Decode(const char* a_FileName, uint32 a_Options, RowFunc a_Func, void* a_User)
+	{
+		FileStream* load = Internal::g_FileFunc(a_FileName, a_Options & TIL_FILE_MASK);
+		if (!load) 
+		{
+			TIL_ERROR_EXPLAIN("Could not find file '%s'.", a_FileName);
+			return false;
+		}
+
+		return TIL_Decode(load, a_Options, a_Func, a_User);
+	}
+
+	Image* TIL_LoadRegion(FileStream* a_Stream, uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height)
+	{
+		if (!a_Stream)
+		{
+			return NULL;
+		}
+
+		Image* image = Internal::CreateImage(a_Stream);
+		if (!image)
+		{
+			a_Stream->Close();
+			delete a_Stream;
+			return NULL;
+		}
+
+		image->Load(a_Stream);
+
+		uint32 options = a_Options & (TIL_DEPTH_MASK | TIL_LOAD_MASK);
+
+		ImageRegion* result = new ImageRegion();
+		if (!image->SetBPP(a_Options & TIL_DEPTH_MASK))
+		{
+			TIL_ERROR_EXPLAIN("Invalid bit-depth option: %i.", a_Options & TIL_DEPTH_MASK);
+			delete result;
+			result = NULL;
+		}
+		else if (!result->Crop(image, options, a_X, a_Y, a_Width, a_Height))
+		{
+			delete result;
+			result = NULL;
+		}
+
+		delete image;
+
+		a_Stream->Close();
+		if (!a_Stream->IsReusable())
+		{
+			delete a_Stream;
+		}
+
+		return result;
+	}
+
+	Image* TIL_LoadRegion(const char* a_FileName, uint32 a_Options, uint32 a_X, uint32 a_Y, uint32 a_Width, uint32 a_Height)
+	{
+		FileStream* load = Internal::g_FileFunc(a_FileName, a_Options & TIL_FILE_MASK);
+		if (!load) 
+		{
+			TIL_ERROR_EXPLAIN("Could not find file '%s'.", a_FileName);
+			return NULL;
+		}
+
+		return TIL_LoadRegion(load, a_Options, a_X, a_Y, a_Width, a_Height);
+	}
+
+	ImageAtlas* TIL_LoadAtlas(FileStream** a_Streams, uint32 a_Count, uint32 a_Options, uint32 a_Width, uint32 a_Padding)
+	{
+		if (!a_Streams)
+		{
+			return NULL;
+		}
+
+		ImageAtlas* result = new ImageAtlas();
+		if (!result->Build(a_Streams, a_Count, a_Options, a_Width, a_Padding))
+		{
+			delete result;
+			result = NULL;
+		}
+
+		for (uint32 i = 0; i < a_Count; i++)
+		{
+			if (!a_Streams[i]) { continue; }
+
+			a_Streams[i]->Close();
+			if (!a_Streams[i]->IsReusable())
+			{
+				delete a_Streams[i];
+			}
+		}
+
+		return result;
+	}
+
+	ImageAtlas* TIL_LoadAtlas(const char** a_FileNames, uint32 a_Count, uint32 a_Options, uint32 a_Width, uint32 a_Padding)
+	{
+		FileStream** streams = new FileStream*[a_Count];
+		for (uint32 i = 0; i < a_Count; i++)
+		{
+			streams[i] = Internal::g_FileFunc(a_FileNames[i], a_Options & TIL_FILE_MASK);
+			if (!streams[i]) 
+			{ 
+				TIL_ERROR_EXPLAIN("Could not find file '%s'.", a_FileNames[i]); 
+			}
+		}
+
+		ImageAtlas* result = TIL_LoadAtlas(streams, a_Count, a_Options, a_Width, a_Padding);
+
+		delete [] streams;
+
+		return result;
+	}
+
+	Image* TIL_Resize(Image* a_Image, uint32 a_Width, uint32 a_Height, uint32 a_Filter, uint32 a_Frame)
+	{
+		ImageResized* result = new ImageResized();
+		if (!result->Resize(a_Image, a_Frame, a_Width, a_Height, a_Filter))
+		{
+			delete result;
+			result = NULL;
+		}
+
+		return result;
+	}
+
+	Image* TIL_CreateMipMaps(Image* a_Image, uint32 a_Filter, uint32 a_Frame)
+	{
+		ImageResized* result = new ImageResized();
+		if (!result->CreateMipMaps(a_Image, a_Frame, a_Filter))
+		{
+			delete result;
+			result = NULL;
+		}
+
+		return result;
+	}
+
+	bool TIL_ResizePixels(
+		byte* a_Dst, uint32 a_DstWidth, uint32 a_DstHeight, uint32 a_DstPitch, 
+		byte* a_Src, uint32 a_SrcWidth, uint32 a_SrcHeight, uint32 a_SrcPitch, 
+		uint32 a_Depth, uint32 a_Filter
+	)
+	{
+		return ImageResized::Resample(
+			a_Dst, a_DstWidth, a_DstHeight, a_DstPitch, 
+			a_Src, a_SrcWidth, a_SrcHeight, a_SrcPitch, 
+			a_Depth, a_Filter
+		);
+	}
+
+	ImageCompressed* TIL_Compress(Image* a_Image, uint32 a_Format)
+	{
+		ImageCompressed* result = new ImageCompressed();
+		if (!result->Compress(a_Image, a_Format))
+		{
+			delete result;
+			result = NULL;
+		}
+
+		return result;
+	}
+
+	bool TIL_CompressPixels(
+		byte* a_Dst, 
+		byte* a_Src, uint32 a_Width, uint32 a_Height, uint32 a_Pitch, 
+		uint32 a_Depth, uint32 a_Format
+	)
+	{
+		return ImageCompressed::CompressPixels(
+			a_Dst, 
+			a_Src, a_Width, a_Height, a_Pitch, 
+			a_Depth, a_Format
+		);
+	}
+
 	bool TIL_Release(Image* a_Image)
 	{
 		if (!a_Image) { return false; }
@@ -463,6 +718,16 @@ namespace til
 		Internal::g_PixelFunc = a_Func;
 	}
 
+	void TIL_SetThreadCount(uint32 a_Count)
+	{
+		Internal::SetThreadCount(a_Count);
+	}
+
+	uint32 TIL_GetThreadCount()
+	{
+		return Internal::GetThreadCount();
+	}
+
 	void TIL_ClearDebug()
 	{
 		if (g_Debug) { delete g_Debug; }
@@ -482,21 +747,33 @@ namespace til
 			return NULL;
 		}
 
-		byte* CreatePixels(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY)
+		FileStream* OpenStream(const char* a_Path, uint32 a_Options)
+		{
+			return g_FileFunc(a_Path, a_Options);
+		}
+
+		bool GetPitch(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY)
 		{
 			g_PixelFunc(a_Width, a_Height, a_BPP, a_PitchX, a_PitchY);
 
 			if (a_PitchX < a_Width)
 			{
 				TIL_ERROR_EXPLAIN("Horizontal pitch is smaller than width.");
-				return NULL;
+				return false;
 			}
 			if (a_PitchY < a_Height)
 			{
 				TIL_ERROR_EXPLAIN("Vertical pitch is smaller than width.");
-				return NULL;
+				return false;
 			}
 
+			return true;
+		}
+
+		byte* CreatePixels(uint32 a_Width, uint32 a_Height, uint8 a_BPP, uint32& a_PitchX, uint32& a_PitchY)
+		{
+			if (!GetPitch(a_Width, a_Height, a_BPP, a_PitchX, a_PitchY)) { return NULL; }
+
 			uint32 total = a_PitchX * a_BPP * a_PitchY;	
 			byte* result = new byte[total];
 			memset(result, 0, total);
@@ -510,8 +787,28 @@ namespace til
 			a_PitchY = a_Height;
 		}
 
+		uint32 GetBPP(uint32 a_Depth)
+		{
+			switch (a_Depth)
+			{
+
+			case Image::BPP_16B_R5G6B5:
+			case Image::BPP_16B_B5G6R5:
+				return 2;
+
+			case Image::BPP_NATIVE:
+				return 0;
+
+			default:
+				return 4;
+
+			}
+		}
+
 		void AddDebug(char* a_Message, char* a_File, int a_Line, ...)
 		{
+			g_MsgLock.Lock();
+
 			va_list args;
 			va_start(args, a_Line);
 			if (!g_DebugTemp) { g_DebugTemp = new char[TIL_DEBUG_MAX_SIZE + 1]; }
@@ -522,10 +819,14 @@ namespace til
 			g_Msg.source_file = a_File;
 			g_Msg.source_line = a_Line;
 			g_DebugFunc(&g_Msg);
+
+			g_MsgLock.Unlock();
 		}
 
 		void AddError( char* a_Message, char* a_File, int a_Line, ... )
 		{
+			g_MsgLock.Lock();
+
 			va_list args;
 			va_start(args, a_Line);
 			if (!g_ErrorTemp) { g_ErrorTemp = new char[TIL_ERROR_MAX_SIZE]; }
@@ -536,6 +837,8 @@ namespace til
 			g_Msg.source_file = a_File;
 			g_Msg.source_line = a_Line;
 			g_ErrorFunc(&g_Msg);
+
+			g_MsgLock.Unlock();
 		}
 
 	}